@@ -0,0 +1,102 @@
+// learn() latency around background maintenance submits. submit() shares the
+// population with the worker copy-on-write; learn() writes every belief, so the
+// step after a submit clones whatever the worker has not released yet. Reports
+// percentiles for ordinary steps, submit steps and the first step after a submit.
+//
+//   cmake -S . -B build -DDBEA_BUILD_BENCHMARKS=ON && cmake --build build
+//   ./build/bench_background_submit [beliefs] [steps]
+#include "dbea/Agent.h"
+#include "dbea/Config.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace dbea;
+
+namespace
+{
+    void report(const char *label, std::vector<double> &micros)
+    {
+        if (micros.empty())
+            return;
+        std::sort(micros.begin(), micros.end());
+        auto at = [&](double q)
+        { return micros[std::min(micros.size() - 1, static_cast<size_t>(q * micros.size()))]; };
+        std::cout << std::left << std::setw(20) << label << std::right << std::setw(8) << micros.size()
+                  << std::fixed << std::setprecision(0) << std::setw(10) << at(0.5) << std::setw(10) << at(0.99)
+                  << std::setw(10) << micros.back() << "\n";
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const int beliefs = argc > 1 ? std::stoi(argv[1]) : 20000;
+    const int steps = argc > 2 ? std::stoi(argv[2]) : 12000;
+
+    Config cfg;
+    cfg.verbose = false;
+    cfg.seed = 7;
+    cfg.maintenance_mode = "background";
+    cfg.max_beliefs = 0;
+    cfg.co_activation_thresh = 2.0; // pair tracking is quadratic in the co-active beliefs; off
+    // No evolution or decay, so every generation restructures a population of about the same size
+    cfg.evo_cycle_freq = 1 << 30;
+    cfg.crisis_reward_thresh = -1e9;
+    cfg.belief_decay_rate = 0.0;
+    Agent agent(cfg);
+
+    // Confident beliefs spread over 8 dimensions, sparse enough that few merge
+    const size_t width = 8;
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> uni(0.0, 1.0);
+    json checkpoint;
+    checkpoint["beliefs"] = json::array();
+    for (int i = 0; i < beliefs; ++i)
+    {
+        json b;
+        b["id"] = i == 0 ? std::string("proto-belief") : "belief_" + std::to_string(i);
+        std::vector<double> prototype(width);
+        for (auto &f : prototype)
+            f = uni(rng);
+        b["prototype"] = prototype;
+        b["confidence"] = 0.9;
+        b["evidence_count"] = 1;
+        b["action_values"] = {{"0", 0.1}, {"1", 0.1}, {"2", 0.1}, {"3", 0.1}};
+        checkpoint["beliefs"].push_back(b);
+    }
+    agent.from_json(checkpoint);
+    agent.set_observation_dimension(width);
+
+    std::vector<double> ordinary, submit, after_submit;
+    PatternSignature obs;
+    obs.features.resize(width);
+    bool submitted_last = false;
+    for (int step = 0; step < steps; ++step)
+    {
+        for (auto &f : obs.features)
+            f = static_cast<Real>(uni(rng));
+        agent.perceive(obs);
+        agent.decide();
+        agent.receive_reward(uni(rng), 0.05);
+        const uint64_t before = agent.background_submissions();
+        auto start = std::chrono::steady_clock::now();
+        agent.learn();
+        double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        const bool submitted = agent.background_submissions() != before;
+        (submitted ? submit : submitted_last ? after_submit : ordinary).push_back(micros);
+        submitted_last = submitted;
+    }
+
+    std::cout << "learn() around background submits, " << agent.get_belief_count() << " beliefs at the end\n";
+    std::cout << std::left << std::setw(20) << "step" << std::right << std::setw(8) << "count" << std::setw(10)
+              << "p50 us" << std::setw(10) << "p99 us" << std::setw(10) << "max us" << "\n";
+    report("ordinary", ordinary);
+    report("submit", submit);
+    report("after submit", after_submit);
+    return 0;
+}
@@ -0,0 +1,93 @@
+// Heap allocations per GridWorld step, split by stage. Counts every global
+// operator new after a warm-up, when scratch buffers have reached their size.
+// The observation pipeline (observe_into, perceive, decide) must not allocate;
+// learn() allocates only when the population changes (births, evolution).
+//
+//   cmake -S . -B build -DDBEA_BUILD_BENCHMARKS=ON && cmake --build build
+//   ./build/bench_step_allocations [episodes] [warmup episodes]
+#include "dbea/Agent.h"
+#include "dbea/Config.h"
+#include "gridworld/GridWorld.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+namespace
+{
+    std::atomic<uint64_t> allocations{0};
+}
+
+void *operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+void *operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+
+using namespace dbea;
+
+int main(int argc, char **argv)
+{
+    const int episodes = argc > 1 ? std::stoi(argv[1]) : 200;
+    const int warmup = argc > 2 ? std::stoi(argv[2]) : episodes / 2;
+    const int max_steps = 150;
+
+    Config cfg;
+    cfg.verbose = false;
+    cfg.seed = 7;
+    Agent agent(cfg);
+    GridWorld env;
+    agent.set_observation_dimension(env.dimension());
+    PatternSignature obs;
+
+    uint64_t observe = 0, perceive = 0, decide = 0, reward = 0, learn = 0, steps = 0;
+    for (int ep = 0; ep < episodes; ++ep)
+    {
+        env.reset();
+        const bool measured = ep >= warmup;
+        for (int step = 0; step < max_steps && !env.is_done(); ++step)
+        {
+            uint64_t a0 = allocations.load();
+            env.observe_into(obs);
+            uint64_t a1 = allocations.load();
+            agent.perceive(obs);
+            uint64_t a2 = allocations.load();
+            Action action = agent.decide();
+            uint64_t a3 = allocations.load();
+            agent.receive_reward(env.step(action), 0.05);
+            uint64_t a4 = allocations.load();
+            agent.learn();
+            uint64_t a5 = allocations.load();
+            if (!measured)
+                continue;
+            observe += a1 - a0;
+            perceive += a2 - a1;
+            decide += a3 - a2;
+            reward += a4 - a3;
+            learn += a5 - a4;
+            steps++;
+        }
+    }
+
+    auto per_step = [&](uint64_t n) { return steps ? static_cast<double>(n) / static_cast<double>(steps) : 0.0; };
+    std::cout << "Steps measured: " << steps << " | Beliefs: " << agent.get_belief_count() << "\n"
+              << "Allocations per step: observe " << per_step(observe) << " | perceive " << per_step(perceive)
+              << " | decide " << per_step(decide) << " | reward " << per_step(reward) << " | learn "
+              << per_step(learn) << "\n";
+    const uint64_t pipeline = observe + perceive + decide + reward;
+    if (pipeline > 0)
+    {
+        std::cout << "Observation pipeline allocated " << pipeline << " times\n";
+        return 1;
+    }
+    return 0;
+}
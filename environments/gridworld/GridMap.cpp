@@ -0,0 +1,254 @@
+// environments/gridworld/GridMap.cpp
+#include "GridMap.h"
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+namespace dbea
+{
+    namespace
+    {
+        constexpr uint32_t kGridMapMagic = 0x4D474244; // "DBGM"
+        constexpr uint32_t kGridMapVersion = 1;
+
+        struct GridMapHeader
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t width;
+            uint32_t height;
+            uint32_t start_x;
+            uint32_t start_y;
+            uint32_t goal_x;
+            uint32_t goal_y;
+            uint64_t words_per_layer;
+            uint64_t walls_offset;
+            uint64_t risky_offset;
+            uint64_t distance_offset;
+        };
+        static_assert(sizeof(GridMapHeader) == 64, "GridMap header layout changed");
+
+        struct Layout
+        {
+            uint64_t words = 0;
+            uint64_t walls = 0;
+            uint64_t risky = 0;
+            uint64_t distance = 0;
+            uint64_t total = 0;
+        };
+
+        Layout layout_for(uint64_t width, uint64_t height)
+        {
+            Layout l;
+            const uint64_t cells = width * height;
+            l.words = (cells + 63) / 64;
+            l.walls = sizeof(GridMapHeader);
+            l.risky = l.walls + l.words * sizeof(uint64_t);
+            l.distance = l.risky + l.words * sizeof(uint64_t);
+            l.total = (l.distance + cells * sizeof(uint32_t) + 7) & ~uint64_t(7);
+            return l;
+        }
+
+        // Writable view of a map image while it is being built
+        struct MapImage
+        {
+            uint32_t width;
+            uint32_t height;
+            uint64_t *walls;
+            uint64_t *risky;
+            uint32_t *dist;
+
+            size_t index(uint32_t x, uint32_t y) const { return static_cast<size_t>(y) * width + x; }
+            static void set(uint64_t *layer, size_t i, bool on)
+            {
+                if (on)
+                    layer[i >> 6] |= uint64_t(1) << (i & 63);
+                else
+                    layer[i >> 6] &= ~(uint64_t(1) << (i & 63));
+            }
+            bool is_wall(size_t i) const { return (walls[i >> 6] >> (i & 63)) & 1u; }
+        };
+
+        // `base` must be `layout.total` zeroed bytes
+        MapImage init_image(unsigned char *base, const Layout &layout, uint32_t width, uint32_t height,
+                            std::pair<uint32_t, uint32_t> start, std::pair<uint32_t, uint32_t> goal)
+        {
+            auto *header = reinterpret_cast<GridMapHeader *>(base);
+            header->magic = kGridMapMagic;
+            header->version = kGridMapVersion;
+            header->width = width;
+            header->height = height;
+            header->start_x = start.first;
+            header->start_y = start.second;
+            header->goal_x = goal.first;
+            header->goal_y = goal.second;
+            header->words_per_layer = layout.words;
+            header->walls_offset = layout.walls;
+            header->risky_offset = layout.risky;
+            header->distance_offset = layout.distance;
+            return MapImage{width, height, reinterpret_cast<uint64_t *>(base + layout.walls),
+                            reinterpret_cast<uint64_t *>(base + layout.risky),
+                            reinterpret_cast<uint32_t *>(base + layout.distance)};
+        }
+
+        // Breadth-first search out from the goal. Only two frontiers are held in
+        // memory; the distance table itself marks visited cells.
+        void compute_distances(MapImage &img, std::pair<uint32_t, uint32_t> goal)
+        {
+            const size_t cells = static_cast<size_t>(img.width) * img.height;
+            std::fill(img.dist, img.dist + cells, GridMap::kUnreachable);
+            std::vector<uint32_t> frontier{static_cast<uint32_t>(img.index(goal.first, goal.second))};
+            std::vector<uint32_t> next;
+            img.dist[frontier[0]] = 0;
+            for (uint32_t d = 1; !frontier.empty(); ++d)
+            {
+                next.clear();
+                for (uint32_t cell : frontier)
+                {
+                    const uint32_t x = cell % img.width;
+                    const uint32_t y = cell / img.width;
+                    auto visit = [&](uint32_t n)
+                    {
+                        if (img.dist[n] == GridMap::kUnreachable && !img.is_wall(n))
+                        {
+                            img.dist[n] = d;
+                            next.push_back(n);
+                        }
+                    };
+                    if (x > 0)
+                        visit(cell - 1);
+                    if (x + 1 < img.width)
+                        visit(cell + 1);
+                    if (y > 0)
+                        visit(cell - img.width);
+                    if (y + 1 < img.height)
+                        visit(cell + img.width);
+                }
+                frontier.swap(next);
+            }
+        }
+
+        // Probability `p` as a threshold on a uniform 64-bit draw
+        uint64_t cutoff(double p)
+        {
+            if (!(p > 0.0)) // NaN too
+                return 0;
+            // p just below 1 can still round up to 2^64, which does not fit the cast
+            const double scaled = p * 18446744073709551616.0;
+            if (scaled >= 18446744073709551616.0)
+                return std::numeric_limits<uint64_t>::max();
+            return static_cast<uint64_t>(scaled);
+        }
+    } // namespace
+
+    void GridMap::attach(const unsigned char *base, size_t size, const std::string &source)
+    {
+        if (size < sizeof(GridMapHeader))
+            throw std::runtime_error(source + " is too small to be a GridWorld map");
+        const auto *header = reinterpret_cast<const GridMapHeader *>(base);
+        if (header->magic != kGridMapMagic)
+            throw std::runtime_error(source + " is not a GridWorld map");
+        if (header->version != kGridMapVersion)
+            throw std::runtime_error("Unsupported GridWorld map version " + std::to_string(header->version) + " in " + source);
+        if (header->width == 0 || header->height == 0)
+            throw std::runtime_error("Empty GridWorld map in " + source);
+        const Layout expected = layout_for(header->width, header->height);
+        if (header->words_per_layer != expected.words || header->walls_offset != expected.walls ||
+            header->risky_offset != expected.risky || header->distance_offset != expected.distance || size < expected.total)
+            throw std::runtime_error("Corrupt or truncated GridWorld map " + source);
+        if (header->start_x >= header->width || header->start_y >= header->height ||
+            header->goal_x >= header->width || header->goal_y >= header->height)
+            throw std::runtime_error("Start or goal outside the GridWorld map " + source);
+
+        w = header->width;
+        h = header->height;
+        start_cell = {static_cast<int>(header->start_x), static_cast<int>(header->start_y)};
+        goal_cell = {static_cast<int>(header->goal_x), static_cast<int>(header->goal_y)};
+        walls = reinterpret_cast<const uint64_t *>(base + header->walls_offset);
+        risk = reinterpret_cast<const uint64_t *>(base + header->risky_offset);
+        dist = reinterpret_cast<const uint32_t *>(base + header->distance_offset);
+    }
+
+    std::shared_ptr<const GridMap> GridMap::open(const std::string &path)
+    {
+        std::shared_ptr<GridMap> map(new GridMap());
+        map->file.open_read(path);
+        map->attach(static_cast<const unsigned char *>(map->file.data()), map->file.size(), path);
+        return map;
+    }
+
+    std::shared_ptr<const GridMap> GridMap::builtin()
+    {
+        const Layout layout = layout_for(5, 5);
+        std::shared_ptr<GridMap> map(new GridMap());
+        map->owned.assign(layout.total / sizeof(uint64_t), 0);
+        auto *base = reinterpret_cast<unsigned char *>(map->owned.data());
+        MapImage img = init_image(base, layout, 5, 5, {0, 0}, {4, 4});
+        for (auto [x, y] : {std::pair<uint32_t, uint32_t>{1, 2}, {2, 2}, {3, 1}})
+            MapImage::set(img.walls, img.index(x, y), true);
+        for (auto [x, y] : {std::pair<uint32_t, uint32_t>{2, 3}, {3, 3}, {4, 2}})
+            MapImage::set(img.risky, img.index(x, y), true);
+        compute_distances(img, {4, 4});
+        map->attach(base, layout.total, "built-in map");
+        return map;
+    }
+
+    void generate_grid_map(const std::string &path, const GridMapSpec &spec)
+    {
+        if (spec.width < 2 || spec.height < 2)
+            throw std::runtime_error("GridWorld maps need at least 2 x 2 cells");
+        const uint64_t cells = static_cast<uint64_t>(spec.width) * static_cast<uint64_t>(spec.height);
+        if (cells >= GridMap::kUnreachable)
+            throw std::runtime_error("GridWorld map too large: " + std::to_string(cells) + " cells");
+
+        const uint32_t width = static_cast<uint32_t>(spec.width);
+        const uint32_t height = static_cast<uint32_t>(spec.height);
+        const std::pair<uint32_t, uint32_t> start{0, 0};
+        const std::pair<uint32_t, uint32_t> goal{width - 1, height - 1};
+        const Layout layout = layout_for(width, height);
+
+        MappedFile out;
+        out.create(path, layout.total);
+        MapImage img = init_image(static_cast<unsigned char *>(out.data()), layout, width, height, start, goal);
+
+        // Whole words at a time: each cell is a wall, else risky, else free
+        std::mt19937_64 rng(spec.seed);
+        const uint64_t wall_cut = cutoff(spec.wall_density);
+        const uint64_t risk_cut = cutoff(spec.risk_density);
+        for (uint64_t word = 0; word < layout.words; ++word)
+        {
+            uint64_t wall_bits = 0, risk_bits = 0;
+            const uint64_t first = word * 64;
+            const uint64_t count = std::min<uint64_t>(64, cells - first);
+            for (uint64_t b = 0; b < count; ++b)
+            {
+                if (rng() < wall_cut)
+                    wall_bits |= uint64_t(1) << b;
+                else if (rng() < risk_cut)
+                    risk_bits |= uint64_t(1) << b;
+            }
+            img.walls[word] = wall_bits;
+            img.risky[word] = risk_bits;
+        }
+
+        // Corridor: step right or down at random, in proportion to what is left of each
+        uint32_t x = start.first, y = start.second;
+        for (;;)
+        {
+            MapImage::set(img.walls, img.index(x, y), false);
+            if (x == goal.first && y == goal.second)
+                break;
+            const uint64_t right = goal.first - x, down = goal.second - y;
+            if (down == 0 || (right > 0 && rng() % (right + down) < right))
+                ++x;
+            else
+                ++y;
+        }
+        MapImage::set(img.risky, img.index(start.first, start.second), false);
+        MapImage::set(img.risky, img.index(goal.first, goal.second), false);
+
+        compute_distances(img, goal);
+        out.flush();
+    }
+} // namespace dbea
@@ -0,0 +1,80 @@
+// environments/gridworld/GridMap.h
+#pragma once
+#include "dbea/MappedFile.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace dbea
+{
+    // Immutable GridWorld layout: wall and risky-tile layers plus a goal-distance
+    // table. Maps are normally memory-mapped from a .dbgm file and shared by every
+    // GridWorld that uses them, so a 10^4 x 10^4 world costs no per-instance heap.
+    //
+    // File layout (native byte order):
+    //   header, 64 bytes: u32 magic "DBGM", u32 version, u32 width, u32 height,
+    //     u32 start x, u32 start y, u32 goal x, u32 goal y, u64 words per layer,
+    //     u64 walls offset, u64 risky offset, u64 distance offset (bytes from file start)
+    //   walls, risky: one bit per cell, cell (x, y) at bit y * width + x, in u64 words
+    //   distance: u32 per cell, BFS steps to the goal around walls (~0u = unreachable)
+    // The distance table is computed once, when the map is written, and is 4 bytes
+    // per cell (400 MB at 10^4 x 10^4); the two bit layers are 1/16 of that.
+    class GridMap
+    {
+    public:
+        static constexpr uint32_t kUnreachable = ~0u;
+
+        // Maps a .dbgm file read-only. Throws std::runtime_error on a bad file.
+        static std::shared_ptr<const GridMap> open(const std::string &path);
+        // The original 5x5 layout: start (0, 0), goal (4, 4), three walls, three risky tiles
+        static std::shared_ptr<const GridMap> builtin();
+
+        int width() const { return static_cast<int>(w); }
+        int height() const { return static_cast<int>(h); }
+        std::pair<int, int> start() const { return start_cell; }
+        std::pair<int, int> goal() const { return goal_cell; }
+
+        bool in_bounds(int x, int y) const { return x >= 0 && y >= 0 && x < width() && y < height(); }
+        bool wall(int x, int y) const { return test(walls, x, y); }
+        bool risky(int x, int y) const { return test(risk, x, y); }
+        uint32_t distance(int x, int y) const { return dist[index(x, y)]; }
+
+    private:
+        GridMap() = default;
+        void attach(const unsigned char *base, size_t size, const std::string &source);
+        size_t index(int x, int y) const { return static_cast<size_t>(y) * w + static_cast<size_t>(x); }
+        bool test(const uint64_t *layer, int x, int y) const
+        {
+            size_t i = index(x, y);
+            return (layer[i >> 6] >> (i & 63)) & 1u;
+        }
+
+        MappedFile file;             // backing for open()
+        std::vector<uint64_t> owned; // backing for builtin()
+        uint32_t w = 0;
+        uint32_t h = 0;
+        std::pair<int, int> start_cell{0, 0};
+        std::pair<int, int> goal_cell{0, 0};
+        const uint64_t *walls = nullptr;
+        const uint64_t *risk = nullptr;
+        const uint32_t *dist = nullptr;
+    };
+
+    // Procedural benchmark worlds: independent wall and risky cells at the given
+    // densities, start in the top-left corner, goal in the bottom-right, and a
+    // random monotone corridor carved between them so the goal is always reachable
+    struct GridMapSpec
+    {
+        int width = 64;
+        int height = 64;
+        double wall_density = 0.2;
+        double risk_density = 0.05;
+        uint64_t seed = 1;
+    };
+
+    // Writes `spec` to `path` through a writable mapping, BFS table included.
+    // Throws std::runtime_error on invalid sizes or I/O failure.
+    void generate_grid_map(const std::string &path, const GridMapSpec &spec);
+} // namespace dbea
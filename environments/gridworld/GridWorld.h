@@ -1,36 +1,49 @@
 // environments/gridworld/GridWorld.h
 #pragma once
-#include "dbea/Environment.h"
+#include "dbea/StaticEnvironment.h"
 #include "dbea/Action.h"
 #include "dbea/PatternSignature.h"
-#include <array>
+#include "GridMap.h"
+#include <algorithm>
+#include <memory>
 #include <utility>
 
 namespace dbea
 {
 
-    class GridWorld : public Environment
+    // Statically dispatched (see StaticEnvironment.h); use GridWorldEnvironment
+    // where a virtual Environment is needed
+    class GridWorld : public StaticEnvironment<GridWorld>
     {
     public:
-        GridWorld();
+        struct Move
+        {
+            int dx;
+            int dy;
+        };
+        // Action id -> move; the same ids as Agent's action set
+        static constexpr ActionEntry<Move> kActions[] = {
+            {"up", {0, -1}}, {"down", {0, 1}}, {"left", {-1, 0}}, {"right", {1, 0}}};
+        static constexpr size_t kActionCount = sizeof(kActions) / sizeof(kActions[0]);
+        static constexpr size_t kDimension = 2; // {norm_x, norm_y}
 
-        PatternSignature observe() override;
-        double step(const Action &action) override;
-        bool is_done() override;
+        GridWorld(); // the built-in 5x5 map
+        explicit GridWorld(std::shared_ptr<const GridMap> map);
+
+        using StaticEnvironment::step;
+        void observe_into(PatternSignature &out);
+        // Unknown ids stay in place (and are rewarded as a move onto the current tile)
+        double step(uint32_t action_id);
+        bool is_done() const { return position == map->goal(); }
 
         std::pair<int, int> get_position() const { return position; }
+        const GridMap &get_map() const { return *map; }
         void reset();
 
     private:
-        static constexpr int SIZE = 5;
+        // Shared, read-only layout (walls, risky tiles, goal distances)
+        std::shared_ptr<const GridMap> map;
         std::pair<int, int> position{0, 0};
-        std::pair<int, int> goal{4, 4};
-
-        // Obstacles (walls) - impassable
-        std::array<std::array<bool, SIZE>, SIZE> walls{};
-
-        // Risky tiles (negative reward)
-        std::array<std::array<bool, SIZE>, SIZE> risky{};
 
         // Reward map (for safe tiles)
         double get_tile_reward(int x, int y) const;
@@ -39,4 +52,55 @@ namespace dbea
         bool try_move(int dx, int dy);
     };
 
-} // namespace dbea
\ No newline at end of file
+    using GridWorldEnvironment = EnvironmentAdapter<GridWorld>;
+
+    // Hot path, inline so statically dispatched loops compile it in place
+
+    inline void GridWorld::observe_into(PatternSignature &out)
+    {
+        out.features.resize(2);
+        out.features[0] = static_cast<Real>(position.first) / std::max(1, map->width() - 1);
+        out.features[1] = static_cast<Real>(position.second) / std::max(1, map->height() - 1);
+    }
+
+    inline double GridWorld::get_tile_reward(int x, int y) const
+    {
+        if (std::make_pair(x, y) == map->goal())
+            return 1.0;
+        if (map->risky(x, y))
+            return -0.1;
+        return 0.12; // ← was 0.05 — stronger movement incentive
+    }
+
+    inline bool GridWorld::try_move(int dx, int dy)
+    {
+        int nx = position.first + dx;
+        int ny = position.second + dy;
+
+        if (!map->in_bounds(nx, ny))
+            return false;
+        if (map->wall(nx, ny))
+            return false;
+
+        position = {nx, ny};
+        return true;
+    }
+
+    inline double GridWorld::step(uint32_t action_id)
+    {
+        if (is_done())
+            return 0.0;
+        const Move move = action_id < kActionCount ? kActions[action_id].effect : Move{0, 0};
+
+        bool moved = try_move(move.dx, move.dy);
+        double reward = moved ? get_tile_reward(position.first, position.second) : -0.055; // single clean wall penalty
+        // Very soft shaping (max +0.036) on the precomputed BFS distance, fading out
+        // over three times the grid's Manhattan diameter (24 steps on the 5x5 map)
+        uint32_t dist = map->distance(position.first, position.second);
+        double span = 3.0 * (map->width() + map->height() - 2);
+        double shaping = (dist == GridMap::kUnreachable) ? 0.0 : 0.036 * std::max(0.0, 1.0 - dist / span);
+        reward += shaping;
+        return reward;
+    }
+
+} // namespace dbea
@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include "dbea/Agent.h"
+#include "dbea/Config.h"
+#include "dbea/Environment.h"
+
+namespace dbea
+{
+    // Pipelined acting and learning (Config::actor_threads > 0).
+    //
+    // Actor threads each step their own environment and decide with a SnapshotPolicy
+    // against the latest PolicySnapshot, pushing (observation, action, predicted value,
+    // reward) transitions into a bounded SPSC ring per actor. The calling thread is
+    // the learner: it drains the rings round-robin, up to learner_batch transitions
+    // each, feeds them to Agent::learn_transition (updates and maintenance as in the
+    // serial loop) and publishes a fresh snapshot every actor_snapshot_interval updates.
+    // A recorded trace (Config::record_trace) stores each transition's action with the
+    // actor's predicted value, so an open-loop replay rebuilds the same learner.
+    //
+    // Backpressure: when an actor's ring is full it waits ("block") or discards the
+    // transition ("drop"). Staleness: a transition acted on a snapshot more than
+    // actor_max_staleness updates old is discarded by the learner (0 = no bound).
+    class ActorLearner
+    {
+    public:
+        // Creates a fresh environment for one episode; called concurrently by actors
+        using EnvFactory = std::function<std::unique_ptr<Environment>()>;
+
+        struct Stats
+        {
+            int episodes = 0;
+            int goals = 0;                // episodes that ended with is_done()
+            uint64_t acted = 0;           // transitions produced by actors
+            uint64_t learned = 0;         // transitions applied by the learner
+            uint64_t dropped_full = 0;    // "drop" backpressure
+            uint64_t dropped_stale = 0;   // over actor_max_staleness
+            uint64_t snapshots = 0;
+            uint64_t max_staleness = 0;   // learner updates between snapshot and use
+            double mean_staleness = 0.0;
+            double seconds = 0.0;
+        };
+
+        // Throws std::runtime_error on an unknown actor_backpressure mode
+        ActorLearner(Agent &learner, const Config &cfg, EnvFactory make_env);
+
+        // Runs `episodes` episodes of at most `max_steps` steps, spread over the actors,
+        // and returns once every transition has been learned or discarded
+        Stats run(int episodes, int max_steps);
+
+    private:
+        Agent &agent;
+        const Config &config;
+        EnvFactory make_env;
+        bool block_when_full = true;
+    };
+} // namespace dbea
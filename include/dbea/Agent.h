@@ -1,52 +1,187 @@
 #pragma once
 #include "dbea/BeliefGraph.h"
 #include "dbea/EmotionState.h"
+#include "dbea/EmotionEngine.h"
 #include "dbea/Environment.h"
+#include "dbea/FixedPatternSignature.h"
 #include "dbea/Action.h"
 #include "dbea/PatternSignature.h"
 #include "dbea/Config.h"
+#include "dbea/NoveltyEstimator.h"
+#include "dbea/ReplayBuffer.h"
 #include <vector>
+#include <memory>
+#include <unordered_map>
 #include <utility>
 #include <nlohmann/json.hpp>
 #include <random>           // ← ADD THIS LINE
 using json = nlohmann::json;
 namespace dbea
 {
+    class IslandModel;
+    class BackgroundMaintenance;
+    class TraceWriter;
+    class TelemetryPublisher;
+    struct PolicySnapshot;
+
+    // What the last decide() based its choice on. Exact decisions score every active
+    // belief; anytime ones may stop early (Config::decision_mode).
+    struct Decision
+    {
+        Action action;
+        size_t visited = 0;     // active beliefs whose action values were scored
+        size_t population = 0;  // active beliefs there were
+        double coverage = 1.0;  // share of the activation mass visited
+        bool truncated = false; // stopped by the deadline or the candidate cap
+        double micros = 0.0;    // time spent scoring beliefs, anytime mode only
+    };
+
+    // Running totals over every decide(), for watching the latency tail
+    struct DecisionStats
+    {
+        uint64_t decisions = 0;
+        uint64_t truncated = 0;
+        double mean_coverage = 1.0;
+        double min_coverage = 1.0;
+        double max_micros = 0.0;
+    };
+
     class Agent
     {
     public:
         Agent(const Config &cfg);
+        ~Agent();
         void perceive(const PatternSignature &input);
         Action decide();
+        const Decision &last_decision() const { return decision; }
+        const DecisionStats &decision_stats() const { return decision_totals; }
         void receive_reward(double reward_valence, double reward_surprise);
         void learn();
+        // Batched off-policy update from the replay buffer; returns the number of samples used
+        size_t learn_from_replay(size_t batch_size);
         // Public methods (make prune public, not inline)
         void prune_beliefs(double threshold = 0.40);
+        // Finish all queued merge/prune/evolution work now (budgeted or background maintenance)
+        void run_full_maintenance();
         std::pair<double, double> get_proto_action_values() const;
         size_t get_belief_count() const;
         std::vector<std::pair<double, double>> get_all_belief_action_values() const;
         const EmotionState &get_emotion() const { return emotion; }
-        void set_emotion(const EmotionState &new_emotion) { emotion = new_emotion; }
+        void set_emotion(const EmotionState &new_emotion);
+        // Keep this agent's emotion in a population engine slot; the slot's current
+        // state is adopted and every later update goes through the engine
+        void bind_emotion(EmotionEngine &engine, size_t slot);
         // Serialization
         json to_json() const;
         void from_json(const json &j);
         void save(const std::string &filename) const;
         void load(const std::string &filename);
+        // New agent under `cfg` holding what save() + load() would carry over, but the
+        // beliefs are shared copy-on-write instead of copied: each agent clones a belief
+        // the first time it writes to it, so a fork costs memory only as it diverges.
+        // This agent's beliefs become shared too and are cloned on its next write.
+        std::unique_ptr<Agent> fork(const Config &cfg);
+        std::unique_ptr<Agent> fork() { return fork(config); }
+        // Turn the beliefs this agent owns (its overlay) into shared ones, so later forks
+        // reference them instead of cloning; returns how many were folded in
+        size_t compact_overlay();
+        size_t get_shared_belief_count() const { return belief_graph.shared_count(); }
+        // Hit/miss counts of the compete cache, nullptr unless Config::compete_cache_entries is set
+        const CompeteCache::Stats *compete_cache_stats() const
+        {
+            const CompeteCache *cache = belief_graph.compete_cache_state();
+            return cache ? &cache->stats : nullptr;
+        }
+        // Demotions, promotions and size of the cold tier, nullptr unless Config::cold_tier_window is set
+        const ColdBeliefStore *cold_tier_state() const { return belief_graph.cold_tier_state(); }
+        // Generations handed to the maintenance worker so far, 0 unless maintenance_mode is "background"
+        uint64_t background_submissions() const;
         void set_therapy_mode(bool enabled);
         void set_merge_threshold(double threshold);
         void force_action(const std::string &action_name);
+        void force_action(uint32_t action_id);
+        // Declared observation width (Environment::dimension()); selects the fixed-width
+        // kernels for perception, 0 falls back to dispatching on each input's width
+        void set_observation_dimension(size_t dimension);
+        // Actor/learner mode (see ActorLearner.h): copy of what decide() reads, and one
+        // transition an actor chose under such a copy, applied like perceive + reward + learn
+        void snapshot_policy(PolicySnapshot &out) const;
+        // Inference mode (see FrozenAgent.h): the settings and visit counts a frozen copy reads
+        const Config &get_config() const { return config; }
+        std::unique_ptr<NoveltyEstimator> copy_visit_counts() const { return novelty->clone(); }
+        void learn_transition(const PatternSignature &observation, uint32_t action_id, double predicted_value,
+                              double reward_valence, double reward_surprise);
+        // The action/value half of learn_transition: takes the place of decide() with a
+        // choice made elsewhere, keeping the chooser's predicted value for the update
+        void apply_action(uint32_t action_id, double predicted_value);
 
     private:
         Config config;
         BeliefGraph belief_graph;
-        EmotionState emotion;
+        EmotionState emotion;                  // local copy, refreshed from the engine slot when bound
+        EmotionEngine *emotion_engine = nullptr;
+        size_t emotion_slot = 0;
+        void pull_emotion();
+        void update_emotion(double reward_valence, double reward_surprise, double avg_error);
+        Action select_action();
+        // Belief mixture of action values into belief_scores (Decision.cpp)
+        void score_beliefs();
+        void score_beliefs_anytime();
+        void record_decision();
+        size_t replay_update(size_t batch_size);
+        double merge_threshold_now() const;
+        double prune_threshold_now() const;
         std::vector<Action> available_actions;
         double last_reward = 0.0;
         Action last_action;
         PatternSignature last_perception;
+        const PatternKernels *perception_kernels = &pattern_kernels(0); // for the declared observation width
+        // Per-step scratch, kept so the steady-state step does not allocate
+        PatternSignature blended_perception;
+        std::vector<double> action_scores;      // by position in available_actions
+        std::vector<double> belief_scores;      // the belief mixture part of action_scores
+        std::vector<std::vector<size_t>> decision_levels; // anytime visiting order, active rows by priority level
+        enum class DecisionOrder { Activation, Confidence, Index };
+        bool anytime_decisions = false;
+        DecisionOrder decision_order = DecisionOrder::Activation;
+        Decision decision;
+        DecisionStats decision_totals;
+        std::vector<BeliefNode *> co_active;    // beliefs over co_activation_thresh this step
+        std::string co_activation_key;
         double last_predicted_reward = 0.0;
         std::mt19937 rng;  // ← Add this random engine
-        std::unordered_map<std::string, int> state_visit_count;  // key = "x_y"
+        // Replay sampling only: decisions draw from `rng`, so an open-loop trace replay,
+        // which skips decide(), still samples the recorded batches
+        std::mt19937 replay_rng;
+        StateDiscretizer state_discretizer;
+        std::unique_ptr<NoveltyEstimator> novelty; // visit counts per discretized state
         double total_activation = 0.0;
+        double current_epsilon;       // decays every decide()
+        int step_count = 0;           // learn() steps since the last evolution cycle
+        double reward_buffer = 0.0;   // EMA of reward, triggers crisis evolution
+        int low_reward_streak = 0;
+        std::unique_ptr<IslandModel> island; // set when config.island_mode
+        std::unique_ptr<BackgroundMaintenance> background; // set when maintenance_mode == "background"
+        int steps_since_maintenance = 0;
+        bool evolution_due = false; // evolution trigger waiting for the background worker
+        std::unique_ptr<TraceWriter> recorder; // set when config.record_trace names a file
+        std::unique_ptr<TelemetryPublisher> telemetry; // set when config.telemetry_shm names a region
+        int steps_since_migration = 0;
+        int steps_since_demotion = 0;
+
+        // Experience replay: learn() leaves a pending transition that the next
+        // perceive() completes with its input as the next perception
+        std::unique_ptr<ReplayBuffer> replay;
+        ReplayBatch replay_batch;
+        PatternSignature replay_pending_perception;
+        int replay_pending_action = -1;
+        double replay_pending_reward = 0.0;
+        int steps_since_replay = 0;
+        std::vector<double> replay_q;            // beliefs x actions
+        std::vector<double> replay_weights;      // batch x beliefs, normalised activations of s
+        std::vector<double> replay_next_weights; // batch x beliefs, normalised activations of s'
+        std::vector<double> replay_delta;        // beliefs x actions
+        std::unordered_map<size_t, std::vector<std::pair<size_t, size_t>>> replay_width_slots; // width -> (slot, row)
+        std::vector<Real> replay_matches;        // match scores of one perception against its width's partition
     };
 } // namespace dbea
\ No newline at end of file
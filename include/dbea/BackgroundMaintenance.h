@@ -0,0 +1,122 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "dbea/BeliefGraph.h"
+#include "dbea/BeliefNode.h"
+#include "dbea/Config.h"
+#include "dbea/EmotionState.h"
+
+namespace dbea
+{
+    // Runs merge, threshold prune and evolve_cycle on a worker thread
+    // (Config::maintenance_mode = "background").
+    //
+    // The acting thread never shares its graph. submit() marks the population
+    // copy-on-write (BeliefGraph::share_all) and hands the worker the shared beliefs
+    // (generation N), which it clones off the acting thread; the acting thread only
+    // records every belief's learnable scalars as the baseline. Acting continues on
+    // the live graph meanwhile, cloning a belief it writes to while the worker still
+    // holds it. learn() writes every belief, so the step after a submit clones all
+    // that the worker has not cloned and released yet: the copy is split between the
+    // threads, not avoided (benchmarks/background_submit.cpp). Once the worker
+    // publishes the restructured generation N+1, try_install() replays what was
+    // learned since the copy onto it and swaps it in at a step boundary:
+    // - the change in action values, confidence, fitness and evidence of each belief
+    //   the worker kept;
+    // - beliefs created since the copy;
+    // - removal of beliefs the acting side pruned or evicted since the copy.
+    // Deltas of beliefs the worker merged away or culled are dropped with them.
+    class BackgroundMaintenance
+    {
+    public:
+        struct Request
+        {
+            double merge_threshold = 0.95;
+            double prune_threshold = 0.25;
+            bool evolve = false;
+            EmotionState emotion;
+        };
+
+        struct Stats
+        {
+            uint64_t submitted = 0;
+            uint64_t installed = 0;
+            uint64_t discarded = 0;
+            double last_worker_ms = 0.0;  // restructuring time off the acting thread
+            double last_submit_ms = 0.0;  // share + baseline on the acting thread
+            double last_install_ms = 0.0; // delta replay + swap on the acting thread
+        };
+
+        explicit BackgroundMaintenance(const Config &cfg);
+        ~BackgroundMaintenance();
+        BackgroundMaintenance(const BackgroundMaintenance &) = delete;
+        BackgroundMaintenance &operator=(const BackgroundMaintenance &) = delete;
+
+        // Shares `graph` with the worker; false while an earlier generation is still in flight
+        bool submit(BeliefGraph &graph, const Request &request);
+        // Non-blocking: installs the worker's generation into `graph` if it is ready
+        bool try_install(BeliefGraph &graph);
+        // Blocks until the in-flight generation (if any) is done, then installs it
+        void wait_and_install(BeliefGraph &graph);
+        // Drops the in-flight generation, e.g. after the live graph was reloaded
+        void discard();
+
+        bool busy() const { return in_flight; }
+        const Stats &stats() const { return counters; }
+
+    private:
+        enum class State { Idle, Submitted, Ready };
+
+        void run();
+        void install(BeliefGraph &graph);
+
+        Config worker_config; // inline maintenance, referenced by worker_graph
+        BeliefGraph worker_graph;
+
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable done;
+        State state = State::Idle;
+        bool stopping = false;
+        std::atomic<bool> ready{false};
+        bool in_flight = false; // acting thread only
+        bool stale = false;     // acting thread only
+
+        // Handed over under `mutex`
+        Request request;
+        std::vector<std::shared_ptr<BeliefNode>> job_nodes;
+        std::shared_ptr<const BeliefGraph::CoActivations> job_co_activations;
+        std::vector<std::shared_ptr<BeliefNode>> result;
+        std::vector<std::pair<std::string, std::string>> result_merges; // worker_graph.merge_log
+        std::vector<std::pair<std::string, bool>> result_lives;         // worker_graph.life_log
+        double worker_ms = 0.0;
+
+        // Learnable state of each belief at submit(); acting thread only. Ids and action
+        // values live in shared buffers that are reused from one submit to the next.
+        struct Baseline
+        {
+            size_t id_begin = 0;
+            size_t id_length = 0;
+            size_t values_begin = 0;
+            size_t values_count = 0;
+            Real confidence = 0.0;
+            Real fitness = 0.0;
+            int evidence_count = 0;
+        };
+        std::vector<Baseline> baseline;
+        std::string baseline_ids;
+        std::vector<std::pair<int, Real>> baseline_values;
+        void replay_learning(BeliefNode &target, const BeliefNode &live, const Baseline &base) const;
+        Stats counters;
+        std::thread worker; // started last, joined first
+    };
+} // namespace dbea
@@ -1,23 +1,52 @@
 #pragma once
+#include <atomic>
+#include <cstdint>
 #include <vector>
 #include <memory>
+#include <random>
 #include <unordered_map>
+#include <utility>
+#include "dbea/BeliefHeap.h"
 #include "dbea/BeliefNode.h"
 #include "dbea/PatternSignature.h"
+#include "dbea/ColdBeliefStore.h"
+#include "dbea/CompeteCache.h"
 #include "dbea/Config.h"
 #include "dbea/EmotionState.h"  // NEW: needed for evolve_cycle param
+#include "dbea/FixedPatternSignature.h"
+#include "dbea/MaintenanceScheduler.h"
+#include "dbea/QuantizedPrototypeStore.h"
+#include "dbea/ShardPool.h"
 
 namespace dbea {
 class BeliefGraph {
 public:
-    BeliefGraph(const Config& cfg) : config(cfg) {}
+    BeliefGraph(const Config& cfg);
     
     std::vector<std::shared_ptr<BeliefNode>> nodes;
     
-    // NEW: Made public so Agent can access it directly for symbiosis tracking
-    std::unordered_map<std::string, int> co_activations;  // "id1_id2" → count
+    // Symbiosis tracking, "id1_id2" → count. Forked graphs share one map until either writes.
+    using CoActivations = std::unordered_map<std::string, int>;
+    const CoActivations& co_activations() const { return *co_activation_counts; }
+    CoActivations& mutable_co_activations();
+    // The map itself, for a reader on another thread; the next write here copies it first
+    std::shared_ptr<const CoActivations> share_co_activations() const { return co_activation_counts; }
+
+    // (absorbed id, keeper id) per merge since the last drain; only kept while
+    // log_merges is set, i.e. when telemetry publishes merge events
+    bool log_merges = false;
+    std::vector<std::pair<std::string, std::string>> merge_log;
+    // (id, born) per belief added or removed by anything other than a merge or a
+    // cold-tier move since the last drain, kept under the same flag
+    std::vector<std::pair<std::string, bool>> life_log;
+    // (id, promoted) per cold-tier move since the last drain, kept under the same flag,
+    // so telemetry can tell demotions and promotions from deaths and births
+    std::vector<std::pair<std::string, bool>> tier_log;
 
     void add_belief(const std::shared_ptr<BeliefNode>& node);
+    void clear();
+    // Swap in a whole restructured population (background maintenance) and rebuild every index
+    void replace_nodes(std::vector<std::shared_ptr<BeliefNode>> next);
     std::shared_ptr<BeliefNode> compete(const PatternSignature& input);
     std::shared_ptr<BeliefNode> maybe_create_belief(const PatternSignature& input,
                                                     double activation_threshold);
@@ -27,7 +56,188 @@ public:
     // NEW: Now takes emotion reference for arousal-based scaling
     void evolve_cycle(const EmotionState& emotion);
 
+    // Budgeted maintenance (Config::maintenance_mode == "budgeted", see MaintenanceScheduler.h)
+    bool maintenance_budgeted() const { return maintenance != nullptr; }
+    // Queues an evolution cycle; maintain() runs it a slice at a time
+    void request_evolution(const EmotionState& emotion);
+    // One step of prune, merge and evolution work within the configured budget
+    void maintain(double merge_threshold, double prune_threshold);
+    // Drains everything queued: pending evolution, then full merge and prune passes
+    void run_full_maintenance(double merge_threshold, double prune_threshold);
+    const MaintenanceScheduler* maintenance_state() const { return maintenance.get(); }
+
+    // Memoized compete() results (Config::compete_cache_entries, see CompeteCache.h); nullptr when off
+    const CompeteCache* compete_cache_state() const { return compete_cache.get(); }
+
+    // Tiered storage (Config::cold_tier_window, see ColdBeliefStore.h); nullptr when off.
+    // Before scoring, compete() promotes the cold beliefs near its input (within one
+    // index cell) that the input activates above Config::cold_tier_activation.
+    const ColdBeliefStore* cold_tier_state() const { return cold.get(); }
+    // Moves beliefs idle for the window into the cold tier; returns how many moved
+    size_t demote_idle();
+    // Hot beliefs followed by decoded copies of the cold ones (checkpoints)
+    std::vector<std::shared_ptr<BeliefNode>> all_beliefs() const;
+
+    // Beliefs whose width matches the last compete() input; all others have zero activation
+    const std::vector<BeliefNode*>& active_beliefs() const;
+    // Activations from the last compete(), row-aligned with active_beliefs(). They are
+    // graph state rather than belief state, so scoring never writes to a belief.
+    const std::vector<Real>& active_activations() const;
+    Real activation_of(const BeliefNode& node) const;
+    // Sum of active_activations(), kept by compete() and erasures so readers need not rescan
+    double active_activation_total() const { return active_total; }
+    // Row of the last compete() winner in active_beliefs(), 0 when it is gone
+    size_t active_winner_row() const;
+    size_t partition_count() const { return partitions.size(); }
+
+    // Beliefs of one prototype width, for callers that score perceptions outside
+    // compete() (replay): (slot in `nodes`, row) pairs by ascending slot, and the
+    // match scores of `features` against every row of that width, scored with the
+    // partition's packed rows and kernels. Both are empty when no belief has the width.
+    void width_slots(size_t width, std::vector<std::pair<size_t, size_t>>& out);
+    void match_width(const Real* features, size_t width, std::vector<Real>& scores) const;
+
+    // Re-key a belief after its confidence/fitness changed (keeps eviction O(log n))
+    void touch(BeliefNode* node);
+
+    // Copy-on-write forking (Agent::fork). share_from() marks every belief of `source`
+    // shared and references them instead of copying; either graph clones a shared
+    // belief the first time it writes to it, so the other never sees the change.
+    // Beliefs stay shared until then, also in `source`.
+    void share_from(BeliefGraph& source);
+    // Mark every owned belief shared, so later forks reference it too
+    size_t share_all();
+    // Writable belief, cloned into this graph first if it is shared. Every index is
+    // re-pointed at the clone; raw pointers to the old belief are stale afterwards.
+    BeliefNode& own(BeliefNode* node);
+    // own() for every belief, before a pass that writes to all of them
+    void own_all();
+    size_t shared_count() const { return shared_nodes; }
+
+    // Highest-fitness beliefs (proto-belief excluded), best first
+    std::vector<std::shared_ptr<BeliefNode>> top_by_fitness(size_t count) const;
+    // "belief_<n>" from this graph's counter, so a run's ids depend only on its own
+    // history. Forks start from a copy of the counter; checkpoints carry it.
+    std::string new_belief_id();
+    uint64_t next_belief_id() const { return id_counter->load(std::memory_order_relaxed); }
+    void set_next_belief_id(uint64_t next) { id_counter->store(next, std::memory_order_relaxed); }
+    // Draw ids from `other`'s counter (background maintenance's worker graph, whose
+    // evolved children must not collide with beliefs the acting graph creates)
+    void share_id_counter(const BeliefGraph& other) { id_counter = other.id_counter; }
+
 private:
     const Config& config;
+
+    // Beliefs of one prototype width, with prototypes packed row-major
+    struct Partition {
+        size_t width = 0;
+        const PatternKernels* kernels = nullptr; // fixed-width kernels when `width` has them
+        std::vector<Real> prototypes;      // members.size() * width
+        std::vector<BeliefNode*> members;  // row -> belief
+        std::vector<Real> activations;     // row -> activation, zero unless this is the active partition
+        std::vector<uint64_t> hot_steps;   // row -> compete clock of its last non-negligible activation, tiering only
+    };
+    struct EvolutionStats {
+        size_t killed = 0;
+        size_t born = 0;
+    };
+
+    Partition* partition_for(size_t width);
+    void activate_partition(size_t width);
+    void sync_index();
+    void erase_node(const BeliefNode* node);
+    void rebuild_slots();
+    void merge_partition(Partition& part, double merge_threshold);
+    void evolve_partition(std::vector<std::shared_ptr<BeliefNode>>& pop, const EmotionState& emotion,
+                          std::mt19937& rng, EvolutionStats& stats);
+    bool is_parasite(const BeliefNode& b, const std::vector<std::shared_ptr<BeliefNode>>& pop,
+                     double avg_fitness) const;
+    void reproduce(std::vector<std::shared_ptr<BeliefNode>>& pop, const EmotionState& emotion,
+                   std::mt19937& rng, EvolutionStats& stats, double avg_fitness);
+
+    std::unordered_map<size_t, Partition> partitions;                // keyed by width
+    std::unordered_map<const BeliefNode*, size_t> partition_row;     // belief -> row in its partition
+    size_t active_width = 0;                                         // partition of the last compete()
+    double active_total = 0.0;                                       // activation mass of that partition
+    const BeliefNode* active_winner = nullptr;                       // its winner, while still live
+    size_t empty_prototypes = 0;                                     // width-0 beliefs, never partitioned
+
+    // Auxiliary indexes over `nodes`; every structural change goes through these hooks
+    void on_insert(const std::shared_ptr<BeliefNode>& node);
+    void on_erase(const BeliefNode* node);
+    void on_prototype_changed(BeliefNode* node);
+    void reindex();
+    void rebuild_secondary();
+    const std::shared_ptr<BeliefNode>& own_slot(size_t slot);
+    void repoint(const BeliefNode* old, const std::shared_ptr<BeliefNode>& now);
+    BeliefNode* stamp_winner(BeliefNode* best);
+
+    enum class Retention { Confidence, Fitness, Recency };
+    double retention_key(const BeliefNode& node) const;
+    bool capacity_enforced() const { return config.max_beliefs > 0; }
+    void make_room(size_t incoming);
+
+    Retention retention_kind = Retention::Confidence;
+    BeliefHeap retention;                                        // weakest belief on top, proto-belief never
+    std::unordered_map<const BeliefNode*, size_t> node_slot;     // belief -> index in nodes
+    uint64_t compete_clock = 0;
+    std::shared_ptr<std::atomic<uint64_t>> id_counter;           // next belief id
+    size_t shared_nodes = 0;                                     // beliefs in `nodes` with the shared flag
+    std::shared_ptr<CoActivations> co_activation_counts;
+    std::mt19937 evo_rng; // seeded from config.seed
+
+    bool screening_active() const;
+    BeliefNode* compete_exact(const PatternSignature& input, Partition& part);
+    BeliefNode* compete_screened(const PatternSignature& input, Partition& part);
+    bool sharding_active(const Partition& part) const;
+    BeliefNode* compete_sharded(const PatternSignature& input, Partition& part);
+    void merge_screened(double merge_threshold);
+
+    // Evolution cycle in progress under budgeted maintenance, one partition at a time
+    struct EvolutionJob {
+        bool pending = false;
+        EmotionState emotion;
+        std::vector<size_t> widths;                           // partitions still to evolve
+        std::vector<std::shared_ptr<BeliefNode>> pop;         // partition being assessed
+        std::vector<std::shared_ptr<BeliefNode>> survivors;   // assessed and not parasites
+        size_t cursor = 0;
+        double avg_fitness = 0.0;                             // of the current partition
+        double cycle_avg_fitness = 0.0;
+        size_t partitions = 0;
+        EvolutionStats stats;
+    };
+    void note_merge(const BeliefNode& keeper, const BeliefNode& absorbed);
+    void note_life(const BeliefNode& node, bool born);
+    void insert_belief(const std::shared_ptr<BeliefNode>& node);
+    bool merge_one(BeliefNode* node, double merge_threshold);
+    void prune_step(double threshold);
+    bool evolution_step();
+    void commit_evolved_partition();
+
+    std::unique_ptr<MaintenanceScheduler> maintenance;  // set when maintenance_mode == "budgeted"
+    BeliefHeap confidence_index;                        // lowest confidence on top, budgeted mode only
+    EvolutionJob evolution_job;
+
+    std::unique_ptr<QuantizedPrototypeStore> quantized; // set when config.quantized_screening
+    std::vector<QuantizedPrototypeStore::Candidate> candidates; // scratch shortlist
+    std::vector<Real> row_scores;                                // scratch match scores of one partition
+    std::vector<BeliefNode*> merge_partners;                     // scratch, merge candidates of one merge_one() call
+
+    std::unique_ptr<CompeteCache> compete_cache; // set when config.compete_cache_entries > 0
+
+    // Sharded compete (Config::compete_threads): one partial result per shard of rows
+    struct ShardResult {
+        double total = 0.0;
+        double best_score = -1.0;
+        size_t best_row = 0;
+        bool has_best = false;
+    };
+    std::unique_ptr<ShardPool> shard_pool;   // started by the first sharded compete()
+    std::vector<ShardResult> shard_results;  // scratch, one per shard
+
+    std::unique_ptr<ColdBeliefStore> cold;                // set when config.cold_tier_window > 0
+    std::vector<std::shared_ptr<BeliefNode>> thawed;      // scratch, beliefs promoted by one compete()
+    void promote_cold(const PatternSignature& input);
+    void note_hot(Partition& part);
 };
 } // namespace dbea
\ No newline at end of file
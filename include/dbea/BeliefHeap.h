@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "dbea/BeliefNode.h"
+
+namespace dbea
+{
+    // Indexed binary min-heap of beliefs. Each belief knows its heap slot, so a
+    // key change or removal is O(log n) and the weakest belief is always at top().
+    class BeliefHeap
+    {
+    public:
+        void clear();
+        // Heapify from scratch in O(n)
+        void assign(std::vector<std::pair<double, BeliefNode *>> entries);
+
+        void push(BeliefNode *node, double key);
+        // Re-key a belief already in the heap (inserts it otherwise)
+        void update(BeliefNode *node, double key);
+        void erase(const BeliefNode *node);
+        // Swap in `now` for `old` at the same slot and key (BeliefGraph::own's clones)
+        void replace(const BeliefNode *old, BeliefNode *now);
+        BeliefNode *pop();
+
+        BeliefNode *top() const { return heap.empty() ? nullptr : heap.front().second; }
+        double top_key() const { return heap.front().first; }
+        bool contains(const BeliefNode *node) const { return position.count(node) > 0; }
+        size_t size() const { return heap.size(); }
+        bool empty() const { return heap.empty(); }
+
+    private:
+        void sift_up(size_t i);
+        void sift_down(size_t i);
+        void place(size_t i, std::pair<double, BeliefNode *> entry);
+
+        std::vector<std::pair<double, BeliefNode *>> heap;
+        std::unordered_map<const BeliefNode *, size_t> position;
+    };
+} // namespace dbea
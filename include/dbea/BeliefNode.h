@@ -1,32 +1,39 @@
 #pragma once
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
 #include "dbea/PatternSignature.h"
+#include "dbea/Real.h"
 
 namespace dbea
 {
-    struct BeliefNode
+    struct BeliefNode : std::enable_shared_from_this<BeliefNode>
     {
         std::string id;
         PatternSignature prototype;
-        double confidence;
-        double activation;
+        Real confidence;
         int evidence_count = 1;
-        double last_predicted_reward = 0.0;
-        double prediction_error = 0.0;
-        std::unordered_map<int, double> action_values;
-        double fitness = 0.0;
-        double mutation_rate = 0.1;
-        double local_lr;
-        std::vector<double> emotional_affinity;
+        Real last_predicted_reward = 0.0;
+        Real prediction_error = 0.0;
+        std::unordered_map<int, Real> action_values;
+        Real fitness = 0.0;
+        Real mutation_rate = 0.1;
+        Real local_lr;
+        std::vector<Real> emotional_affinity;
+        uint64_t last_active_step = 0; // graph compete() count when this belief last won
+        // Part of a base shared by forked graphs (BeliefGraph::share_from): read-only,
+        // a graph clones it through BeliefGraph::own() before writing to it
+        bool shared = false;
 
         BeliefNode(const std::string &id_, const PatternSignature &proto);
 
-        double match_score(const PatternSignature &input) const;
+        Real match_score(const PatternSignature &input) const;
+        Real match_score(const Real *features, size_t count) const;
         void reinforce(double amount);
         void decay(double amount);
-        double predict_action_value(int action_id) const;
+        Real predict_action_value(int action_id) const;
         void learn_action_value(int action_id, double reward, double learning_rate, double gamma = 0.95);
     };
 } // namespace dbea
\ No newline at end of file
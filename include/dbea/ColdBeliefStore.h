@@ -0,0 +1,78 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "dbea/BeliefNode.h"
+#include "dbea/Real.h"
+
+namespace dbea
+{
+    // Cold tier of a BeliefGraph (Config::cold_tier_window). Beliefs whose activation
+    // stayed negligible for the window leave the graph and are packed here as one
+    // byte record each: id, prototype, action values and the scalar state, every real
+    // stored as a 32-bit float. No per-step loop visits them while they are cold.
+    //
+    // A coarse index maps each prototype's cell (width, plus the leading kIndexDims
+    // features floored to `resolution` bins per unit) to its records. take_matching()
+    // checks the input's cell and its neighbours one bin away in every indexed
+    // dimension, at most 27 lookups, and thaws the records there that the input
+    // activates above the threshold. Every cold belief within 1/resolution of the
+    // input in each indexed feature is checked; one farther away stays cold even if
+    // the input would activate it, so the resolution trades promotion reach against
+    // records checked per compete.
+    class ColdBeliefStore
+    {
+    public:
+        explicit ColdBeliefStore(double resolution);
+
+        void store(const BeliefNode &node);
+        // Removes and returns the beliefs in the cells around `features` whose match
+        // score times confidence reaches `threshold`, appended to `out`
+        size_t take_matching(const Real *features, size_t width, double threshold,
+                             std::vector<std::shared_ptr<BeliefNode>> &out);
+        // Decoded copies of every cold belief, oldest first; the store is unchanged
+        std::vector<std::shared_ptr<BeliefNode>> snapshot() const;
+        void clear();
+
+        size_t size() const { return live; }
+        bool empty() const { return live == 0; }
+        // Record bytes plus index overhead
+        size_t bytes() const;
+
+        struct Stats
+        {
+            uint64_t demoted = 0;
+            uint64_t promoted = 0;
+            uint64_t compactions = 0;
+        };
+        Stats stats;
+
+    private:
+        struct Record
+        {
+            uint64_t offset = 0; // into `arena`
+            uint32_t length = 0; // 0 once taken
+            uint32_t width = 0;
+            uint64_t cell = 0;
+        };
+
+        static constexpr size_t kIndexDims = 3;
+
+        // Floored codes of the indexed features, returns how many there are
+        size_t cell_codes(const Real *features, size_t width, int64_t *codes) const;
+        static uint64_t cell_key(size_t width, const int64_t *codes, size_t dims);
+        std::shared_ptr<BeliefNode> decode(const Record &record) const;
+        Real activation(const Record &record, const Real *features) const;
+        void remove(uint32_t index);
+        void compact();
+
+        double resolution;
+        std::vector<unsigned char> arena;
+        std::vector<Record> records;                                // taken ones until the next compact()
+        std::unordered_map<uint64_t, std::vector<uint32_t>> cells;  // cell -> record indices
+        size_t live = 0;
+        size_t dead_bytes = 0;
+    };
+} // namespace dbea
@@ -0,0 +1,74 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "dbea/BeliefNode.h"
+#include "dbea/Real.h"
+
+namespace dbea
+{
+    // Memoized compete() results for recurring observations (Config::compete_cache_entries).
+    // An observation is keyed by its width and its features rounded to `resolution`
+    // bins per unit; an entry holds the partition's row-aligned activations, their sum
+    // and the winner's row, stamped with the graph epoch they were computed in.
+    // BeliefGraph advances the epoch on every insert, erase, prototype change and
+    // reindex, and whenever a belief's confidence has drifted more than `tolerance`
+    // since the epoch last moved on its account, so a hit is never more than twice
+    // the tolerance (times the match score) away from a fresh compete.
+    class CompeteCache
+    {
+    public:
+        struct Entry
+        {
+            std::vector<int64_t> codes; // quantized features, to tell hash collisions apart
+            uint64_t epoch = 0;
+            std::vector<Real> activations;
+            double total = 0.0;
+            size_t winner_row = 0;
+        };
+
+        CompeteCache(size_t capacity, double resolution, double tolerance);
+
+        uint64_t epoch() const { return current_epoch; }
+        void invalidate();
+
+        // Entry for `features` computed in the current epoch, nullptr on a miss. The
+        // key is kept, so a miss can be followed by store() for the same observation.
+        const Entry *find(const Real *features, size_t width);
+        void store(const std::vector<Real> &activations, double total, size_t winner_row);
+
+        // Confidence bookkeeping for the drift tolerance
+        void track(const BeliefNode *node);
+        void forget(const BeliefNode *node);
+        void replace(const BeliefNode *old, const BeliefNode *now);
+        // Advances the epoch if `node` drifted past the tolerance
+        void note_confidence(const BeliefNode *node);
+        void rebuild(const std::vector<std::shared_ptr<BeliefNode>> &nodes);
+
+        size_t size() const { return entries.size(); }
+
+        struct Stats
+        {
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+            uint64_t stale = 0;         // misses on an entry from an older epoch
+            uint64_t invalidations = 0; // epoch advances
+            uint64_t evictions = 0;
+        };
+        Stats stats;
+
+    private:
+        void make_room();
+
+        size_t capacity;
+        double resolution;
+        double tolerance;
+        uint64_t current_epoch = 0;
+        std::unordered_map<uint64_t, Entry> entries;               // key hash -> entry
+        std::unordered_map<const BeliefNode *, Real> confidence_mark; // confidence when the epoch last moved for it
+        std::vector<int64_t> probe;                                 // codes of the last find()
+        uint64_t probe_key = 0;
+    };
+} // namespace dbea
@@ -0,0 +1,102 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "dbea/MappedFile.h"
+#include "dbea/PatternSignature.h"
+#include "dbea/Real.h"
+
+namespace dbea
+{
+    class Agent;
+
+    // One observation dimension of a dense policy table: `points` evenly spaced
+    // values from `lo` to `hi`, both included (GridWorld x: 0..1 over width points)
+    struct PolicyAxis
+    {
+        double lo = 0.0;
+        double hi = 1.0;
+        uint32_t points = 2;
+    };
+
+    // A trained agent's greedy policy compiled into a lookup table (.dbpt file),
+    // answered in O(1) without beliefs, kernels or exploration. Each entry holds the
+    // action FrozenAgent(agent, 0) picks for that state seen on its own, with the
+    // emotion and curiosity terms frozen at compile time, and the mixture value it
+    // was chosen on. Two layouts:
+    //   dense:  a lattice over PolicyAxis ranges; an observation snaps to the nearest
+    //           point per dimension (clamped), so lookup is a few multiply-adds
+    //   sparse: the given states only, keyed by features rounded to `resolution` bins
+    //           per unit in an open-addressing table; other observations miss
+    // Misses and observations of another width get the first action.
+    //
+    // File layout (native byte order):
+    //   header, 64 bytes: u32 magic "DBPT", u32 version, u32 layout (0 dense, 1 sparse),
+    //     u32 width, u32 actions, u32 reserved, u64 slots, u64 axes offset,
+    //     u64 keys offset (sparse only, else 0), u64 action offset, u64 value offset
+    //   actions: per action u32 id + 28-byte NUL-terminated name, right after the header
+    //   axes: per dimension f64 lo, f64 scale (codes per unit), u64 points (0 if sparse)
+    //   keys: slots x width i32 codes, INT32_MIN in the first code marks an empty slot
+    //   action: u8 per slot, index into actions (0xFF = empty); value: f32 per slot
+    class CompiledPolicy
+    {
+    public:
+        // The actions and axes records of the file layout above
+        struct ActionRecord
+        {
+            uint32_t id;
+            char name[28];
+        };
+        struct AxisRecord
+        {
+            double lo;
+            double scale;
+            uint64_t points;
+        };
+
+        // Maps a .dbpt file read-only. Throws std::runtime_error on a bad file.
+        static std::shared_ptr<const CompiledPolicy> open(const std::string &path);
+
+        // Evaluates `agent` on every lattice point and writes the dense table.
+        // Throws std::runtime_error on empty axes, more than 2^32 cells, or I/O failure.
+        static void compile_grid(const Agent &agent, const std::vector<PolicyAxis> &axes, const std::string &path);
+        // Evaluates `agent` on each state (all of one width) and writes the sparse table
+        static void compile_states(const Agent &agent, const std::vector<PatternSignature> &states,
+                                   double resolution, const std::string &path);
+
+        // Slot of `features`, -1 on a miss
+        int64_t slot(const Real *features, size_t width) const;
+        uint32_t action(const Real *features, size_t width) const
+        {
+            int64_t s = slot(features, width);
+            return actions[s < 0 ? 0 : slot_action[s]].id;
+        }
+        // Mixture value of the compiled choice, 0 on a miss
+        double value(const Real *features, size_t width) const
+        {
+            int64_t s = slot(features, width);
+            return s < 0 ? 0.0 : slot_value[s];
+        }
+        const char *action_name(uint32_t id) const;
+
+        bool dense() const { return keys == nullptr; }
+        size_t width() const { return axes.size(); }
+        size_t slots() const { return slot_count; }
+        size_t file_bytes() const { return file.size(); }
+
+    private:
+        CompiledPolicy() = default;
+        void attach(const unsigned char *base, size_t size, const std::string &source);
+
+        MappedFile file;
+        const ActionRecord *actions = nullptr;
+        size_t action_count = 0;
+        std::vector<AxisRecord> axes;  // copied out of the file so lookups need no offsets
+        std::vector<uint64_t> strides; // dense: cells per step along each dimension
+        const int32_t *keys = nullptr; // sparse only
+        const uint8_t *slot_action = nullptr;
+        const float *slot_value = nullptr;
+        size_t slot_count = 0;
+    };
+} // namespace dbea
@@ -1,7 +1,16 @@
 #pragma once
+#include <cstdint>
+#include <string>
+#include <nlohmann/json_fwd.hpp>
+
+// Every field is also listed in the name table in src/core/Config.cpp so that
+// scenario/sweep files can override it by name.
 struct Config
 {
-    int max_beliefs = 100;
+    bool verbose = true; // per-step console logging; sweep runs are quiet
+    uint64_t seed = 0;   // agent/evolution RNG seed, 0 = std::random_device
+    int max_beliefs = 100; // creation at capacity evicts the lowest retention score, 0 = unlimited
+    std::string retention_score = "confidence"; // "confidence", "fitness" or "recency"
     double exploration_rate = 0.92;
     double learning_rate = 0.1;
     double belief_learning_rate = 0.05;
@@ -34,4 +43,102 @@ struct Config
     // Parasite prevention — much less aggressive
     double parasite_tau = 15.0; // Very high threshold
     double parasite_phi = 0.08; // Lower floor
+
+    // Island model: several dbea_main processes migrate top-fitness beliefs
+    // through a shared-memory ring buffer (see IslandModel.h)
+    bool island_mode = false;
+    int island_id = 0;
+    int num_islands = 1;
+    std::string island_topology = "ring"; // "ring", "full" or "star"
+    std::string island_shm_name = "/dbea_islands";
+    bool island_reset = false;    // island 0 discards a segment left behind by a crashed run
+    int migration_interval = 100; // learn steps between migrations
+    double migration_rate = 0.1;  // fraction of the population sent per migration
+
+    // Prioritized experience replay (see ReplayBuffer.h); 0 capacity disables recording
+    int replay_capacity = 0;
+    int replay_max_features = 8;
+    double replay_alpha = 0.6;          // priority exponent
+    double replay_beta = 0.4;           // importance-sampling exponent
+    double replay_priority_eps = 1e-3;
+    double replay_learning_rate = 0.05;
+    int replay_every = 0;               // learn() steps between automatic replays, 0 = manual only
+    int replay_batch_size = 32;
+
+    // Int8 prototype screening for compete/merge (see QuantizedPrototypeStore.h)
+    bool quantized_screening = false;
+    int quantized_shortlist = 64;        // max candidates re-scored exactly per query
+    int quantized_min_population = 64;   // below this the exact scan is used
+
+    // Memoized compete() for recurring observations (see CompeteCache.h); 0 entries = off.
+    // Observations within one bin of each other share a result until the belief graph
+    // changes or some belief's confidence drifts more than the tolerance.
+    int compete_cache_entries = 0;
+    double compete_cache_resolution = 64.0; // bins per unit of each perceived feature
+    double compete_cache_tolerance = 0.02;  // confidence drift that invalidates every entry
+
+    // Sharded compete() for large populations (see ShardPool.h); 0 threads = off.
+    // A partition of at least compete_parallel_min beliefs is scored in fixed shards of
+    // compete_shard_rows, fanned out over a persistent pool and reduced in shard order,
+    // so every thread count (1 included) gives the same result.
+    int compete_threads = 0;           // scoring threads including the caller
+    int compete_parallel_min = 16384;  // smaller partitions use the serial scan
+    int compete_shard_rows = 4096;
+
+    // Tiered belief storage (see ColdBeliefStore.h); 0 window = off. Beliefs whose
+    // activation stays under cold_tier_activation for the window (in compete() calls)
+    // move to a packed cold tier outside every per-step loop, and come back when a
+    // perception within one index cell of them would activate them again. Not
+    // available with background maintenance.
+    int cold_tier_window = 0;
+    double cold_tier_activation = 0.01;  // activation that counts as negligible
+    int cold_tier_interval = 100;        // learn() steps between demotion sweeps
+    double cold_tier_resolution = 4.0;   // index cells per unit of each prototype feature (promotion reach 1/resolution)
+
+    // Count-based novelty for the curiosity bonus (see NoveltyEstimator.h)
+    std::string novelty_mode = "exact"; // "exact" hash table or fixed-memory "sketch"
+    int novelty_resolution = 5;         // bins per perception feature
+    int novelty_dims = 2;               // leading perception features that define a state
+    int novelty_sketch_width = 4096;    // counters per sketch row
+    int novelty_sketch_depth = 4;
+
+    // Structural maintenance: "inline" runs full merge and prune passes every learn()
+    // and whole evolution cycles; "budgeted" spreads the same work over steps so no
+    // single step stalls (see MaintenanceScheduler.h); "background" runs it on a worker
+    // thread against a copy of the population (see BackgroundMaintenance.h)
+    std::string maintenance_mode = "inline";
+    int maintenance_budget_ops = 512;   // ~prototype comparisons per learn() step
+    double maintenance_budget_us = 0.0; // wall-clock cap per step, 0 = ops budget only
+    int maintenance_interval = 50;      // learn() steps between background passes
+
+    // Binary record of every Agent call for environment-free replay (see InputTrace.h);
+    // empty = off. Recording fills in a seed when none is set.
+    std::string record_trace = "";
+
+    // Live belief-graph snapshots in a shared-memory ring for out-of-process viewers
+    // (see Telemetry.h, tools/visualize_belief_graph.py); empty name = off
+    std::string telemetry_shm = "";
+    int telemetry_interval = 10;      // learn() steps between snapshots
+    int telemetry_max_beliefs = 512;  // beliefs per snapshot, the rest are counted only
+
+    // Pipelined acting/learning for GridWorld runs (see ActorLearner.h); 0 actors = serial loop
+    int actor_threads = 0;
+    int actor_queue_capacity = 1024;          // transitions per actor ring
+    std::string actor_backpressure = "block"; // full ring: "block" the actor or "drop" the transition
+    int actor_snapshot_interval = 50;         // learner updates between policy snapshots
+    int actor_max_staleness = 0;              // updates a snapshot may lag before its transitions are dropped, 0 = no bound
+    int learner_batch = 64;                   // transitions drained per ring per learner turn
+
+    // decide(): "exact" scores every active belief; "anytime" visits them in
+    // `decision_order` and stops at the deadline or candidate cap, choosing from the
+    // scores gathered so far (see Agent::last_decision for the coverage reached)
+    std::string decision_mode = "exact";
+    std::string decision_order = "activation"; // "activation", "confidence", or "index" (rows outward from the winner's)
+    double decision_budget_us = 0.0;           // deadline per decide(), 0 = none
+    int decision_max_beliefs = 0;              // beliefs scored per decide(), 0 = no cap
 };
+
+// Overrides the fields named in `j`, e.g. {"gamma": 0.99, "max_beliefs": 200}.
+// Throws std::runtime_error on unknown names or mistyped values.
+void apply_config_json(Config &cfg, const nlohmann::json &j);
+nlohmann::json config_to_json(const Config &cfg);
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "dbea/Config.h"
+#include "dbea/EmotionState.h"
+#include "dbea/Real.h"
+
+namespace dbea
+{
+    // Emotion fields of `count` agents as parallel arrays
+    struct EmotionArrays
+    {
+        Real *valence;
+        Real *arousal;
+        Real *dominance;
+        Real *curiosity;
+        Real *fear;
+        Real *explore_bias;
+    };
+
+    // Branch-free (select-only) form of the emotion update, written so the loop
+    // vectorizes. EmotionState::update runs it on a single lane, so the scalar
+    // and population paths share one definition.
+    void update_emotions(const EmotionArrays &state, size_t count, const double *reward_valence,
+                         const double *reward_surprise, const double *avg_error, const Config &config);
+
+    // Emotion state for a population of agents in structure-of-arrays layout.
+    // An Agent bound to a slot (Agent::bind_emotion) reads and writes it here.
+    class EmotionEngine
+    {
+    public:
+        explicit EmotionEngine(size_t reserve = 0);
+
+        size_t add(const EmotionState &initial = EmotionState());
+        size_t size() const { return valence.size(); }
+
+        EmotionState get(size_t slot) const;
+        void set(size_t slot, const EmotionState &state);
+
+        // Single slot, same kernel as update_all
+        void update(size_t slot, double reward_valence, double reward_surprise, double avg_error,
+                    const Config &config);
+        // Every slot in one pass; each input array holds size() entries
+        void update_all(const double *reward_valence, const double *reward_surprise, const double *avg_error,
+                        const Config &config);
+
+        EmotionArrays arrays();
+
+    private:
+        std::vector<Real> valence;
+        std::vector<Real> arousal;
+        std::vector<Real> dominance;
+        std::vector<Real> curiosity;
+        std::vector<Real> fear;
+        std::vector<Real> explore_bias;
+    };
+} // namespace dbea
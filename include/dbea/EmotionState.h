@@ -1,13 +1,14 @@
 #pragma once
 #include "dbea/Config.h"  // ← Add this include
+#include "dbea/Real.h"
 
 struct EmotionState {
-    double valence = 0.0;
-    double arousal = 0.0;
-    double dominance = 0.5;
-    double curiosity = 0.5;
-    double fear = 0.0;
-    double explore_bias = 0.0;   // 0.0 neutral, +1.0 strong explore, -1.0 strong noop
+    dbea::Real valence = 0.0;
+    dbea::Real arousal = 0.0;
+    dbea::Real dominance = 0.5;
+    dbea::Real curiosity = 0.5;
+    dbea::Real fear = 0.0;
+    dbea::Real explore_bias = 0.0;   // 0.0 neutral, +1.0 strong explore, -1.0 strong noop
 
     EmotionState();
     void update(double reward_valence, double reward_surprise, double avg_error,
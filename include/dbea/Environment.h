@@ -1,6 +1,7 @@
 #pragma once
 #include "dbea/PatternSignature.h"
 #include "dbea/Action.h"
+#include <cstddef>
 #include <vector>
 
 namespace dbea {
@@ -9,8 +10,14 @@ class Environment {
 public:
     virtual ~Environment() = default;
     virtual PatternSignature observe() = 0;
+    // observe() into a caller-owned signature. Sources that override it write in
+    // place, so a buffer reused across steps stops allocating once it has grown.
+    virtual void observe_into(PatternSignature& out) { out = observe(); }
     virtual double step(const Action& action) = 0;
     virtual bool is_done() = 0;
+    // Width of every observe() result when fixed by the source, 0 if it varies.
+    // Agents use it to pick fixed-width pattern kernels up front.
+    virtual size_t dimension() const { return 0; }
 };
 
 }
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+namespace dbea
+{
+    class FrozenAgent;
+
+    // Parallel GridWorld evaluation of a FrozenAgent. Episodes are independent: each
+    // steps its own GridWorld with its own FrozenAgent::Episode and an RNG seeded
+    // from (seed, episode index), so results do not depend on the thread count or on
+    // scheduling, and nothing is written back to the agent the policy came from.
+    struct EvaluationSpec
+    {
+        int episodes = 200;
+        int max_steps = 80;
+        int threads = 0;  // 0 = all hardware threads
+        uint64_t seed = 1;
+        std::string map;  // .dbgm file (see GridMap.h), empty = built-in 5x5 map
+    };
+
+    struct EvaluationResult
+    {
+        int episodes = 0;
+        int successes = 0;
+        double success_rate = 0.0;
+        double mean_steps = 0.0;  // per episode, max_steps for the ones that fail
+        double mean_reward = 0.0; // per episode
+        // act() latency over every step, microseconds
+        double act_p50_us = 0.0;
+        double act_p90_us = 0.0;
+        double act_p99_us = 0.0;
+        double act_max_us = 0.0;
+        int threads = 0;
+        double seconds = 0.0;
+    };
+
+    // Throws std::runtime_error on an unreadable map or when an episode throws
+    EvaluationResult evaluate_gridworld(const FrozenAgent &policy, const EvaluationSpec &spec);
+} // namespace dbea
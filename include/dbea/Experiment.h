@@ -0,0 +1,108 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <nlohmann/json_fwd.hpp>
+#include "dbea/Config.h"
+#include "dbea/Evaluation.h"
+
+namespace dbea
+{
+    class Agent;
+
+    // Lifelong developmental simulation: lifetimes of short episodes with a trauma
+    // lifetime and a therapy lifetime, saving/reloading the agent in between
+    struct LifelongScenario
+    {
+        bool enabled = true;
+        int num_lifetimes = 7;
+        int base_episodes = 10;
+        int therapy_episodes = 30;
+        int steps_per_episode = 5;
+        int trauma_lifetime = 2;  // 0-based
+        int therapy_lifetime = 6; // 0-based
+        double exposure_prob = 0.3;
+        double therapy_trigger_prob = 0.2;
+        double mild_negative_prob = 0.15; // post-recovery stress parameters
+        double stress_trigger_prob = 0.35;
+        double negative_valence_range = -0.25;
+    };
+
+    // GridWorld navigation test run after the lifelong phase
+    struct GridWorldScenario
+    {
+        int episodes = 200;
+        int max_steps = 80;
+        std::string map; // .dbgm file (see GridMap.h), empty = built-in 5x5 map
+        // Frozen evaluation after the test (see Evaluation.h); 0 episodes = off
+        int eval_episodes = 0;
+        int eval_threads = 0;       // 0 = all hardware threads
+        double eval_epsilon = -1.0; // < 0: the agent's exploration rate at the end of the test
+    };
+
+    struct Scenario
+    {
+        std::string name = "default";
+        // Agent checkpoint (Agent::save) to start from instead of running the lifelong phase
+        std::string checkpoint;
+        LifelongScenario lifelong;
+        GridWorldScenario gridworld;
+    };
+
+    struct RunResult
+    {
+        std::string config_name;
+        uint64_t seed = 0;
+        int goals = 0;
+        int episodes = 0;
+        uint64_t steps = 0; // perceive/decide/learn cycles over both phases
+        double seconds = 0.0;
+        size_t beliefs = 0; // belief count at the end of the run
+        EvaluationResult evaluation; // when scenario.gridworld.eval_episodes > 0
+        std::string error;  // set when the run threw
+    };
+
+    // One complete run. Output files (agent_lifetime, emotion_trajectory_full,
+    // gridworld_trajectory) go to `output_dir`, with `file_suffix` before the extension.
+    // With `base` set the run forks it (Agent::fork) in place of loading the checkpoint.
+    RunResult run_scenario(const Config &cfg, const Scenario &scenario, const std::string &output_dir,
+                           const std::string &file_suffix = "", Agent *base = nullptr);
+
+    // A parameter grid over Config fields, each point run once per seed
+    struct SweepPoint
+    {
+        std::string name; // "field=value,field=value"
+        Config config;
+    };
+
+    struct SweepSpec
+    {
+        std::string name = "sweep";
+        std::string output_dir = "sweep_out"; // also when a sweep file names no output_dir
+        int threads = 0; // 0 = all hardware threads
+        std::vector<uint64_t> seeds{1};
+        Scenario scenario;
+        std::vector<SweepPoint> points;
+    };
+
+    // Sweep file layout:
+    // {
+    //   "name": "curiosity", "output_dir": "sweeps/curiosity", "threads": 0,
+    //   "seeds": [1, 2, 3],                      (or "repeats": 3)
+    //   "scenario": {"checkpoint": "agent_lifetime.json",   (optional, replaces lifelong)
+    //                "lifelong": {"num_lifetimes": 3, ...} | false,
+    //                "gridworld": {"episodes": 100, "max_steps": 80, "map": "maps/w1000.dbgm",
+    //                              "eval_episodes": 200, "eval_threads": 4, "eval_epsilon": 0.1}},
+    //   "config": {"max_beliefs": 100, ...},     overrides applied to every point
+    //   "grid": {"curiosity_boost": [0.3, 0.55], "gamma": [0.95, 0.985]}
+    // }
+    SweepSpec load_sweep(const std::string &path, const Config &base);
+    SweepSpec parse_sweep(const nlohmann::json &j, const Config &base);
+
+    // Runs every (point, seed) pair on a pool of worker threads; results are in
+    // point-major, seed-minor order regardless of completion order. A scenario
+    // checkpoint is loaded once and every run forks it.
+    std::vector<RunResult> run_sweep(const SweepSpec &spec);
+    // Per-point table (success rate, steps/s, beliefs) to `out` and summary.csv
+    void write_sweep_summary(const SweepSpec &spec, const std::vector<RunResult> &results, std::ostream &out);
+} // namespace dbea
@@ -0,0 +1,67 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include "dbea/Real.h"
+
+namespace dbea
+{
+    // Pattern kernels with the width as a template parameter: every loop is a fold
+    // over an index_sequence, so D = 2 compiles to two subtractions and no branch.
+    // The sums run in index order, matching the dynamic loops bit for bit.
+    namespace fixed
+    {
+        template <size_t... I>
+        constexpr Real squared_distance(const Real *a, const Real *b, std::index_sequence<I...>)
+        {
+            return (Real(0.0) + ... + ((a[I] - b[I]) * (a[I] - b[I])));
+        }
+
+        template <size_t D>
+        constexpr Real squared_distance(const Real *a, const Real *b)
+        {
+            return squared_distance(a, b, std::make_index_sequence<D>{});
+        }
+
+        // BeliefNode::match_score: 1 - |a - b| / sqrt(D), floored at 0
+        template <size_t D>
+        inline Real match_score(const Real *a, const Real *b)
+        {
+            Real normalized = Real(1.0) - std::sqrt(squared_distance<D>(a, b)) / std::sqrt(static_cast<Real>(D));
+            return std::max(Real(0.0), normalized);
+        }
+
+        // Agent::perceive smoothing: out = 0.95 * out + 0.05 * previous
+        template <size_t... I>
+        constexpr void blend(Real *out, const Real *previous, std::index_sequence<I...>)
+        {
+            ((out[I] = 0.95 * out[I] + 0.05 * previous[I]), ...);
+        }
+
+        template <size_t D>
+        constexpr void blend(Real *out, const Real *previous)
+        {
+            blend(out, previous, std::make_index_sequence<D>{});
+        }
+    } // namespace fixed
+
+    // Kernel set for one pattern width. Widths with a fixed specialization get the
+    // unrolled kernels; any other width gets the generic loops. `width` is passed to
+    // every kernel so callers need not care which one they hold.
+    struct PatternKernels
+    {
+        size_t width = 0; // 0 for the generic set
+        Real (*match)(const Real *a, const Real *b, size_t width) = nullptr;
+        // out[r] = match(input, rows + r * width) for `count` packed rows
+        void (*match_rows)(const Real *input, const Real *rows, size_t count, size_t width, Real *out) = nullptr;
+        void (*blend)(Real *out, const Real *previous, size_t width) = nullptr;
+
+        bool specialized() const { return width != 0; }
+    };
+
+    // Kernels for `width`: a fixed specialization for the widths observation sources
+    // actually use (1-4, 6, 8), otherwise the generic set
+    const PatternKernels &pattern_kernels(size_t width);
+} // namespace dbea
@@ -0,0 +1,54 @@
+#pragma once
+#include <memory>
+#include <random>
+#include <vector>
+#include "dbea/Action.h"
+#include "dbea/Config.h"
+#include "dbea/NoveltyEstimator.h"
+#include "dbea/PatternSignature.h"
+#include "dbea/PolicySnapshot.h"
+
+namespace dbea
+{
+    class Agent;
+
+    // Inference mode: a read-only copy of an agent's beliefs, action values, emotion
+    // and visit counts as of construction. act() is const and writes only to what the
+    // caller passes in, so one FrozenAgent can serve any number of threads. Nothing
+    // learns, logs, or restructures, beliefs are never created for unseen inputs, and
+    // the agent it was taken from is left untouched. Visit counts are read but not
+    // bumped, so each state's curiosity bonus stays at its frozen value.
+    class FrozenAgent
+    {
+    public:
+        // Caller-owned state of one episode: the previous perception, which perceive()
+        // blends into the next one, plus scratch so act() stops allocating once warm
+        struct Episode
+        {
+            std::vector<Real> last_perception;
+            std::vector<Real> blended;
+            std::vector<Real> matches;
+            std::vector<double> weights;
+            std::vector<double> scores;
+            double predicted_value = 0.0; // mixture value of the last greedy choice
+            void reset() { last_perception.clear(); }
+        };
+
+        // `epsilon` is the exploration rate of act(); < 0 keeps the agent's current one
+        explicit FrozenAgent(const Agent &agent, double epsilon = -1.0);
+
+        // Action for `observation` taken on its own, as the first step of an episode
+        const Action &act(const PatternSignature &observation, std::mt19937 &rng) const;
+        // Action for the next observation of `episode`
+        const Action &act(const PatternSignature &observation, std::mt19937 &rng, Episode &episode) const;
+
+        double epsilon() const { return snapshot->epsilon; }
+        const PolicySnapshot &policy() const { return *snapshot; }
+
+    private:
+        Config config;
+        std::shared_ptr<const PolicySnapshot> snapshot;
+        std::shared_ptr<const NoveltyEstimator> visits;
+        StateDiscretizer state_discretizer;
+    };
+} // namespace dbea
@@ -0,0 +1,124 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "dbea/Config.h"
+#include "dbea/EmotionState.h"
+#include "dbea/PatternSignature.h"
+
+namespace dbea
+{
+    // Binary record of every call made on an Agent's public interface, enough to
+    // rebuild the run without its environment (Config::record_trace).
+    //
+    // Layout (native byte order): "DBET" magic, u32 version, u32 length + the
+    // recorded Config as JSON (seed always filled in), then one record per call:
+    // a u8 TraceEvent tag followed by its payload. Features and rewards are stored
+    // as double so traces replay in either precision build.
+    enum class TraceEvent : uint8_t
+    {
+        Perceive = 'P',        // u16 width, width x f64
+        Decide = 'D',          // u32 chosen action id, f64 predicted value (version 2)
+        Reward = 'R',          // f64 valence, f64 surprise
+        Learn = 'L',
+        ForceAction = 'F',     // u16 length, name
+        SetEmotion = 'E',      // 6 x f64
+        TherapyMode = 'T',     // u8
+        MergeThreshold = 'H',  // f64
+        Prune = 'X',           // f64 threshold
+        ReplayLearn = 'Y',     // u32 batch size
+        FullMaintenance = 'Z',
+        Load = 'J',            // u32 length, CBOR checkpoint
+        ApplyAction = 'A',     // u32 action id, f64 predicted value
+    };
+
+    class TraceWriter
+    {
+    public:
+        // Throws std::runtime_error if `path` cannot be created
+        TraceWriter(const std::string &path, const Config &cfg);
+
+        void perceive(const PatternSignature &input);
+        void decide(uint32_t action_id, double predicted_value);
+        void reward(double valence, double surprise);
+        void learn();
+        void force_action(const std::string &name);
+        void set_emotion(const EmotionState &emotion);
+        void therapy_mode(bool enabled);
+        void merge_threshold(double threshold);
+        void prune(double threshold);
+        void replay_learn(size_t batch_size);
+        void full_maintenance();
+        void load(const nlohmann::json &checkpoint);
+        void apply_action(uint32_t action_id, double predicted_value);
+        void flush() { out.flush(); }
+
+    private:
+        template <typename T>
+        void put(const T &value) { out.write(reinterpret_cast<const char *>(&value), sizeof(T)); }
+        void tag(TraceEvent event) { put(static_cast<uint8_t>(event)); }
+
+        std::ofstream out;
+    };
+
+    struct TraceRecord
+    {
+        TraceEvent event = TraceEvent::Learn;
+        std::vector<Real> features; // Perceive
+        double a = 0.0;             // reward valence / threshold / predicted value
+        bool has_prediction = false; // Decide: the predicted value was recorded
+        double b = 0.0;             // reward surprise
+        uint32_t value = 0;         // action id / batch size / therapy flag
+        std::string name;           // ForceAction
+        EmotionState emotion;       // SetEmotion
+        nlohmann::json checkpoint;  // Load
+    };
+
+    class TraceReader
+    {
+    public:
+        // Throws std::runtime_error on a missing file or bad header
+        explicit TraceReader(const std::string &path);
+
+        const Config &config() const { return recorded; }
+        // False at end of trace; throws on a truncated or unknown record
+        bool next(TraceRecord &record);
+        uint64_t records_read() const { return count; }
+
+    private:
+        template <typename T>
+        T get();
+
+        std::ifstream in;
+        Config recorded;
+        uint32_t version = 0;
+        uint64_t count = 0;
+    };
+
+    enum class ReplayMode
+    {
+        Checked,  // agent decides; every decision is compared with the recorded one
+        OpenLoop, // recorded actions and predicted values are imposed, decide() is
+                  // skipped: offline training that rebuilds the recorded learner
+    };
+
+    struct ReplayResult
+    {
+        uint64_t records = 0;
+        uint64_t steps = 0;             // learn() calls
+        uint64_t decisions = 0;
+        uint64_t divergences = 0;       // checked mode: decisions that differ from the trace
+        int64_t first_divergence = -1;  // decision index, -1 if none
+        double seconds = 0.0;
+        size_t beliefs = 0;
+    };
+
+    // Rebuilds an Agent from the recorded Config and feeds it the trace as fast as possible.
+    // The replayed agent's checkpoint is written to `save_path` when it is non-empty.
+    ReplayResult replay_trace(const std::string &path, ReplayMode mode, const std::string &save_path = "");
+    // Replays the trace in both modes; true when checked replay does not diverge and
+    // both end with the same checkpoint. Version 1 traces lack the predicted values.
+    bool replay_modes_agree(const std::string &path);
+} // namespace dbea
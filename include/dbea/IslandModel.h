@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "dbea/BeliefGraph.h"
+#include "dbea/Config.h"
+#include "dbea/SharedMemory.h"
+
+namespace dbea
+{
+    // Island-model evolution across processes. Every island (one dbea_main process)
+    // owns a lock-free inbox in a shared-memory segment; migration copies the
+    // top-fitness beliefs into the inboxes of the island's topology neighbours and
+    // drains its own inbox into the local population.
+    //
+    // The last island to detach removes the segment. A run that crashes leaves it
+    // behind. One made for another island count or version is replaced by island 0 of
+    // the next run, and the other islands wait up to 10 s for it. One that matches is
+    // reused with whatever migrants are still queued; to start such a run clean, launch
+    // island 0 first with Config::island_reset (--island-reset), which removes it.
+    class IslandModel
+    {
+    public:
+        explicit IslandModel(const Config &cfg);
+        ~IslandModel();
+        IslandModel(const IslandModel &) = delete;
+        IslandModel &operator=(const IslandModel &) = delete;
+
+        // Send emigrants, then adopt any immigrants waiting in our inbox.
+        void migrate(BeliefGraph &graph);
+
+        size_t emigrate(const BeliefGraph &graph);
+        size_t immigrate(BeliefGraph &graph);
+
+        const std::vector<int> &neighbors() const { return neighbor_ids; }
+        uint64_t dropped_migrants() const;
+        // Emigrants never sent because their prototype, action values or affinities
+        // exceed the fixed migrant record
+        uint64_t oversized_migrants() const { return oversized; }
+        // Immigrants rejected because their counts exceed the record, i.e. the
+        // segment holds a corrupt, stale or foreign writer's data
+        uint64_t malformed_migrants() const { return malformed; }
+
+    private:
+        // False when an existing segment has another layout or was never initialised
+        bool attach_segment(size_t bytes);
+
+        const Config &config;
+        SharedMemoryRegion region;
+        std::vector<int> neighbor_ids;
+        uint64_t oversized = 0;
+        uint64_t malformed = 0;
+    };
+} // namespace dbea
@@ -0,0 +1,64 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <unordered_set>
+#include "dbea/BeliefNode.h"
+
+namespace dbea
+{
+    // Bookkeeping for budgeted belief maintenance (Config::maintenance_mode = "budgeted").
+    // Holds the per-step work budget and the queue of beliefs whose prototype changed
+    // since merging last looked at them; BeliefGraph::maintain() does the actual work
+    // and whatever does not fit in one step's budget is carried to the next.
+    class MaintenanceScheduler
+    {
+    public:
+        // One op is roughly one prototype comparison; `micros_per_step` <= 0 disables the time cap
+        MaintenanceScheduler(size_t ops_per_step, double micros_per_step);
+
+        void begin_step();
+        // Full passes ignore the budget
+        void begin_unbounded();
+        // Charges `ops`; false once the step's op or time budget is spent
+        bool spend(size_t ops);
+        bool exhausted() const { return spent >= limit; }
+        size_t ops_spent() const { return spent; }
+
+        void mark_dirty(BeliefNode *node);
+        void forget(const BeliefNode *node);
+        // Carry `old`'s dirty mark and queue position over to `now`
+        void replace(const BeliefNode *old, BeliefNode *now);
+        // Oldest dirty belief, nullptr when none are left
+        BeliefNode *next_dirty();
+        size_t dirty_count() const { return dirty.size(); }
+        void clear();
+
+        // Round-robin position for re-checking clean beliefs with spare budget
+        size_t next_sweep_slot(size_t population);
+
+        struct Stats
+        {
+            uint64_t steps = 0;
+            uint64_t merged = 0;
+            uint64_t pruned = 0;
+            uint64_t evolution_cycles = 0;
+            uint64_t carried_steps = 0; // steps that ended with work still queued
+            size_t max_ops_step = 0;
+        };
+        Stats stats;
+
+    private:
+        size_t ops_per_step;
+        std::chrono::nanoseconds time_per_step;
+        std::chrono::steady_clock::time_point deadline;
+        bool timed = false;
+        size_t spent = 0;
+        size_t limit = 0;
+
+        std::deque<BeliefNode *> queue;            // FIFO, may hold beliefs already forgotten
+        std::unordered_set<const BeliefNode *> dirty;
+        size_t sweep_slot = 0;
+    };
+} // namespace dbea
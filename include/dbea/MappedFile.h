@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace dbea
+{
+    // A whole file mapped into memory (POSIX mmap or a Win32 file mapping).
+    // Read-only mappings of one file are shared between every process that
+    // opens it, so large immutable data such as GridWorld maps never needs a
+    // per-instance heap copy.
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        // Maps an existing file read-only. Throws std::runtime_error on failure.
+        void open_read(const std::string &path);
+        // Creates or truncates `path` to `size` zero bytes and maps it read-write.
+        // Throws std::runtime_error on failure.
+        void create(const std::string &path, size_t size);
+        // Flushes a writable mapping to disk
+        void flush();
+        void close();
+
+        void *data() const { return addr; }
+        size_t size() const { return length; }
+        bool is_open() const { return addr != nullptr; }
+
+    private:
+        void *addr = nullptr;
+        size_t length = 0;
+#ifdef _WIN32
+        void *file = nullptr;
+        void *mapping = nullptr;
+#else
+        int fd = -1;
+#endif
+    };
+} // namespace dbea
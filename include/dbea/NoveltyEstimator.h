@@ -0,0 +1,88 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "dbea/Config.h"
+#include "dbea/Real.h"
+
+namespace dbea
+{
+    // Maps the leading perception features to an integer cell id: each feature is
+    // binned at `resolution` bins per unit and the bins are mixed into a 64-bit hash.
+    class StateDiscretizer
+    {
+    public:
+        StateDiscretizer(int resolution, size_t dims);
+
+        int64_t bin(Real x) const { return static_cast<int64_t>(std::floor(x * scale)); }
+        uint64_t cell(const Real *features, size_t count) const;
+        int resolution() const { return bins; }
+
+    private:
+        int bins;
+        size_t dims;
+        double scale; // resolution - 1e-3, so x = 1.0 still lands in the last bin
+    };
+
+    // Visit counts over discretized states, read by the curiosity bonus
+    class NoveltyEstimator
+    {
+    public:
+        virtual ~NoveltyEstimator() = default;
+        // Records one visit and returns the cell's (estimated) count including it
+        virtual uint32_t visit(uint64_t cell) = 0;
+        virtual uint32_t count(uint64_t cell) const = 0;
+        virtual void clear() = 0;
+        virtual size_t memory_bytes() const = 0;
+        // Independent copy of the counts (FrozenAgent keeps one to read from)
+        virtual std::unique_ptr<NoveltyEstimator> clone() const = 0;
+    };
+
+    // Exact counts in an open-addressing table (linear probing, grows at 70% load)
+    class ExactVisitCounter : public NoveltyEstimator
+    {
+    public:
+        explicit ExactVisitCounter(size_t initial_capacity = 64);
+
+        uint32_t visit(uint64_t cell) override;
+        uint32_t count(uint64_t cell) const override;
+        void clear() override;
+        size_t memory_bytes() const override;
+        std::unique_ptr<NoveltyEstimator> clone() const override;
+        size_t size() const { return used; }
+
+    private:
+        size_t slot_of(uint64_t key) const;
+        void grow();
+
+        std::vector<uint64_t> keys;
+        std::vector<uint32_t> counts;
+        size_t used = 0;
+    };
+
+    // Fixed-memory count-min sketch with conservative update; never undercounts,
+    // overcounts only on hash collisions in every row
+    class CountMinSketch : public NoveltyEstimator
+    {
+    public:
+        CountMinSketch(size_t width, size_t depth);
+
+        uint32_t visit(uint64_t cell) override;
+        uint32_t count(uint64_t cell) const override;
+        void clear() override;
+        size_t memory_bytes() const override { return table.size() * sizeof(uint32_t); }
+        std::unique_ptr<NoveltyEstimator> clone() const override;
+
+    private:
+        size_t index(uint64_t cell, size_t row) const;
+
+        size_t width_mask; // width is rounded up to a power of two
+        size_t depth;
+        std::vector<uint32_t> table; // depth * width
+    };
+
+    // Builds the estimator selected by config.novelty_mode ("exact" or "sketch")
+    std::unique_ptr<NoveltyEstimator> make_novelty_estimator(const Config &cfg);
+} // namespace dbea
@@ -1,9 +1,10 @@
 #pragma once
 #include <vector>
+#include "dbea/Real.h"
 
 struct PatternSignature {
-    std::vector<double> features;
+    std::vector<dbea::Real> features;
 
     PatternSignature() = default;
-    explicit PatternSignature(const std::vector<double>& feats);
+    explicit PatternSignature(const std::vector<dbea::Real>& feats);
 };
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+#include "dbea/Action.h"
+#include "dbea/Config.h"
+#include "dbea/EmotionState.h"
+#include "dbea/NoveltyEstimator.h"
+#include "dbea/PatternSignature.h"
+
+namespace dbea
+{
+    // Immutable copy of everything Agent::decide reads (Agent::snapshot_policy).
+    // Built by the owning thread and then shared read-only, e.g. with actor threads.
+    struct PolicySnapshot
+    {
+        // Beliefs of one prototype width, packed like BeliefGraph partitions
+        struct Partition
+        {
+            size_t width = 0;
+            std::vector<Real> prototypes; // rows x width
+            std::vector<Real> confidence; // rows
+            std::vector<Real> q;          // rows x actions, in `actions` order
+        };
+
+        uint64_t version = 0;    // bumped by the publisher on every new snapshot
+        uint64_t learn_step = 0; // learner updates applied when it was taken
+        std::vector<Action> actions;
+        std::vector<Partition> partitions;
+        EmotionState emotion;
+        double epsilon = 0.0;
+
+        const Partition *partition_for(size_t width) const;
+
+        // The scoring of Agent::select_action, in pieces shared by SnapshotPolicy and
+        // FrozenAgent. score() is the belief mixture for an already blended input:
+        // weights[r] is row r's share of the activation, scores[a] the value of action a.
+        // Returns the partition scored, nullptr when no belief has the input's width.
+        const Partition *score(const Real *input, size_t width, std::vector<Real> &matches,
+                               std::vector<double> &weights, std::vector<double> &scores) const;
+        // Curiosity bonus for `perception` (width >= 2), visited `visits` times
+        void add_curiosity(std::vector<double> &scores, const Config &config, const StateDiscretizer &states,
+                           const std::vector<Real> &perception, uint32_t visits) const;
+        // Explore bias and fear penalty of the captured emotion
+        void add_emotion_bias(std::vector<double> &scores, const Config &config) const;
+        // First action with the highest score, and the mixture value it was chosen on
+        static size_t best_action(const std::vector<double> &scores);
+        double predicted_value(const Partition *part, const std::vector<double> &weights, size_t action) const;
+    };
+
+    // Agent::perceive + Agent::decide against a PolicySnapshot, with the decision
+    // state an agent keeps between steps (blend of the previous perception, visit
+    // counts, RNG). Beliefs are never created, so unseen inputs fall back to the
+    // first action as with an empty partition. One instance per thread.
+    class SnapshotPolicy
+    {
+    public:
+        SnapshotPolicy(const Config &cfg, uint64_t seed);
+
+        // Chooses an action for `input` under `snapshot`
+        const Action &decide(const PolicySnapshot &snapshot, const PatternSignature &input);
+        // Activation-weighted value of the last greedy choice (Agent's last_predicted_reward)
+        double predicted_value() const { return last_predicted; }
+        // Start of an episode: forget the previous perception
+        void reset() { last_perception.clear(); }
+
+    private:
+        const Config &config;
+        StateDiscretizer state_discretizer;
+        std::unique_ptr<NoveltyEstimator> novelty;
+        std::mt19937 rng;
+        std::vector<Real> last_perception;
+        std::vector<Real> blended;
+        std::vector<Real> matches;   // per row of the active partition
+        std::vector<double> weights; // per row of the active partition
+        std::vector<double> scores;  // per action
+        double last_predicted = 0.0;
+    };
+} // namespace dbea
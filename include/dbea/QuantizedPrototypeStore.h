@@ -0,0 +1,73 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "dbea/BeliefNode.h"
+#include "dbea/PatternSignature.h"
+#include "dbea/Real.h"
+
+namespace dbea
+{
+    // Int8 copy of belief prototypes used to screen compete/merge candidates.
+    // Prototypes are grouped by width; each group has its own per-dimension
+    // scale/offset, so codes[d] = round((x[d] - offset[d]) / scale[d]) - 127.
+    // Screening ranks by sum(weight[d] * (code diff)^2) with integer weights
+    // proportional to scale[d]^2, and reports a lower bound on each candidate's
+    // exact distance so callers can stop re-scoring once nothing left can win.
+    class QuantizedPrototypeStore
+    {
+    public:
+        struct Candidate
+        {
+            Real distance_lower_bound;
+            BeliefNode *node;
+        };
+
+        void rebuild(const std::vector<std::shared_ptr<BeliefNode>> &nodes);
+        void clear();
+
+        // Insert or refresh the codes of a belief after its prototype changed
+        void upsert(BeliefNode *node);
+        void erase(const BeliefNode *node);
+        // Point `old`'s row at `now`; the prototypes are equal, so the codes stand
+        void replace(const BeliefNode *old, BeliefNode *now);
+
+        // Scores every belief of the same width as `features`; false if there are none.
+        bool begin_screen(const Real *features, size_t width);
+        // Replaces `out` with the next `count` candidates of the current screen, nearest
+        // first. Lower bounds are non-decreasing across successive calls.
+        size_t next_candidates(size_t count, std::vector<Candidate> &out);
+
+        size_t size() const { return location.size(); }
+        size_t code_bytes() const;
+
+    private:
+        struct Group
+        {
+            size_t width = 0;
+            std::vector<float> offset;        // per dimension
+            std::vector<float> scale;         // per dimension
+            std::vector<uint32_t> weight;     // 64 * (scale / finest scale)^2
+            float min_scale = 1.0f;
+            float code_error = 0.0f;          // max distance between a prototype and its decoded codes
+            std::vector<int8_t> codes;        // rows * width
+            std::vector<BeliefNode *> owners; // row -> belief
+        };
+
+        Group &group_for(size_t width);
+        void encode(const Group &g, const Real *features, int8_t *out) const;
+        bool in_range(const Group &g, const Real *features) const;
+        void recalibrate(Group &g);
+
+        std::unordered_map<size_t, Group> groups; // keyed by width
+        std::unordered_map<const BeliefNode *, size_t> location; // belief -> row in its group
+        // Current screen
+        const Group *screen_group = nullptr;
+        Real query_error = 0.0;
+        std::vector<int8_t> query_codes;
+        std::vector<std::pair<uint64_t, size_t>> scored;
+        size_t screen_cursor = 0;
+    };
+} // namespace dbea
@@ -0,0 +1,14 @@
+#pragma once
+
+namespace dbea
+{
+    // Numeric type of belief and emotion state. Build with -DDBEA_SINGLE_PRECISION=ON
+    // to run the core in float; Config hyperparameters stay double either way.
+#ifdef DBEA_SINGLE_PRECISION
+    using Real = float;
+    constexpr const char *kRealPrecision = "float";
+#else
+    using Real = double;
+    constexpr const char *kRealPrecision = "double";
+#endif
+} // namespace dbea
@@ -0,0 +1,74 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "dbea/PatternSignature.h"
+
+namespace dbea
+{
+    // Binary sum-tree over leaf priorities: O(log n) update and prefix-sum sampling.
+    class SumTree
+    {
+    public:
+        explicit SumTree(size_t capacity);
+
+        void update(size_t leaf, double priority);
+        // Leaf whose cumulative priority range contains `mass` (0 <= mass < total()).
+        size_t find(double mass) const;
+        double total() const { return tree[1]; }
+        double priority(size_t leaf) const { return tree[leaves + leaf]; }
+        size_t capacity() const { return leaf_capacity; }
+
+    private:
+        size_t leaf_capacity;
+        size_t leaves; // leaf_capacity rounded up to a power of two
+        std::vector<double> tree; // 1-based heap layout, leaves start at index `leaves`
+    };
+
+    struct ReplayBatch
+    {
+        std::vector<size_t> indices;
+        std::vector<double> weights; // importance-sampling weights, max-normalised to 1
+    };
+
+    // Fixed-capacity ring of (perception, action, reward, next perception) transitions
+    // stored in contiguous arrays, sampled proportionally to priority^alpha.
+    class ReplayBuffer
+    {
+    public:
+        ReplayBuffer(size_t capacity, size_t max_features, double alpha);
+
+        // Returns false when a perception is wider than max_features.
+        bool push(const PatternSignature &perception, int action, double reward,
+                  const PatternSignature &next_perception);
+        void sample(size_t batch_size, double beta, std::mt19937 &rng, ReplayBatch &out) const;
+        void update_priority(size_t index, double td_error, double epsilon);
+
+        size_t size() const { return count; }
+        size_t capacity() const { return slots; }
+
+        const Real *perception(size_t i) const { return &perceptions[i * stride]; }
+        const Real *next_perception(size_t i) const { return &next_perceptions[i * stride]; }
+        size_t perception_width(size_t i) const { return widths[i]; }
+        size_t next_perception_width(size_t i) const { return next_widths[i]; }
+        int action(size_t i) const { return actions[i]; }
+        double reward(size_t i) const { return rewards[i]; }
+
+    private:
+        size_t slots;
+        size_t stride;
+        double alpha;
+        size_t head = 0;
+        size_t count = 0;
+        double max_priority = 1.0;
+
+        std::vector<Real> perceptions;      // slots * stride
+        std::vector<Real> next_perceptions; // slots * stride
+        std::vector<uint32_t> widths;
+        std::vector<uint32_t> next_widths;
+        std::vector<int32_t> actions;
+        std::vector<double> rewards;
+        SumTree priorities;
+    };
+} // namespace dbea
@@ -0,0 +1,62 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dbea
+{
+    // Persistent fork-join pool for splitting one call into independent shards
+    // (sharded compete, Config::compete_threads). run() publishes a job, takes part
+    // in it on the calling thread and returns once every shard is done; the workers
+    // then park on a condition variable until the next job. Shards are handed out
+    // in index order from a shared counter, so which thread runs a shard varies, but
+    // a caller that writes per-shard results and reduces them in index order gets
+    // the same answer at any thread count.
+    //
+    // One caller at a time: a pool belongs to the object that owns it.
+    class ShardPool
+    {
+    public:
+        // `threads` counts the caller, so 1 starts no workers and runs every shard inline
+        explicit ShardPool(size_t threads);
+        ~ShardPool();
+        ShardPool(const ShardPool &) = delete;
+        ShardPool &operator=(const ShardPool &) = delete;
+
+        size_t threads() const { return workers.size() + 1; }
+
+        // Calls task(i) for every i in [0, count). `task` must not throw.
+        template <typename Task>
+        void run(size_t count, Task &task)
+        {
+            run_erased(count, &task, [](void *context, size_t shard) { (*static_cast<Task *>(context))(shard); });
+        }
+
+    private:
+        using Invoke = void (*)(void *, size_t);
+
+        void run_erased(size_t count, void *context, Invoke invoke);
+        void drain(void *context, Invoke invoke, size_t count);
+        void work();
+
+        std::mutex mutex;
+        std::condition_variable wake;
+        bool stopping = false;
+        uint64_t generation = 0; // bumped per job, under `mutex`
+
+        // Published under `mutex`, read by workers that joined the current generation
+        void *job_context = nullptr;
+        Invoke job_invoke = nullptr;
+        size_t job_count = 0;
+
+        std::atomic<size_t> next_shard{0};
+        std::atomic<size_t> finished{0};
+        std::atomic<size_t> active{0}; // workers inside a job; joining happens under `mutex`
+
+        std::vector<std::thread> workers; // started last, joined first
+    };
+} // namespace dbea
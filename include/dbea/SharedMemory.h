@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace dbea
+{
+    // Named shared-memory region backed by POSIX shm_open (or a Win32 file mapping).
+    // Used for cross-process exchange between dbea_main instances on one machine.
+    class SharedMemoryRegion
+    {
+    public:
+        SharedMemoryRegion() = default;
+        ~SharedMemoryRegion();
+        SharedMemoryRegion(const SharedMemoryRegion &) = delete;
+        SharedMemoryRegion &operator=(const SharedMemoryRegion &) = delete;
+
+        // Opens `name`, creating it zero-filled if it does not exist yet.
+        // Returns true when this call created the region. Throws std::runtime_error on failure.
+        bool open_or_create(const std::string &name, size_t size);
+        void close();
+        // Removes the name so later open_or_create calls start from a fresh region.
+        void unlink();
+        // Removes `name` whether or not a region is open on it; a missing name is not an error.
+        static void remove(const std::string &name);
+
+        void *data() const { return addr; }
+        size_t size() const { return length; }
+        bool is_open() const { return addr != nullptr; }
+
+    private:
+        std::string region_name;
+        void *addr = nullptr;
+        size_t length = 0;
+#ifdef _WIN32
+        void *handle = nullptr;
+#else
+        int fd = -1;
+#endif
+    };
+} // namespace dbea
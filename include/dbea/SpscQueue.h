@@ -0,0 +1,76 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace dbea
+{
+    // Bounded lock-free single-producer/single-consumer ring. Each side caches the
+    // other's index and only reloads it when the ring looks full (or empty), so the
+    // steady state touches no shared cache line besides the slot itself.
+    //
+    // Elements are swapped in and out rather than moved, so buffers owned by T
+    // circulate between producer and consumer instead of being freed and reallocated.
+    template <typename T>
+    class SpscQueue
+    {
+    public:
+        // Capacity is rounded up to a power of two
+        explicit SpscQueue(size_t capacity)
+        {
+            size_t n = 1;
+            while (n < capacity)
+                n <<= 1;
+            slots.resize(n);
+            mask = n - 1;
+        }
+        SpscQueue(const SpscQueue &) = delete;
+        SpscQueue &operator=(const SpscQueue &) = delete;
+
+        // Producer only. On success `value` receives the slot's previous contents (an
+        // element the consumer is done with); when full it is left untouched.
+        bool try_push(T &value)
+        {
+            const size_t t = tail.load(std::memory_order_relaxed);
+            if (t - head_cache > mask)
+            {
+                head_cache = head.load(std::memory_order_acquire);
+                if (t - head_cache > mask)
+                    return false;
+            }
+            using std::swap;
+            swap(slots[t & mask], value);
+            tail.store(t + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer only. `out`'s previous contents go back into the slot for reuse.
+        bool try_pop(T &out)
+        {
+            const size_t h = head.load(std::memory_order_relaxed);
+            if (h == tail_cache)
+            {
+                tail_cache = tail.load(std::memory_order_acquire);
+                if (h == tail_cache)
+                    return false;
+            }
+            using std::swap;
+            swap(out, slots[h & mask]);
+            head.store(h + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer only; exact once the producer has stopped
+        bool empty() const { return head.load(std::memory_order_relaxed) == tail.load(std::memory_order_acquire); }
+        size_t capacity() const { return mask + 1; }
+
+    private:
+        std::vector<T> slots;
+        size_t mask = 0;
+        alignas(64) std::atomic<size_t> head{0}; // next slot to pop, written by the consumer
+        size_t tail_cache = 0;                   // consumer's view of `tail`
+        alignas(64) std::atomic<size_t> tail{0}; // next slot to fill, written by the producer
+        size_t head_cache = 0;                   // producer's view of `head`
+    };
+} // namespace dbea
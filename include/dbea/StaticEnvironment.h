@@ -0,0 +1,66 @@
+#pragma once
+#include "dbea/Action.h"
+#include "dbea/Environment.h"
+#include "dbea/PatternSignature.h"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace dbea {
+
+// One row of an environment's action table: what action id `i` does, by index.
+// The name is for display only; stepping never looks at it.
+template <typename Effect>
+struct ActionEntry {
+    const char* name;
+    Effect effect;
+};
+
+// Compile-time environment interface (CRTP). Loops that know the environment
+// type call it directly, so observe/step/is_done inline into the loop instead of
+// going through the Environment vtable. `Derived` provides
+//   void observe_into(PatternSignature& out);
+//   double step(uint32_t action_id);   // ids index its action table
+//   bool is_done() const;
+//   static constexpr size_t kDimension; // observation width, 0 if it varies
+// plus `using StaticEnvironment::step;` to keep step(const Action&) visible,
+// and gets the rest of the Environment surface from here. EnvironmentAdapter
+// turns any such type back into a virtual Environment.
+template <typename Derived>
+class StaticEnvironment {
+public:
+    PatternSignature observe()
+    {
+        PatternSignature out;
+        self().observe_into(out);
+        return out;
+    }
+    double step(const Action& action) { return self().step(action.id); }
+    size_t dimension() const { return Derived::kDimension; }
+
+private:
+    Derived& self() { return static_cast<Derived&>(*this); }
+};
+
+// Virtual Environment over a static one, for code that picks its environment at
+// run time (e.g. ActorLearner's factories). Costs one indirect call per method.
+template <typename Env>
+class EnvironmentAdapter : public Environment {
+public:
+    template <typename... Args>
+    explicit EnvironmentAdapter(Args&&... args) : env(std::forward<Args>(args)...) {}
+
+    PatternSignature observe() override { return env.observe(); }
+    void observe_into(PatternSignature& out) override { env.observe_into(out); }
+    double step(const Action& action) override { return env.step(action.id); }
+    bool is_done() override { return env.is_done(); }
+    size_t dimension() const override { return Env::kDimension; }
+
+    Env& get() { return env; }
+    const Env& get() const { return env; }
+
+private:
+    Env env;
+};
+
+}
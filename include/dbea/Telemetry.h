@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "dbea/BeliefGraph.h"
+#include "dbea/Config.h"
+#include "dbea/EmotionState.h"
+#include "dbea/SharedMemory.h"
+
+namespace dbea
+{
+    // Publishes compact belief-graph snapshots into a shared-memory ring
+    // (Config::telemetry_shm) for viewers in other processes to decode, e.g.
+    // tools/visualize_belief_graph.py and tools/export_graphviz.py.
+    //
+    // The acting thread gathers a snapshot into a private staging buffer and copies
+    // it into the next ring slot under a per-slot seqlock: no locks, syscalls or
+    // encoding on the hot path. A reader that races the copy sees an odd or changed
+    // sequence number and retries. Layout (native byte order, fixed offsets):
+    //   header, 64 bytes: u32 magic "DBTL", u32 version, u32 slots, u32 slot_bytes,
+    //     u32 max_beliefs, u32 max_features, u32 max_events, u32 reserved,
+    //     u64 published (snapshots so far; the newest is in slot (published - 1) % slots)
+    //   slot header, 128 bytes: u64 sequence (odd while written), u64 snapshot, u64 step,
+    //     u32 beliefs, u32 total beliefs, u32 events, u32 dropped events,
+    //     6 x f64 emotion (valence, arousal, dominance, curiosity, fear, explore_bias)
+    //   then max_beliefs belief records, 184 bytes each: char[24] id, f64 confidence,
+    //     f64 fitness, f64 activation, i32 evidence, u32 features, max_features x f64 prototype
+    //   then max_events event records, 56 bytes each: u32 kind (1 birth, 2 death, 3 merge,
+    //     4 demoted to the cold tier, 5 promoted back), u32 reserved, char[24] id,
+    //     char[24] other (merge: the keeper that absorbed `id`)
+    // Events cover the interval since the previous snapshot. Ids are NUL-terminated and
+    // truncated to 23 characters.
+    class TelemetryPublisher
+    {
+    public:
+        // Creates the region, replacing a stale one left by an earlier run. Throws std::runtime_error.
+        explicit TelemetryPublisher(const Config &cfg);
+        ~TelemetryPublisher();
+        TelemetryPublisher(const TelemetryPublisher &) = delete;
+        TelemetryPublisher &operator=(const TelemetryPublisher &) = delete;
+
+        // Called once per learn() step; publishes every telemetry_interval steps
+        void tick(BeliefGraph &graph, const EmotionState &emotion);
+        // Writes one snapshot now and drains graph.life_log, merge_log and tier_log
+        void publish(BeliefGraph &graph, const EmotionState &emotion);
+
+        uint64_t published() const { return snapshots; }
+
+    private:
+        const Config &config;
+        SharedMemoryRegion region;
+        std::vector<uint64_t> staging; // one slot, 8-byte aligned, filled off the ring
+        uint64_t steps = 0;
+        uint64_t snapshots = 0;
+    };
+} // namespace dbea
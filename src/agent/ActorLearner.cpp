@@ -0,0 +1,176 @@
+#include "dbea/ActorLearner.h"
+#include "dbea/PolicySnapshot.h"
+#include "dbea/SpscQueue.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace dbea
+{
+    namespace
+    {
+        struct Transition
+        {
+            PatternSignature observation;
+            uint32_t action = 0;
+            double predicted = 0.0;  // actor's activation-weighted value of `action`
+            double reward = 0.0;
+            uint64_t policy_step = 0; // learn_step of the snapshot it was chosen under
+        };
+
+        // Reward surprise of the serial GridWorld loop
+        constexpr double kRewardSurprise = 0.05;
+    } // namespace
+
+    ActorLearner::ActorLearner(Agent &learner, const Config &cfg, EnvFactory factory)
+        : agent(learner), config(cfg), make_env(std::move(factory))
+    {
+        if (config.actor_backpressure == "drop")
+            block_when_full = false;
+        else if (config.actor_backpressure != "block")
+            throw std::runtime_error("Unknown actor backpressure mode: " + config.actor_backpressure);
+    }
+
+    ActorLearner::Stats ActorLearner::run(int episodes, int max_steps)
+    {
+        Stats stats;
+        auto start = std::chrono::steady_clock::now();
+        const int num_actors = std::max(1, config.actor_threads);
+        const size_t batch = static_cast<size_t>(std::max(1, config.learner_batch));
+        const uint64_t interval = static_cast<uint64_t>(std::max(1, config.actor_snapshot_interval));
+        const uint64_t max_staleness = static_cast<uint64_t>(std::max(0, config.actor_max_staleness));
+
+        std::vector<std::unique_ptr<SpscQueue<Transition>>> queues;
+        for (int k = 0; k < num_actors; ++k)
+            queues.push_back(std::make_unique<SpscQueue<Transition>>(static_cast<size_t>(std::max(2, config.actor_queue_capacity))));
+
+        // Snapshots are swapped whole; actors only reload when the version moves
+        std::shared_ptr<const PolicySnapshot> current;
+        std::atomic<uint64_t> version{0};
+        uint64_t learned = 0;
+        auto publish = [&]()
+        {
+            auto snap = std::make_shared<PolicySnapshot>();
+            agent.snapshot_policy(*snap);
+            snap->version = version.load(std::memory_order_relaxed) + 1;
+            snap->learn_step = learned;
+            std::atomic_store(&current, std::shared_ptr<const PolicySnapshot>(std::move(snap)));
+            version.fetch_add(1, std::memory_order_release);
+            stats.snapshots++;
+        };
+        publish();
+
+        std::atomic<int> next_episode{0};
+        std::atomic<int> goals{0};
+        std::atomic<int> finished{0};
+        std::atomic<uint64_t> acted{0};
+        std::atomic<uint64_t> dropped_full{0};
+        auto actor = [&](int k)
+        {
+            const uint64_t seed = config.seed ? config.seed * 0x9E3779B97F4A7C15ull + static_cast<uint64_t>(k) + 1
+                                              : std::random_device{}();
+            SnapshotPolicy policy(config, seed);
+            SpscQueue<Transition> &queue = *queues[k];
+            std::shared_ptr<const PolicySnapshot> snap;
+            uint64_t seen = 0;
+            Transition t; // the ring hands back a consumed transition on every push, buffers included
+            for (int ep = next_episode++; ep < episodes; ep = next_episode++)
+            {
+                std::unique_ptr<Environment> env = make_env();
+                policy.reset();
+                for (int step = 0; step < max_steps; ++step)
+                {
+                    if (version.load(std::memory_order_acquire) != seen)
+                    {
+                        snap = std::atomic_load(&current);
+                        seen = snap->version;
+                    }
+                    env->observe_into(t.observation);
+                    const Action &action = policy.decide(*snap, t.observation);
+                    t.action = action.id;
+                    t.predicted = policy.predicted_value();
+                    t.reward = env->step(action);
+                    t.policy_step = snap->learn_step;
+                    const bool done = env->is_done();
+                    acted.fetch_add(1, std::memory_order_relaxed);
+                    if (block_when_full)
+                    {
+                        while (!queue.try_push(t))
+                            std::this_thread::yield();
+                    }
+                    else if (!queue.try_push(t))
+                        dropped_full.fetch_add(1, std::memory_order_relaxed);
+                    if (done)
+                    {
+                        goals.fetch_add(1, std::memory_order_relaxed);
+                        break;
+                    }
+                }
+            }
+            finished.fetch_add(1, std::memory_order_release);
+        };
+
+        std::vector<std::thread> actors;
+        for (int k = 0; k < num_actors; ++k)
+            actors.emplace_back(actor, k);
+
+        // Learner: this thread owns the agent
+        Transition t;
+        uint64_t since_snapshot = 0;
+        double staleness_sum = 0.0;
+        for (;;)
+        {
+            bool got = false;
+            for (auto &queue : queues)
+            {
+                for (size_t b = 0; b < batch && queue->try_pop(t); ++b)
+                {
+                    got = true;
+                    const uint64_t staleness = learned - t.policy_step;
+                    if (max_staleness > 0 && staleness > max_staleness)
+                    {
+                        stats.dropped_stale++;
+                        continue;
+                    }
+                    stats.max_staleness = std::max(stats.max_staleness, staleness);
+                    staleness_sum += static_cast<double>(staleness);
+                    agent.learn_transition(t.observation, t.action, t.predicted, t.reward, kRewardSurprise);
+                    learned++;
+                    if (++since_snapshot >= interval)
+                    {
+                        publish();
+                        since_snapshot = 0;
+                    }
+                }
+            }
+            if (got)
+                continue;
+            // Actors push before they count themselves finished, so one more empty pass after that is final
+            if (finished.load(std::memory_order_acquire) == num_actors &&
+                std::all_of(queues.begin(), queues.end(), [](const auto &q) { return q->empty(); }))
+                break;
+            std::this_thread::yield();
+        }
+        for (auto &th : actors)
+            th.join();
+
+        stats.episodes = episodes;
+        stats.goals = goals.load();
+        stats.acted = acted.load();
+        stats.learned = learned;
+        stats.dropped_full = dropped_full.load();
+        stats.mean_staleness = learned ? staleness_sum / static_cast<double>(learned) : 0.0;
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (config.verbose)
+            std::cout << "[DBEA] Actor/learner: " << num_actors << " actors | " << stats.learned << " of " << stats.acted
+                      << " transitions learned (" << stats.dropped_full << " dropped full, " << stats.dropped_stale
+                      << " stale) | Snapshots: " << stats.snapshots << " | Staleness mean " << stats.mean_staleness
+                      << " max " << stats.max_staleness << " | " << stats.learned / std::max(1e-9, stats.seconds) << " steps/s\n";
+        return stats;
+    }
+} // namespace dbea
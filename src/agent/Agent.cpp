@@ -1,4 +1,8 @@
 #include "dbea/Agent.h"
+#include "dbea/BackgroundMaintenance.h"
+#include "dbea/InputTrace.h"
+#include "dbea/IslandModel.h"
+#include "dbea/Telemetry.h"
 #include <unordered_map>
 #include <iostream>
 #include <cmath>
@@ -8,8 +12,24 @@
 #include <algorithm> // NEW for std::sort etc. in evo
 namespace dbea
 {
+    // A recorded run must be replayable, so it never draws its seed from std::random_device
+    static Config with_trace_seed(Config cfg)
+    {
+        if (!cfg.record_trace.empty() && cfg.seed == 0)
+        {
+            std::random_device rd;
+            cfg.seed = (static_cast<uint64_t>(rd()) << 32) | rd();
+        }
+        return cfg;
+    }
+
     Agent::Agent(const Config &cfg)
-        : config(cfg), belief_graph(cfg), last_reward(0.0), rng(std::random_device{}())
+        : config(with_trace_seed(cfg)), belief_graph(config), last_reward(0.0),
+          rng(config.seed ? static_cast<std::mt19937::result_type>(config.seed) : std::random_device{}()),
+          replay_rng(config.seed ? static_cast<std::mt19937::result_type>(config.seed * 0xD1B54A32D192ED03ull >> 32)
+                                 : std::random_device{}()),
+          state_discretizer(cfg.novelty_resolution, static_cast<size_t>(std::max(0, cfg.novelty_dims))),
+          novelty(make_novelty_estimator(cfg)), current_epsilon(cfg.exploration_rate)
     {
         available_actions.emplace_back(0, "up");
         available_actions.emplace_back(1, "down");
@@ -22,20 +42,57 @@ namespace dbea
         belief_graph.add_belief(proto);
         last_action = available_actions[0];
 
-        for (int x = 0; x < 5; ++x)
-            for (int y = 0; y < 5; ++y)
-                state_visit_count[std::to_string(x) + "_" + std::to_string(y)] = 0;
+        if (config.island_mode)
+            island = std::make_unique<IslandModel>(config);
+        if (config.maintenance_mode == "background")
+            background = std::make_unique<BackgroundMaintenance>(config);
+        if (!config.record_trace.empty())
+            recorder = std::make_unique<TraceWriter>(config.record_trace, config);
+        if (!config.telemetry_shm.empty())
+        {
+            telemetry = std::make_unique<TelemetryPublisher>(config);
+            belief_graph.log_merges = true;
+        }
+        if (config.replay_capacity > 0)
+            replay = std::make_unique<ReplayBuffer>(config.replay_capacity, config.replay_max_features, config.replay_alpha);
+
+        if (config.decision_mode == "anytime")
+            anytime_decisions = true;
+        else if (config.decision_mode != "exact")
+            throw std::runtime_error("Unknown decision mode: " + config.decision_mode);
+        if (config.decision_order == "activation")
+            decision_order = DecisionOrder::Activation;
+        else if (config.decision_order == "confidence")
+            decision_order = DecisionOrder::Confidence;
+        else if (config.decision_order == "index")
+            decision_order = DecisionOrder::Index;
+        else
+            throw std::runtime_error("Unknown decision order: " + config.decision_order);
     }
 
+    Agent::~Agent() = default;
+
     void Agent::perceive(const PatternSignature &input)
     {
-        PatternSignature blended = input;
-        if (!last_perception.features.empty())
+        if (recorder)
+            recorder->perceive(input);
+        pull_emotion();
+        if (replay && replay_pending_action >= 0)
+        {
+            replay->push(replay_pending_perception, replay_pending_action, replay_pending_reward, input);
+            replay_pending_action = -1;
+        }
+
+        // Blended in a member buffer and copied with assign(): both keep their capacity
+        PatternSignature &blended = blended_perception;
+        blended.features.assign(input.features.begin(), input.features.end());
+        const size_t width = blended.features.size();
+        if (width > 0 && last_perception.features.size() >= width)
         {
-            for (size_t i = 0; i < blended.features.size(); ++i)
-                blended.features[i] = 0.95 * blended.features[i] + 0.05 * last_perception.features[i];
+            const PatternKernels &kernels = perception_kernels->width == width ? *perception_kernels : pattern_kernels(width);
+            kernels.blend(blended.features.data(), last_perception.features.data(), width);
         }
-        last_perception = input;
+        last_perception.features.assign(input.features.begin(), input.features.end());
 
         double base_threshold = 0.93;
         if (emotion.curiosity > config.curiosity_threshold)
@@ -46,94 +103,141 @@ namespace dbea
         auto belief = belief_graph.maybe_create_belief(blended, creation_threshold);
         if (belief->action_values.empty())
         {
+            BeliefNode &owned = belief_graph.own(belief.get());
             for (const auto &action : available_actions)
-                belief->action_values[action.id] = 0.1;
+                owned.action_values[action.id] = 0.1;
         }
-        belief_graph.prune();
+        if (!background) // threshold pruning is one of the background passes
+            belief_graph.prune();
     }
 
     Action Agent::decide()
     {
-        std::unordered_map<int, double> action_scores;
-        total_activation = 0.0;
-        for (const auto &belief : belief_graph.nodes)
-            total_activation += belief->activation;
+        Action chosen = select_action();
+        decision.action = chosen;
+        record_decision();
+        if (recorder)
+            recorder->decide(chosen.id, last_predicted_reward);
+        return chosen;
+    }
 
-        for (const auto &belief : belief_graph.nodes)
+    Action Agent::select_action()
+    {
+        pull_emotion();
+        if (anytime_decisions)
+            score_beliefs_anytime();
+        else
+            score_beliefs();
+        // Scores by position in available_actions; bonuses name actions by id
+        action_scores.assign(belief_scores.begin(), belief_scores.end());
+        auto bump = [&](uint32_t id, double amount)
         {
-            for (const auto &action : available_actions)
+            for (size_t a = 0; a < available_actions.size(); ++a)
             {
-                double weight = belief->activation / (total_activation + 1e-6);
-                action_scores[action.id] += weight * belief->predict_action_value(action.id);
+                if (available_actions[a].id == id)
+                    action_scores[a] += amount;
             }
-        }
-
+        };
         if (!last_perception.features.empty() && last_perception.features.size() >= 2)
         {
             double norm_x = last_perception.features[0];
             double norm_y = last_perception.features[1];
-            int grid_x = static_cast<int>(norm_x * 4.999);
-            int grid_y = static_cast<int>(norm_y * 4.999);
-            std::string key = std::to_string(grid_x) + "_" + std::to_string(grid_y);
-            state_visit_count[key]++;
-            double visit_inverse = 1.0 / (1.0 + state_visit_count[key] * 0.08);
+            int64_t grid_x = state_discretizer.bin(norm_x);
+            int64_t grid_y = state_discretizer.bin(norm_y);
+            uint32_t visits = novelty->visit(state_discretizer.cell(last_perception.features.data(),
+                                                                    last_perception.features.size()));
+            double visit_inverse = 1.0 / (1.0 + visits * 0.08);
             double curiosity_bonus = config.curiosity_boost * 0.7 * visit_inverse;
-            if (grid_x >= 2 && grid_y >= 2)
+            // Far half of the grid in both axes (bins >= 2 of 5 at the default resolution)
+            int far_bin = state_discretizer.resolution() * 2 / 5;
+            if (grid_x >= far_bin && grid_y >= far_bin)
                 curiosity_bonus *= 3.6;
-            action_scores[1] += curiosity_bonus * 1.2; // down
-            action_scores[3] += curiosity_bonus * 1.4; // right
+            bump(1, curiosity_bonus * 1.2); // down
+            bump(3, curiosity_bonus * 1.4); // right
         }
 
-        static double current_epsilon = config.exploration_rate;
         current_epsilon = std::max(config.min_exploration, current_epsilon * config.epsilon_decay);
 
-        static std::uniform_real_distribution<double> epsilon_dist(0.0, 1.0);
+        std::uniform_real_distribution<double> epsilon_dist(0.0, 1.0);
         if (epsilon_dist(rng) < current_epsilon)
         {
-            static std::uniform_int_distribution<size_t> action_dist(0, available_actions.size() - 1);
+            std::uniform_int_distribution<size_t> action_dist(0, available_actions.size() - 1);
             last_action = available_actions[action_dist(rng)];
             return last_action;
         }
 
         double emotional_bonus = emotion.explore_bias * config.explore_bias_scale;
         double fear_penalty = emotion.fear * 0.40;
-        action_scores[3] += emotional_bonus;
-        action_scores[0] -= emotional_bonus * 0.7;
-        action_scores[1] -= fear_penalty;
+        bump(3, emotional_bonus);
+        bump(0, -emotional_bonus * 0.7);
+        bump(1, -fear_penalty);
 
-        Action best = available_actions[0];
+        size_t best_index = 0;
         double best_score = -1e9;
-        for (const auto &action : available_actions)
+        for (size_t a = 0; a < available_actions.size(); ++a)
         {
-            double score = action_scores[action.id];
-            if (score > best_score)
+            if (action_scores[a] > best_score)
             {
-                best_score = score;
-                best = action;
+                best_score = action_scores[a];
+                best_index = a;
             }
         }
+        const Action &best = available_actions[best_index];
 
         last_action = best;
-
-        double chosen_pred = 0.0;
-        for (const auto &belief : belief_graph.nodes)
-        {
-            double weight = belief->activation / (total_activation + 1e-6);
-            chosen_pred += weight * belief->predict_action_value(best.id);
-        }
-        last_predicted_reward = chosen_pred;
+        last_predicted_reward = belief_scores[best_index];
 
         return best;
     }
 
     void Agent::receive_reward(double valence, double surprise)
     {
-        emotion.update(valence, surprise, 0.0, config);
+        if (recorder)
+            recorder->reward(valence, surprise);
+        pull_emotion();
+        update_emotion(valence, surprise, 0.0);
         last_reward = valence;
     }
 
+    void Agent::bind_emotion(EmotionEngine &engine, size_t slot)
+    {
+        emotion_engine = &engine;
+        emotion_slot = slot;
+        pull_emotion();
+    }
+
+    void Agent::set_emotion(const EmotionState &new_emotion)
+    {
+        if (recorder)
+            recorder->set_emotion(new_emotion);
+        emotion = new_emotion;
+        if (emotion_engine)
+            emotion_engine->set(emotion_slot, emotion);
+    }
+
+    void Agent::pull_emotion()
+    {
+        // The engine may have been stepped for the whole population since our last call
+        if (emotion_engine)
+            emotion = emotion_engine->get(emotion_slot);
+    }
+
+    void Agent::update_emotion(double reward_valence, double reward_surprise, double avg_error)
+    {
+        if (!emotion_engine)
+        {
+            emotion.update(reward_valence, reward_surprise, avg_error, config);
+            return;
+        }
+        emotion_engine->update(emotion_slot, reward_valence, reward_surprise, avg_error, config);
+        emotion = emotion_engine->get(emotion_slot);
+    }
+
     void Agent::learn()
     {
+        if (recorder)
+            recorder->learn();
+        pull_emotion();
         double total_error = 0.0;
         int count = 0;
         double reinforcement_mod = 1.0 + 0.5 * emotion.valence + 0.3 * emotion.arousal;
@@ -147,20 +251,30 @@ namespace dbea
             progress_bonus = (norm_x * 0.12) + (norm_y * 0.18);
         }
 
+        // Every belief is written below, so beliefs shared with a fork are cloned first
+        belief_graph.own_all();
+
         // NEW: Track co-activations for symbiosis
-        std::vector<std::shared_ptr<BeliefNode>> active_beliefs;
+        // Keys are built in a reused buffer; only a pair seen for the first time allocates
+        co_active.clear();
         for (auto &belief : belief_graph.nodes)
         {
-            if (belief->activation > config.co_activation_thresh)
-                active_beliefs.push_back(belief);
+            if (belief_graph.activation_of(*belief) > config.co_activation_thresh)
+                co_active.push_back(belief.get());
         }
-        for (size_t i = 0; i < active_beliefs.size(); ++i)
+        for (size_t i = 0; i < co_active.size(); ++i)
         {
-            for (size_t j = i + 1; j < active_beliefs.size(); ++j)
+            for (size_t j = i + 1; j < co_active.size(); ++j)
             {
-                std::string key = std::min(active_beliefs[i]->id, active_beliefs[j]->id) + "_" +
-                                  std::max(active_beliefs[i]->id, active_beliefs[j]->id);
-                belief_graph.co_activations[key]++;
+                const std::string &lo = std::min(co_active[i]->id, co_active[j]->id);
+                const std::string &hi = std::max(co_active[i]->id, co_active[j]->id);
+                co_activation_key.assign(lo).append(1, '_').append(hi);
+                auto &counts = belief_graph.mutable_co_activations();
+                auto it = counts.find(co_activation_key);
+                if (it != counts.end())
+                    it->second++;
+                else
+                    counts.emplace(co_activation_key, 1);
             }
         }
 
@@ -172,7 +286,8 @@ namespace dbea
 
         for (auto &belief : belief_graph.nodes)
         {
-            double credit = belief->activation * (last_reward + progress_bonus);
+            const double activation = belief_graph.activation_of(*belief);
+            double credit = activation * (last_reward + progress_bonus);
             double surprise_factor = 1.0 + 2.0 * std::abs(last_reward - last_predicted_reward);
 
             // Q-learning update (same as before)
@@ -183,7 +298,7 @@ namespace dbea
             {
                 if (!std::isfinite(val))
                     val = 0.1;
-                val = std::clamp(val, -1.0, 5.0);
+                val = std::clamp<Real>(val, -1.0, 5.0);
             }
 
             // Confidence update
@@ -194,45 +309,39 @@ namespace dbea
 
             // Simple fitness = running average TD error reduction + credit
             double delta_td = last_reward + config.gamma * belief->predict_action_value(last_action.id) - belief->last_predicted_reward;
-            belief->fitness += 0.015 * delta_td * belief->activation;
-            belief->fitness = std::max(0.0, belief->fitness);
+            belief->fitness += 0.015 * delta_td * activation;
+            belief->fitness = std::max<Real>(0.0, belief->fitness);
 
             // Prediction error tracking
             double error = std::abs(last_reward - last_predicted_reward);
             belief->prediction_error = 0.7 * belief->prediction_error + 0.3 * error;
-            total_error += belief->prediction_error * belief->activation;
+            total_error += belief->prediction_error * activation;
             count++;
+            belief_graph.touch(belief.get());
         }
 
         double avg_error = (count > 0) ? total_error / count : 0.0;
-        emotion.update(last_reward, 0.05, avg_error, config);
+        update_emotion(last_reward, 0.05, avg_error);
 
         if (!belief_graph.nodes.empty())
         {
             auto &proto = *belief_graph.nodes.front();
             if (proto.id == "proto-belief")
+            {
                 proto.decay(0.035);
+                belief_graph.touch(&proto);
+            }
         }
 
-        double dynamic_merge = config.merge_threshold + 0.02 * (1.0 - emotion.dominance);
-        belief_graph.merge_beliefs(dynamic_merge);
-
-        // Adaptive prune: much gentler when population is low
-        double prune_thresh;
-        size_t current_size = belief_graph.nodes.size();
-        if (current_size < 5)
-            prune_thresh = 0.05; // Very gentle — almost no pruning
-        else if (current_size < config.min_beliefs_before_prune)
-            prune_thresh = 0.12;
-        else
-            prune_thresh = 0.32;
-
-        prune_beliefs(prune_thresh);
+        // Budgeted mode runs merge and prune (and evolution, below) a slice per step;
+        // background mode hands them to the worker thread
+        if (!belief_graph.maintenance_budgeted() && !background)
+        {
+            belief_graph.merge_beliefs(merge_threshold_now());
+            prune_beliefs(prune_threshold_now());
+        }
 
         // NEW: Evolutionary cycle trigger
-        static int step_count = 0;
-        static double reward_buffer = 0.0;
-        static int low_reward_streak = 0;
         step_count++;
         reward_buffer = 0.95 * reward_buffer + 0.05 * last_reward;
         if (last_reward < 0.0)
@@ -245,11 +354,66 @@ namespace dbea
 
         if (step_count % effective_freq == 0 || reward_buffer < config.crisis_reward_thresh || low_reward_streak > 5)
         {
-            belief_graph.evolve_cycle(emotion);
+            if (belief_graph.maintenance_budgeted())
+                belief_graph.request_evolution(emotion);
+            else if (background)
+                evolution_due = true;
+            else
+                belief_graph.evolve_cycle(emotion);
             step_count = 0; // Optional reset
         }
+        if (belief_graph.maintenance_budgeted())
+            belief_graph.maintain(merge_threshold_now(), prune_threshold_now());
+        if (background)
+        {
+            // Step boundary: adopt a finished generation, then start the next one when due
+            background->try_install(belief_graph);
+            ++steps_since_maintenance;
+            if (evolution_due || steps_since_maintenance >= config.maintenance_interval)
+            {
+                BackgroundMaintenance::Request request;
+                request.merge_threshold = merge_threshold_now();
+                request.prune_threshold = prune_threshold_now();
+                request.evolve = evolution_due;
+                request.emotion = emotion;
+                if (background->submit(belief_graph, request))
+                {
+                    evolution_due = false;
+                    steps_since_maintenance = 0;
+                }
+            }
+        }
+
+        if (belief_graph.cold_tier_state() && ++steps_since_demotion >= config.cold_tier_interval)
+        {
+            belief_graph.demote_idle();
+            steps_since_demotion = 0;
+        }
+
+        if (replay && !last_perception.features.empty())
+        {
+            replay_pending_perception = last_perception;
+            replay_pending_action = static_cast<int>(last_action.id);
+            replay_pending_reward = last_reward;
+            if (config.replay_every > 0 && ++steps_since_replay >= config.replay_every)
+            {
+                replay_update(static_cast<size_t>(config.replay_batch_size));
+                steps_since_replay = 0;
+            }
+        }
+
+        // Island model: exchange top-fitness beliefs with neighbouring processes
+        if (island && ++steps_since_migration >= config.migration_interval)
+        {
+            island->migrate(belief_graph);
+            steps_since_migration = 0;
+        }
+        if (telemetry)
+            telemetry->tick(belief_graph, emotion);
 
         // Debug (unchanged)
+        if (!config.verbose)
+            return;
         std::cout << "[DBEA] === Step Summary ===\n";
         for (const auto &belief : belief_graph.nodes)
         {
@@ -275,6 +439,7 @@ namespace dbea
     json Agent::to_json() const
     {
         json j;
+        j["precision"] = kRealPrecision;
         j["emotion"]["valence"] = emotion.valence;
         j["emotion"]["arousal"] = emotion.arousal;
         j["emotion"]["dominance"] = emotion.dominance;
@@ -283,7 +448,8 @@ namespace dbea
         j["emotion"]["explore_bias"] = emotion.explore_bias;
 
         json beliefs_arr = json::array();
-        for (const auto &node : belief_graph.nodes)
+        // Cold beliefs are saved as ordinary ones and reload hot
+        for (const auto &node : belief_graph.all_beliefs())
         {
             json b;
             b["id"] = node->id;
@@ -301,10 +467,11 @@ namespace dbea
             beliefs_arr.push_back(b);
         }
         j["beliefs"] = beliefs_arr;
+        j["next_belief_id"] = belief_graph.next_belief_id();
 
         // NEW: Save co_activations
         json co_act = json::object();
-        for (const auto &[key, val] : belief_graph.co_activations)
+        for (const auto &[key, val] : belief_graph.co_activations())
             co_act[key] = val;
         j["co_activations"] = co_act;
 
@@ -313,8 +480,17 @@ namespace dbea
 
     void Agent::from_json(const json &j)
     {
-        belief_graph.nodes.clear();
-        belief_graph.co_activations.clear(); // NEW
+        if (recorder)
+            recorder->load(j);
+        if (background)
+            background->discard(); // its generation was copied from the graph being replaced
+        belief_graph.clear();
+        belief_graph.mutable_co_activations().clear(); // NEW
+
+        // Checkpoints without a precision tag predate the float build and are double
+        std::string precision = j.value("precision", "double");
+        if (precision != kRealPrecision && config.verbose)
+            std::cout << "[DBEA] Loading " << precision << " checkpoint into " << kRealPrecision << " build\n";
 
         if (j.contains("emotion"))
         {
@@ -325,21 +501,28 @@ namespace dbea
             emotion.curiosity = e.value("curiosity", 0.5);
             emotion.fear = e.value("fear", 0.0);
             emotion.explore_bias = e.value("explore_bias", 0.0);
+            if (emotion_engine)
+                emotion_engine->set(emotion_slot, emotion);
         }
 
+        // Older checkpoints have no counter; continue past the highest numbered id instead
+        uint64_t next_id = j.value("next_belief_id", uint64_t(0));
         if (j.contains("beliefs"))
         {
             for (const auto &b : j["beliefs"])
             {
                 std::string id = b["id"];
-                std::vector<double> proto_features = b["prototype"].get<std::vector<double>>();
+                if (id.rfind("belief_", 0) == 0 && id.size() > 7 &&
+                    id.find_first_not_of("0123456789", 7) == std::string::npos && id.size() <= 7 + 19)
+                    next_id = std::max<uint64_t>(next_id, std::stoull(id.substr(7)) + 1);
+                std::vector<Real> proto_features = b["prototype"].get<std::vector<Real>>();
                 auto node = std::make_shared<BeliefNode>(id, PatternSignature(proto_features));
                 node->confidence = b.value("confidence", 0.5);
                 node->evidence_count = b.value("evidence_count", 1);
                 node->fitness = b.value("fitness", 0.0);                                               // NEW
                 node->mutation_rate = b.value("mutation_rate", 0.1);                                   // NEW
                 node->local_lr = b.value("local_lr", config.learning_rate);                            // NEW
-                node->emotional_affinity = b.value("emotional_affinity", std::vector<double>(5, 0.0)); // NEW
+                node->emotional_affinity = b.value("emotional_affinity", std::vector<Real>(5, 0.0)); // NEW
                 if (b.contains("action_values"))
                 {
                     for (auto &[key, val] : b["action_values"].items())
@@ -352,13 +535,34 @@ namespace dbea
             }
         }
 
+        belief_graph.set_next_belief_id(next_id);
+
         // NEW: Load co_activations
         if (j.contains("co_activations"))
         {
+            auto &counts = belief_graph.mutable_co_activations();
             for (auto &[key, val] : j["co_activations"].items())
-                belief_graph.co_activations[key] = val.get<int>();
+                counts[key] = val.get<int>();
         }
     }
+    std::unique_ptr<Agent> Agent::fork(const Config &cfg)
+    {
+        pull_emotion();
+        auto child = std::make_unique<Agent>(cfg);
+        child->emotion = emotion;
+        child->belief_graph.share_from(belief_graph);
+        if (child->recorder) // a replay has to start from the same beliefs
+            child->recorder->load(child->to_json());
+        if (config.verbose)
+            std::cout << "[DBEA] Forked agent sharing " << child->belief_graph.shared_count() << " beliefs\n";
+        return child;
+    }
+
+    size_t Agent::compact_overlay()
+    {
+        return belief_graph.share_all();
+    }
+
     void Agent::save(const std::string &filename) const
     {
         std::ofstream file(filename);
@@ -394,6 +598,10 @@ namespace dbea
     {
         return belief_graph.nodes.size();
     }
+    uint64_t Agent::background_submissions() const
+    {
+        return background ? background->stats().submitted : 0;
+    }
     std::vector<std::pair<double, double>> Agent::get_all_belief_action_values() const
     {
         std::vector<std::pair<double, double>> values;
@@ -407,29 +615,104 @@ namespace dbea
     }
     void Agent::prune_beliefs(double threshold)
     {
+        if (recorder)
+            recorder->prune(threshold);
         belief_graph.prune(threshold);
     }
+    void Agent::run_full_maintenance()
+    {
+        if (recorder)
+            recorder->full_maintenance();
+        if (background)
+            background->wait_and_install(belief_graph);
+        belief_graph.run_full_maintenance(merge_threshold_now(), prune_threshold_now());
+    }
+    double Agent::merge_threshold_now() const
+    {
+        return config.merge_threshold + 0.02 * (1.0 - emotion.dominance);
+    }
+    // Adaptive prune: much gentler when population is low
+    double Agent::prune_threshold_now() const
+    {
+        size_t current_size = belief_graph.nodes.size();
+        if (current_size < 5)
+            return 0.05; // Very gentle — almost no pruning
+        if (current_size < static_cast<size_t>(config.min_beliefs_before_prune))
+            return 0.12;
+        return 0.32;
+    }
     void Agent::set_therapy_mode(bool enabled)
     {
+        if (recorder)
+            recorder->therapy_mode(enabled);
         config.therapy_mode = enabled;
     }
 
+    void Agent::set_observation_dimension(size_t dimension)
+    {
+        perception_kernels = &pattern_kernels(dimension);
+        if (config.verbose && perception_kernels->specialized())
+            std::cout << "[DBEA] Fixed-width pattern kernels: D = " << dimension << "\n";
+    }
+
     void Agent::set_merge_threshold(double threshold)
     {
+        if (recorder)
+            recorder->merge_threshold(threshold);
         config.merge_threshold = threshold;
     }
 
     void Agent::force_action(const std::string &action_name)
     {
+        if (recorder)
+            recorder->force_action(action_name);
         for (const auto &act : available_actions)
         {
             if (act.name == action_name)
             {
                 last_action = act;
-                std::cout << "[DBEA] Forced action: " << action_name << "\n";
+                if (config.verbose)
+                    std::cout << "[DBEA] Forced action: " << action_name << "\n";
                 return;
             }
         }
         std::cerr << "[WARNING] Could not force action: " << action_name << " not found!\n";
     }
-} // namespace dbea
\ No newline at end of file
+
+    void Agent::force_action(uint32_t action_id)
+    {
+        for (const auto &act : available_actions)
+        {
+            if (act.id == action_id)
+            {
+                force_action(act.name);
+                return;
+            }
+        }
+        std::cerr << "[WARNING] Could not force action: id " << action_id << " not found!\n";
+    }
+
+    void Agent::apply_action(uint32_t action_id, double predicted_value)
+    {
+        auto it = std::find_if(available_actions.begin(), available_actions.end(),
+                               [&](const Action &a)
+                               { return a.id == action_id; });
+        if (it == available_actions.end())
+            throw std::runtime_error("Transition with unknown action id " + std::to_string(action_id));
+        if (recorder)
+            recorder->apply_action(action_id, predicted_value);
+        last_action = *it;
+        last_predicted_reward = predicted_value;
+        // Stands in for the actor's decide(): snapshots carry the decayed epsilon
+        current_epsilon = std::max(config.min_exploration, current_epsilon * config.epsilon_decay);
+    }
+
+    void Agent::learn_transition(const PatternSignature &observation, uint32_t action_id, double predicted_value,
+                                 double reward_valence, double reward_surprise)
+    {
+        perceive(observation);
+        apply_action(action_id, predicted_value);
+        receive_reward(reward_valence, reward_surprise);
+        learn();
+    }
+} // namespace dbea
@@ -0,0 +1,362 @@
+#include "dbea/CompiledPolicy.h"
+#include "dbea/Agent.h"
+#include "dbea/FrozenAgent.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <set>
+#include <stdexcept>
+
+namespace dbea
+{
+    namespace
+    {
+        constexpr uint32_t kPolicyMagic = 0x54504244; // "DBPT"
+        constexpr uint32_t kPolicyVersion = 1;
+        constexpr uint32_t kDenseLayout = 0;
+        constexpr uint32_t kSparseLayout = 1;
+        constexpr uint8_t kEmptySlot = 0xFF;
+        constexpr int32_t kEmptyKey = std::numeric_limits<int32_t>::min();
+
+        struct PolicyHeader
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t layout;
+            uint32_t width;
+            uint32_t actions;
+            uint32_t reserved;
+            uint64_t slots;
+            uint64_t axes_offset;
+            uint64_t keys_offset;
+            uint64_t action_offset;
+            uint64_t value_offset;
+        };
+        static_assert(sizeof(PolicyHeader) == 64, "CompiledPolicy header layout changed");
+
+        using ActionRecord = CompiledPolicy::ActionRecord;
+        using AxisRecord = CompiledPolicy::AxisRecord;
+        static_assert(sizeof(ActionRecord) == 32 && sizeof(AxisRecord) == 24, "CompiledPolicy record layout changed");
+
+        uint64_t align8(uint64_t offset) { return (offset + 7) & ~uint64_t(7); }
+
+        struct Layout
+        {
+            uint64_t axes = 0;
+            uint64_t keys = 0;
+            uint64_t action = 0;
+            uint64_t value = 0;
+            uint64_t total = 0;
+        };
+
+        Layout layout_for(uint64_t actions, uint64_t width, uint64_t slots, bool sparse)
+        {
+            Layout l;
+            l.axes = sizeof(PolicyHeader) + actions * sizeof(ActionRecord);
+            uint64_t next = l.axes + width * sizeof(AxisRecord);
+            if (sparse)
+            {
+                l.keys = next;
+                next += slots * width * sizeof(int32_t);
+            }
+            l.action = next;
+            l.value = align8(l.action + slots);
+            l.total = align8(l.value + slots * sizeof(float));
+            return l;
+        }
+
+        // Sparse keys: features rounded to the nearest code, saturating (NaN -> lowest)
+        int32_t quantize(double v)
+        {
+            constexpr double kLimit = 2147483647.0;
+            if (!(v > -kLimit))
+                return -std::numeric_limits<int32_t>::max();
+            if (v > kLimit)
+                return std::numeric_limits<int32_t>::max();
+            // floor(v + 0.5) without a libm call (no SSE4.1 round instruction at baseline x86-64)
+            const double r = v + 0.5;
+            int64_t code = static_cast<int64_t>(r);
+            if (static_cast<double>(code) > r)
+                code--;
+            return static_cast<int32_t>(code);
+        }
+
+        uint64_t hash_codes(const int32_t *codes, size_t width)
+        {
+            uint64_t h = 0x9E3779B97F4A7C15ull ^ width;
+            for (size_t d = 0; d < width; ++d)
+            {
+                // splitmix64 finalizer per code
+                h ^= static_cast<uint32_t>(codes[d]);
+                h ^= h >> 30;
+                h *= 0xBF58476D1CE4E5B9ull;
+                h ^= h >> 27;
+                h *= 0x94D049BB133111EBull;
+                h ^= h >> 31;
+            }
+            return h;
+        }
+
+        // Header, action table and axes of a new file; returns the image base
+        unsigned char *begin_image(MappedFile &out, const std::string &path, const Layout &layout, uint32_t kind,
+                                   const std::vector<Action> &actions, const std::vector<AxisRecord> &axes,
+                                   uint64_t slots)
+        {
+            if (actions.empty() || actions.size() >= kEmptySlot)
+                throw std::runtime_error("A compiled policy needs 1 to 254 actions");
+            out.create(path, layout.total);
+            auto *base = static_cast<unsigned char *>(out.data());
+            auto *header = reinterpret_cast<PolicyHeader *>(base);
+            header->magic = kPolicyMagic;
+            header->version = kPolicyVersion;
+            header->layout = kind;
+            header->width = static_cast<uint32_t>(axes.size());
+            header->actions = static_cast<uint32_t>(actions.size());
+            header->slots = slots;
+            header->axes_offset = layout.axes;
+            header->keys_offset = layout.keys;
+            header->action_offset = layout.action;
+            header->value_offset = layout.value;
+            auto *records = reinterpret_cast<ActionRecord *>(base + sizeof(PolicyHeader));
+            for (size_t a = 0; a < actions.size(); ++a)
+            {
+                records[a].id = actions[a].id;
+                std::strncpy(records[a].name, actions[a].name, sizeof(records[a].name) - 1);
+            }
+            std::memcpy(base + layout.axes, axes.data(), axes.size() * sizeof(AxisRecord));
+            std::fill(base + layout.action, base + layout.action + slots, kEmptySlot);
+            return base;
+        }
+
+        uint8_t action_index(const std::vector<Action> &actions, const Action &chosen)
+        {
+            for (size_t a = 0; a < actions.size(); ++a)
+            {
+                if (actions[a].id == chosen.id)
+                    return static_cast<uint8_t>(a);
+            }
+            return 0;
+        }
+    } // namespace
+
+    std::shared_ptr<const CompiledPolicy> CompiledPolicy::open(const std::string &path)
+    {
+        std::shared_ptr<CompiledPolicy> policy(new CompiledPolicy());
+        policy->file.open_read(path);
+        policy->attach(static_cast<const unsigned char *>(policy->file.data()), policy->file.size(), path);
+        return policy;
+    }
+
+    void CompiledPolicy::attach(const unsigned char *base, size_t size, const std::string &source)
+    {
+        if (size < sizeof(PolicyHeader))
+            throw std::runtime_error(source + " is too small to be a compiled policy");
+        const auto *header = reinterpret_cast<const PolicyHeader *>(base);
+        if (header->magic != kPolicyMagic)
+            throw std::runtime_error(source + " is not a compiled policy");
+        if (header->version != kPolicyVersion)
+            throw std::runtime_error(source + ": unsupported compiled policy version " +
+                                     std::to_string(header->version));
+        const bool sparse = header->layout == kSparseLayout;
+        if ((!sparse && header->layout != kDenseLayout) || header->actions == 0 || header->width == 0)
+            throw std::runtime_error(source + ": malformed compiled policy header");
+        // Every count is bounded by the file size first, so the layout arithmetic cannot wrap
+        if (header->actions > size / sizeof(ActionRecord) || header->width > size / sizeof(AxisRecord) ||
+            header->slots > size / (1 + sizeof(float)) || (sparse && header->width > 16))
+            throw std::runtime_error(source + " is truncated or has a corrupt layout");
+        Layout layout = layout_for(header->actions, header->width, header->slots, sparse);
+        if (layout.axes != header->axes_offset || layout.keys != header->keys_offset ||
+            layout.action != header->action_offset || layout.value != header->value_offset || size < layout.total)
+            throw std::runtime_error(source + " is truncated or has a corrupt layout");
+
+        actions = reinterpret_cast<const ActionRecord *>(base + sizeof(PolicyHeader));
+        action_count = header->actions;
+        const auto *axis_records = reinterpret_cast<const AxisRecord *>(base + layout.axes);
+        axes.clear();
+        strides.clear();
+        uint64_t stride = 1;
+        for (uint32_t d = 0; d < header->width; ++d)
+        {
+            axes.push_back(axis_records[d]);
+            strides.push_back(stride);
+            if (sparse)
+                continue;
+            // slot() clamps to points - 1, so an empty axis would index past the table
+            const uint64_t points = axis_records[d].points;
+            if (points == 0 || stride > header->slots / points)
+                throw std::runtime_error(source + ": axes do not match the table size");
+            stride *= points;
+        }
+        if (sparse && (header->slots == 0 || (header->slots & (header->slots - 1)) != 0))
+            throw std::runtime_error(source + ": sparse table size is not a power of two");
+        if (!sparse && stride != header->slots)
+            throw std::runtime_error(source + ": axes do not match the table size");
+        keys = sparse ? reinterpret_cast<const int32_t *>(base + layout.keys) : nullptr;
+        slot_action = base + layout.action;
+        slot_value = reinterpret_cast<const float *>(base + layout.value);
+        slot_count = header->slots;
+        size_t empty_keys = 0;
+        for (size_t s = 0; s < slot_count; ++s)
+        {
+            // Dense cells and occupied sparse slots are looked up, so they need a valid action
+            if (keys && keys[s * axes.size()] == kEmptyKey)
+            {
+                empty_keys++;
+                continue;
+            }
+            if (slot_action[s] >= action_count)
+                throw std::runtime_error(source + ": action index out of range");
+        }
+        // A miss probes until it reaches an empty slot
+        if (sparse && empty_keys == 0)
+            throw std::runtime_error(source + ": sparse table has no empty slot");
+    }
+
+    int64_t CompiledPolicy::slot(const Real *features, size_t width) const
+    {
+        if (width != axes.size())
+            return -1;
+        if (!keys)
+        {
+            uint64_t cell = 0;
+            for (size_t d = 0; d < width; ++d)
+            {
+                const AxisRecord &axis = axes[d];
+                double v = (static_cast<double>(features[d]) - axis.lo) * axis.scale;
+                const double last = static_cast<double>(axis.points - 1);
+                v = v > 0.0 ? (v < last ? v : last) : 0.0; // NaN clamps to 0
+                // via int64: a double -> uint64 conversion is a branchy sequence on x86-64
+                cell += static_cast<uint64_t>(static_cast<int64_t>(v + 0.5)) * strides[d];
+            }
+            return static_cast<int64_t>(cell);
+        }
+        int32_t codes[16];
+        if (width > 16)
+            return -1;
+        for (size_t d = 0; d < width; ++d)
+            codes[d] = quantize(static_cast<double>(features[d]) * axes[d].scale);
+        const uint64_t mask = slot_count - 1;
+        for (uint64_t s = hash_codes(codes, width) & mask;; s = (s + 1) & mask)
+        {
+            const int32_t *key = keys + s * width;
+            if (key[0] == kEmptyKey)
+                return -1;
+            if (std::equal(codes, codes + width, key))
+                return static_cast<int64_t>(s);
+        }
+    }
+
+    const char *CompiledPolicy::action_name(uint32_t id) const
+    {
+        for (size_t a = 0; a < action_count; ++a)
+        {
+            if (actions[a].id == id)
+                return actions[a].name;
+        }
+        return "";
+    }
+
+    void CompiledPolicy::compile_grid(const Agent &agent, const std::vector<PolicyAxis> &grid, const std::string &path)
+    {
+        if (grid.empty())
+            throw std::runtime_error("A compiled policy grid needs at least one axis");
+        uint64_t cells = 1;
+        std::vector<AxisRecord> axes;
+        for (const auto &axis : grid)
+        {
+            if (axis.points == 0)
+                throw std::runtime_error("Policy grid axes need at least one point");
+            cells *= axis.points;
+            if (cells > (uint64_t(1) << 32))
+                throw std::runtime_error("Policy grid has more than 2^32 cells");
+            double span = axis.hi - axis.lo;
+            double scale = (axis.points > 1 && span != 0.0) ? (axis.points - 1) / span : 0.0;
+            axes.push_back(AxisRecord{axis.lo, scale, axis.points});
+        }
+
+        const FrozenAgent frozen(agent, 0.0);
+        const std::vector<Action> &actions = frozen.policy().actions;
+        const Layout layout = layout_for(actions.size(), axes.size(), cells, false);
+        MappedFile out;
+        unsigned char *base = begin_image(out, path, layout, kDenseLayout, actions, axes, cells);
+        uint8_t *slot_action = base + layout.action;
+        auto *slot_value = reinterpret_cast<float *>(base + layout.value);
+
+        // Odometer over the lattice, first dimension fastest (the row-major order of slot())
+        std::vector<uint32_t> coord(grid.size(), 0);
+        PatternSignature obs;
+        obs.features.resize(grid.size());
+        FrozenAgent::Episode episode;
+        std::mt19937 rng(0); // epsilon is 0, so never drawn from for a choice
+        for (uint64_t cell = 0; cell < cells; ++cell)
+        {
+            for (size_t d = 0; d < grid.size(); ++d)
+            {
+                const PolicyAxis &axis = grid[d];
+                obs.features[d] = static_cast<Real>(
+                    axis.points > 1 ? axis.lo + (axis.hi - axis.lo) * coord[d] / (axis.points - 1) : axis.lo);
+            }
+            episode.reset();
+            slot_action[cell] = action_index(actions, frozen.act(obs, rng, episode));
+            slot_value[cell] = static_cast<float>(episode.predicted_value);
+            for (size_t d = 0; d < grid.size() && ++coord[d] == grid[d].points; ++d)
+                coord[d] = 0;
+        }
+        out.flush();
+    }
+
+    void CompiledPolicy::compile_states(const Agent &agent, const std::vector<PatternSignature> &states,
+                                        double resolution, const std::string &path)
+    {
+        if (states.empty() || states.front().features.empty() || states.front().features.size() > 16)
+            throw std::runtime_error("Compiled policy states need 1 to 16 features");
+        const size_t width = states.front().features.size();
+        // Sized for the distinct keys at no more than half load
+        std::set<std::vector<int32_t>> distinct;
+        for (const auto &state : states)
+        {
+            if (state.features.size() != width)
+                throw std::runtime_error("Compiled policy states must all have the same width");
+            std::vector<int32_t> key(width);
+            for (size_t d = 0; d < width; ++d)
+                key[d] = quantize(static_cast<double>(state.features[d]) * resolution);
+            distinct.insert(std::move(key));
+        }
+        uint64_t slots = 2;
+        while (slots < 2 * distinct.size())
+            slots <<= 1;
+        std::vector<AxisRecord> axes(width, AxisRecord{0.0, resolution, 0});
+
+        const FrozenAgent frozen(agent, 0.0);
+        const std::vector<Action> &actions = frozen.policy().actions;
+        const Layout layout = layout_for(actions.size(), width, slots, true);
+        MappedFile out;
+        unsigned char *base = begin_image(out, path, layout, kSparseLayout, actions, axes, slots);
+        auto *keys = reinterpret_cast<int32_t *>(base + layout.keys);
+        uint8_t *slot_action = base + layout.action;
+        auto *slot_value = reinterpret_cast<float *>(base + layout.value);
+        for (uint64_t s = 0; s < slots; ++s)
+            keys[s * width] = kEmptyKey;
+
+        FrozenAgent::Episode episode;
+        std::mt19937 rng(0);
+        std::vector<int32_t> codes(width);
+        const uint64_t mask = slots - 1;
+        for (const auto &state : states)
+        {
+            for (size_t d = 0; d < width; ++d)
+                codes[d] = quantize(static_cast<double>(state.features[d]) * resolution);
+            uint64_t s = hash_codes(codes.data(), width) & mask;
+            while (keys[s * width] != kEmptyKey && !std::equal(codes.begin(), codes.end(), keys + s * width))
+                s = (s + 1) & mask;
+            if (keys[s * width] != kEmptyKey)
+                continue; // same key as an earlier state; the first one stands
+            std::copy(codes.begin(), codes.end(), keys + s * width);
+            episode.reset();
+            slot_action[s] = action_index(actions, frozen.act(state, rng, episode));
+            slot_value[s] = static_cast<float>(episode.predicted_value);
+        }
+        out.flush();
+    }
+} // namespace dbea
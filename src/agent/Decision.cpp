@@ -0,0 +1,164 @@
+#include "dbea/Agent.h"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+namespace dbea
+{
+    namespace
+    {
+        // Rows probed between clock reads; a scored row costs one action-value lookup per action
+        constexpr size_t kClockStride = 8;
+        // Rows bucketed between clock reads while ordering
+        constexpr size_t kScanStride = 256;
+        // Priority levels below the best key; rows within a level are visited in row order
+        constexpr size_t kLevels = 16;
+    } // namespace
+
+    void Agent::score_beliefs()
+    {
+        // Beliefs outside the perceived width partition have zero activation and add nothing
+        const auto &active = belief_graph.active_beliefs();
+        const auto &activations = belief_graph.active_activations();
+        belief_scores.assign(available_actions.size(), 0.0);
+        total_activation = 0.0;
+        for (Real activation : activations)
+            total_activation += activation;
+
+        for (size_t row = 0; row < active.size(); ++row)
+        {
+            for (size_t a = 0; a < available_actions.size(); ++a)
+            {
+                double weight = activations[row] / (total_activation + 1e-6);
+                belief_scores[a] += weight * active[row]->predict_action_value(available_actions[a].id);
+            }
+        }
+        decision.visited = active.size();
+        decision.population = active.size();
+        decision.coverage = 1.0;
+        decision.truncated = false;
+        decision.micros = 0.0;
+    }
+
+    // The same mixture, accumulated belief by belief in priority order until the
+    // deadline or the candidate cap. Scores are normalised by the activation mass
+    // seen, so a truncated decision is the exact one over the beliefs it visited.
+    void Agent::score_beliefs_anytime()
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const bool timed = config.decision_budget_us > 0.0;
+        const auto deadline = start + std::chrono::nanoseconds(static_cast<int64_t>(config.decision_budget_us * 1000.0));
+        const size_t cap = config.decision_max_beliefs > 0 ? static_cast<size_t>(config.decision_max_beliefs)
+                                                           : std::numeric_limits<size_t>::max();
+        const auto &active = belief_graph.active_beliefs();
+        const auto &activations = belief_graph.active_activations();
+        const size_t n = active.size();
+
+        // Activation and confidence order sort the active rows into kLevels buckets
+        // in one pass (no comparison sort), then visit the best bucket first. That pass
+        // may use half the deadline; rows it did not reach are left out. Index order
+        // walks outward from the winner's row and needs no pass at all.
+        const size_t origin = std::min(belief_graph.active_winner_row(), n > 0 ? n - 1 : 0);
+        bool truncated = false;
+        decision_levels.resize(kLevels);
+        for (auto &level : decision_levels)
+            level.clear();
+        if (decision_order != DecisionOrder::Index)
+        {
+            const bool by_confidence = decision_order == DecisionOrder::Confidence;
+            // Confidence is at most 1; no activation exceeds the winner's
+            const double top = by_confidence ? 1.0 : (n > 0 ? std::max<double>(activations[origin], 1e-12) : 1.0);
+            const auto scan_deadline = start + (deadline - start) / 2;
+            for (size_t row = 0; row < n; ++row)
+            {
+                if (timed && row > 0 && row % kScanStride == 0 && std::chrono::steady_clock::now() >= scan_deadline)
+                {
+                    truncated = true;
+                    break;
+                }
+                if (activations[row] <= 0.0)
+                    continue;
+                const double key = (by_confidence ? active[row]->confidence : activations[row]) / top;
+                const double below = std::clamp(1.0 - key, 0.0, 1.0);
+                decision_levels[std::min(kLevels - 1, static_cast<size_t>(below * kLevels))].push_back(row);
+            }
+        }
+        size_t step = 0;  // index order: origin, origin + 1, origin - 1, origin + 2, ...
+        size_t level = 0; // bucket order: position in decision_levels[level]
+        auto next_row = [&](size_t &row) -> bool
+        {
+            if (decision_order != DecisionOrder::Index)
+            {
+                while (level < kLevels && step == decision_levels[level].size())
+                {
+                    ++level;
+                    step = 0;
+                }
+                if (level == kLevels)
+                    return false;
+                row = decision_levels[level][step++];
+                return true;
+            }
+            while (step < 2 * n)
+            {
+                size_t offset = (step + 1) / 2;
+                bool above = (step % 2) == 1;
+                ++step;
+                if (above ? origin + offset < n : offset <= origin)
+                {
+                    row = above ? origin + offset : origin - offset;
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        belief_scores.assign(available_actions.size(), 0.0);
+        double seen = 0.0;
+        size_t visited = 0;
+        size_t probed = 0;
+        size_t row = 0;
+        while (next_row(row))
+        {
+            // The first belief is always scored, so a decision never rests on the bonuses alone
+            if (timed && visited > 0 && ++probed % kClockStride == 0 && std::chrono::steady_clock::now() >= deadline)
+            {
+                truncated = true;
+                break;
+            }
+            const Real activation = activations[row];
+            if (activation <= 0.0)
+                continue;
+            if (visited == cap)
+            {
+                truncated = true;
+                break;
+            }
+            for (size_t a = 0; a < available_actions.size(); ++a)
+                belief_scores[a] += activation * active[row]->predict_action_value(available_actions[a].id);
+            seen += activation;
+            visited++;
+        }
+        for (double &score : belief_scores)
+            score /= (seen + 1e-6);
+        total_activation = seen;
+
+        const double total = belief_graph.active_activation_total();
+        decision.visited = visited;
+        decision.population = n;
+        decision.coverage = total > 0.0 ? std::min(1.0, seen / total) : 1.0;
+        decision.truncated = truncated;
+        decision.micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void Agent::record_decision()
+    {
+        DecisionStats &s = decision_totals;
+        s.decisions++;
+        if (decision.truncated)
+            s.truncated++;
+        s.mean_coverage += (decision.coverage - s.mean_coverage) / static_cast<double>(s.decisions);
+        s.min_coverage = std::min(s.min_coverage, decision.coverage);
+        s.max_micros = std::max(s.max_micros, decision.micros);
+    }
+} // namespace dbea
@@ -0,0 +1,70 @@
+#include "dbea/FrozenAgent.h"
+#include "dbea/Agent.h"
+#include "dbea/FixedPatternSignature.h"
+#include <algorithm>
+#include <limits>
+
+namespace dbea
+{
+    namespace
+    {
+        std::shared_ptr<const PolicySnapshot> take_snapshot(const Agent &agent, double epsilon)
+        {
+            auto snap = std::make_shared<PolicySnapshot>();
+            agent.snapshot_policy(*snap);
+            if (epsilon >= 0.0)
+                snap->epsilon = epsilon;
+            return snap;
+        }
+    } // namespace
+
+    FrozenAgent::FrozenAgent(const Agent &agent, double epsilon)
+        : config(agent.get_config()),
+          snapshot(take_snapshot(agent, epsilon)),
+          visits(agent.copy_visit_counts()),
+          state_discretizer(config.novelty_resolution, static_cast<size_t>(std::max(0, config.novelty_dims)))
+    {
+    }
+
+    const Action &FrozenAgent::act(const PatternSignature &observation, std::mt19937 &rng) const
+    {
+        thread_local Episode scratch;
+        scratch.reset();
+        return act(observation, rng, scratch);
+    }
+
+    const Action &FrozenAgent::act(const PatternSignature &observation, std::mt19937 &rng, Episode &episode) const
+    {
+        // perceive(): blend with the previous perception
+        const size_t width = observation.features.size();
+        episode.blended.assign(observation.features.begin(), observation.features.end());
+        if (width > 0 && episode.last_perception.size() >= width)
+            pattern_kernels(width).blend(episode.blended.data(), episode.last_perception.data(), width);
+        episode.last_perception.assign(observation.features.begin(), observation.features.end());
+
+        // decide(), as SnapshotPolicy but with the visit count read instead of bumped
+        const PolicySnapshot &snap = *snapshot;
+        const PolicySnapshot::Partition *part =
+            snap.score(episode.blended.data(), width, episode.matches, episode.weights, episode.scores);
+        if (width >= 2)
+        {
+            uint32_t count = visits->count(state_discretizer.cell(episode.last_perception.data(), width));
+            // visit() would have counted this step too (and saturates the same way)
+            if (count < std::numeric_limits<uint32_t>::max())
+                count++;
+            snap.add_curiosity(episode.scores, config, state_discretizer, episode.last_perception, count);
+        }
+
+        std::uniform_real_distribution<double> epsilon_dist(0.0, 1.0);
+        if (epsilon_dist(rng) < snap.epsilon)
+        {
+            std::uniform_int_distribution<size_t> action_dist(0, snap.actions.size() - 1);
+            return snap.actions[action_dist(rng)];
+        }
+
+        snap.add_emotion_bias(episode.scores, config);
+        const size_t best = PolicySnapshot::best_action(episode.scores);
+        episode.predicted_value = snap.predicted_value(part, episode.weights, best);
+        return snap.actions[best];
+    }
+} // namespace dbea
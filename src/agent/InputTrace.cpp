@@ -0,0 +1,308 @@
+#include "dbea/InputTrace.h"
+#include "dbea/Agent.h"
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+namespace dbea
+{
+    namespace
+    {
+        constexpr uint32_t kTraceMagic = 0x54454244; // "DBET"
+        constexpr uint32_t kTraceVersion = 2; // 1: Decide without the predicted value
+    } // namespace
+
+    TraceWriter::TraceWriter(const std::string &path, const Config &cfg)
+        : out(path, std::ios::binary | std::ios::trunc)
+    {
+        if (!out.is_open())
+            throw std::runtime_error("Failed to open trace file: " + path);
+        std::string header = config_to_json(cfg).dump();
+        put(kTraceMagic);
+        put(kTraceVersion);
+        put(static_cast<uint32_t>(header.size()));
+        out.write(header.data(), static_cast<std::streamsize>(header.size()));
+    }
+
+    void TraceWriter::perceive(const PatternSignature &input)
+    {
+        tag(TraceEvent::Perceive);
+        put(static_cast<uint16_t>(input.features.size()));
+        for (Real f : input.features)
+            put(static_cast<double>(f));
+    }
+
+    void TraceWriter::decide(uint32_t action_id, double predicted_value)
+    {
+        tag(TraceEvent::Decide);
+        put(action_id);
+        put(predicted_value);
+    }
+
+    void TraceWriter::reward(double valence, double surprise)
+    {
+        tag(TraceEvent::Reward);
+        put(valence);
+        put(surprise);
+    }
+
+    void TraceWriter::learn()
+    {
+        tag(TraceEvent::Learn);
+    }
+
+    void TraceWriter::force_action(const std::string &name)
+    {
+        tag(TraceEvent::ForceAction);
+        put(static_cast<uint16_t>(name.size()));
+        out.write(name.data(), static_cast<std::streamsize>(name.size()));
+    }
+
+    void TraceWriter::set_emotion(const EmotionState &e)
+    {
+        tag(TraceEvent::SetEmotion);
+        for (Real v : {e.valence, e.arousal, e.dominance, e.curiosity, e.fear, e.explore_bias})
+            put(static_cast<double>(v));
+    }
+
+    void TraceWriter::therapy_mode(bool enabled)
+    {
+        tag(TraceEvent::TherapyMode);
+        put(static_cast<uint8_t>(enabled));
+    }
+
+    void TraceWriter::merge_threshold(double threshold)
+    {
+        tag(TraceEvent::MergeThreshold);
+        put(threshold);
+    }
+
+    void TraceWriter::prune(double threshold)
+    {
+        tag(TraceEvent::Prune);
+        put(threshold);
+    }
+
+    void TraceWriter::replay_learn(size_t batch_size)
+    {
+        tag(TraceEvent::ReplayLearn);
+        put(static_cast<uint32_t>(batch_size));
+    }
+
+    void TraceWriter::full_maintenance()
+    {
+        tag(TraceEvent::FullMaintenance);
+    }
+
+    void TraceWriter::load(const nlohmann::json &checkpoint)
+    {
+        std::vector<uint8_t> bytes = nlohmann::json::to_cbor(checkpoint);
+        tag(TraceEvent::Load);
+        put(static_cast<uint32_t>(bytes.size()));
+        out.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    void TraceWriter::apply_action(uint32_t action_id, double predicted_value)
+    {
+        tag(TraceEvent::ApplyAction);
+        put(action_id);
+        put(predicted_value);
+    }
+
+    TraceReader::TraceReader(const std::string &path) : in(path, std::ios::binary)
+    {
+        if (!in.is_open())
+            throw std::runtime_error("Failed to open trace file: " + path);
+        if (get<uint32_t>() != kTraceMagic)
+            throw std::runtime_error(path + " is not a DBEA trace");
+        version = get<uint32_t>();
+        if (version == 0 || version > kTraceVersion)
+            throw std::runtime_error("Unsupported trace version " + std::to_string(version) + " in " + path);
+        std::string header(get<uint32_t>(), '\0');
+        in.read(header.data(), static_cast<std::streamsize>(header.size()));
+        if (!in)
+            throw std::runtime_error("Truncated trace header in " + path);
+        apply_config_json(recorded, nlohmann::json::parse(header));
+    }
+
+    template <typename T>
+    T TraceReader::get()
+    {
+        T value{};
+        in.read(reinterpret_cast<char *>(&value), sizeof(T));
+        if (!in)
+            throw std::runtime_error("Truncated trace record " + std::to_string(count));
+        return value;
+    }
+
+    bool TraceReader::next(TraceRecord &rec)
+    {
+        int c = in.get();
+        if (c == std::char_traits<char>::eof())
+            return false;
+        rec.event = static_cast<TraceEvent>(c);
+        switch (rec.event)
+        {
+        case TraceEvent::Perceive:
+        {
+            uint16_t width = get<uint16_t>();
+            rec.features.resize(width);
+            for (auto &f : rec.features)
+                f = static_cast<Real>(get<double>());
+            break;
+        }
+        case TraceEvent::Decide:
+            rec.value = get<uint32_t>();
+            rec.has_prediction = version >= 2;
+            rec.a = rec.has_prediction ? get<double>() : 0.0;
+            break;
+        case TraceEvent::ReplayLearn:
+            rec.value = get<uint32_t>();
+            break;
+        case TraceEvent::Reward:
+            rec.a = get<double>();
+            rec.b = get<double>();
+            break;
+        case TraceEvent::Learn:
+        case TraceEvent::FullMaintenance:
+            break;
+        case TraceEvent::ForceAction:
+            rec.name.assign(get<uint16_t>(), '\0');
+            in.read(rec.name.data(), static_cast<std::streamsize>(rec.name.size()));
+            break;
+        case TraceEvent::SetEmotion:
+            for (Real *v : {&rec.emotion.valence, &rec.emotion.arousal, &rec.emotion.dominance,
+                            &rec.emotion.curiosity, &rec.emotion.fear, &rec.emotion.explore_bias})
+                *v = static_cast<Real>(get<double>());
+            break;
+        case TraceEvent::TherapyMode:
+            rec.value = get<uint8_t>();
+            break;
+        case TraceEvent::MergeThreshold:
+        case TraceEvent::Prune:
+            rec.a = get<double>();
+            break;
+        case TraceEvent::ApplyAction:
+            rec.value = get<uint32_t>();
+            rec.a = get<double>();
+            break;
+        case TraceEvent::Load:
+        {
+            std::vector<uint8_t> bytes(get<uint32_t>());
+            in.read(reinterpret_cast<char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+            rec.checkpoint = nlohmann::json::from_cbor(bytes);
+            break;
+        }
+        default:
+            throw std::runtime_error("Unknown trace record tag " + std::to_string(c) + " at record " + std::to_string(count));
+        }
+        if (!in)
+            throw std::runtime_error("Truncated trace record " + std::to_string(count));
+        count++;
+        return true;
+    }
+
+    namespace
+    {
+        std::unique_ptr<Agent> replay_into(const std::string &path, ReplayMode mode, ReplayResult &result)
+        {
+            TraceReader reader(path);
+            Config cfg = reader.config();
+            cfg.record_trace.clear();
+            cfg.verbose = false;
+            cfg.island_mode = false; // migrants are not part of the trace
+            if (mode == ReplayMode::Checked && cfg.maintenance_mode == "background")
+                std::cout << "[DBEA] Trace was recorded with background maintenance; decisions depend on thread timing\n";
+
+            auto replayed = std::make_unique<Agent>(cfg);
+            Agent &agent = *replayed;
+            TraceRecord rec;
+            PatternSignature input;
+            auto start = std::chrono::steady_clock::now();
+            while (reader.next(rec))
+            {
+                switch (rec.event)
+                {
+                case TraceEvent::Perceive:
+                    input.features.swap(rec.features);
+                    agent.perceive(input);
+                    break;
+                case TraceEvent::Decide:
+                    if (mode == ReplayMode::Checked)
+                    {
+                        Action chosen = agent.decide();
+                        if (chosen.id != rec.value)
+                        {
+                            if (result.first_divergence < 0)
+                                result.first_divergence = static_cast<int64_t>(result.decisions);
+                            result.divergences++;
+                            agent.force_action(rec.value); // keep learning on the recorded trajectory
+                        }
+                    }
+                    else if (rec.has_prediction)
+                        agent.apply_action(rec.value, rec.a);
+                    else
+                        agent.force_action(rec.value);
+                    result.decisions++;
+                    break;
+                case TraceEvent::Reward:
+                    agent.receive_reward(rec.a, rec.b);
+                    break;
+                case TraceEvent::Learn:
+                    agent.learn();
+                    result.steps++;
+                    break;
+                case TraceEvent::ForceAction:
+                    agent.force_action(rec.name);
+                    break;
+                case TraceEvent::SetEmotion:
+                    agent.set_emotion(rec.emotion);
+                    break;
+                case TraceEvent::TherapyMode:
+                    agent.set_therapy_mode(rec.value != 0);
+                    break;
+                case TraceEvent::MergeThreshold:
+                    agent.set_merge_threshold(rec.a);
+                    break;
+                case TraceEvent::Prune:
+                    agent.prune_beliefs(rec.a);
+                    break;
+                case TraceEvent::ReplayLearn:
+                    agent.learn_from_replay(rec.value);
+                    break;
+                case TraceEvent::FullMaintenance:
+                    agent.run_full_maintenance();
+                    break;
+                case TraceEvent::Load:
+                    agent.from_json(rec.checkpoint);
+                    break;
+                case TraceEvent::ApplyAction:
+                    agent.apply_action(rec.value, rec.a);
+                    break;
+                }
+            }
+            result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            result.records = reader.records_read();
+            result.beliefs = agent.get_belief_count();
+            return replayed;
+        }
+    } // namespace
+
+    ReplayResult replay_trace(const std::string &path, ReplayMode mode, const std::string &save_path)
+    {
+        ReplayResult result;
+        std::unique_ptr<Agent> agent = replay_into(path, mode, result);
+        if (!save_path.empty())
+            agent->save(save_path);
+        return result;
+    }
+
+    bool replay_modes_agree(const std::string &path)
+    {
+        ReplayResult checked, open_loop;
+        const nlohmann::json a = replay_into(path, ReplayMode::Checked, checked)->to_json();
+        const nlohmann::json b = replay_into(path, ReplayMode::OpenLoop, open_loop)->to_json();
+        return checked.divergences == 0 && a == b;
+    }
+} // namespace dbea
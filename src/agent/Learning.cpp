@@ -0,0 +1,141 @@
+#include "dbea/Agent.h"
+#include "dbea/InputTrace.h"
+#include <algorithm>
+#include <cmath>
+
+namespace dbea
+{
+    namespace
+    {
+        // Activation-weighted belief mixture for one perception, written as a normalised
+        // row over `nodes`. Only beliefs of the perception's width can match, so only
+        // their partition is scored; summing in slot order keeps the total identical
+        // to a scan over every belief.
+        void mixture_weights(const BeliefGraph &graph, const std::vector<std::pair<size_t, size_t>> &slots,
+                             const Real *features, size_t width, std::vector<Real> &matches, double *row,
+                             size_t num_nodes)
+        {
+            std::fill(row, row + num_nodes, 0.0);
+            if (slots.empty())
+                return;
+            graph.match_width(features, width, matches);
+            double total = 0.0;
+            for (const auto &[slot, r] : slots)
+            {
+                row[slot] = matches[r] * graph.nodes[slot]->confidence;
+                total += row[slot];
+            }
+            double inv = 1.0 / (total + 1e-6);
+            for (const auto &[slot, r] : slots)
+                row[slot] *= inv;
+        }
+    } // namespace
+
+    size_t Agent::learn_from_replay(size_t batch_size)
+    {
+        if (recorder)
+            recorder->replay_learn(batch_size);
+        return replay_update(batch_size);
+    }
+
+    size_t Agent::replay_update(size_t batch_size)
+    {
+        if (!replay || replay->size() == 0 || batch_size == 0 || belief_graph.nodes.empty())
+            return 0;
+
+        replay->sample(batch_size, config.replay_beta, replay_rng, replay_batch);
+        const auto &nodes = belief_graph.nodes;
+        const size_t B = replay_batch.indices.size();
+        const size_t N = nodes.size();
+        const size_t A = available_actions.size();
+
+        // Gather action values into a dense beliefs x actions matrix
+        replay_q.resize(N * A);
+        for (size_t k = 0; k < N; ++k)
+            for (size_t a = 0; a < A; ++a)
+                replay_q[k * A + a] = nodes[k]->predict_action_value(available_actions[a].id);
+
+        replay_weights.resize(B * N);
+        replay_next_weights.resize(B * N);
+        for (auto &[width, slots] : replay_width_slots)
+            slots.clear();
+        auto slots_of = [&](size_t width) -> const std::vector<std::pair<size_t, size_t>> &
+        {
+            auto &slots = replay_width_slots[width];
+            if (slots.empty())
+                belief_graph.width_slots(width, slots);
+            return slots;
+        };
+        for (size_t b = 0; b < B; ++b)
+        {
+            size_t idx = replay_batch.indices[b];
+            size_t width = replay->perception_width(idx);
+            mixture_weights(belief_graph, slots_of(width), replay->perception(idx), width, replay_matches,
+                            &replay_weights[b * N], N);
+            width = replay->next_perception_width(idx);
+            mixture_weights(belief_graph, slots_of(width), replay->next_perception(idx), width, replay_matches,
+                            &replay_next_weights[b * N], N);
+        }
+
+        // TD errors against the mixture Q(s,a) and bootstrapped max_a' Q(s',a'),
+        // accumulated into one delta matrix so every belief is written once
+        replay_delta.assign(N * A, 0.0);
+        size_t used = 0;
+        for (size_t b = 0; b < B; ++b)
+        {
+            size_t idx = replay_batch.indices[b];
+            size_t col = A;
+            for (size_t a = 0; a < A; ++a)
+            {
+                if (static_cast<int>(available_actions[a].id) == replay->action(idx))
+                {
+                    col = a;
+                    break;
+                }
+            }
+            if (col == A)
+                continue;
+
+            const double *w = &replay_weights[b * N];
+            const double *w_next = &replay_next_weights[b * N];
+            double q_sa = 0.0;
+            for (size_t k = 0; k < N; ++k)
+                q_sa += w[k] * replay_q[k * A + col];
+            double v_next = 0.0;
+            for (size_t a = 0; a < A; ++a)
+            {
+                double q = 0.0;
+                for (size_t k = 0; k < N; ++k)
+                    q += w_next[k] * replay_q[k * A + a];
+                v_next = std::max(v_next, q);
+            }
+
+            double td = replay->reward(idx) + config.gamma * v_next - q_sa;
+            if (!std::isfinite(td))
+                td = 0.0;
+            double step = config.replay_learning_rate * replay_batch.weights[b] * td;
+            for (size_t k = 0; k < N; ++k)
+                replay_delta[k * A + col] += step * w[k];
+            replay->update_priority(idx, td, config.replay_priority_eps);
+            used++;
+        }
+        if (used == 0)
+            return 0;
+
+        // Apply the batch-mean update in one pass; cloning shared beliefs keeps slots, so `nodes` stays aligned
+        belief_graph.own_all();
+        double inv_used = 1.0 / static_cast<double>(used);
+        for (size_t k = 0; k < N; ++k)
+        {
+            for (size_t a = 0; a < A; ++a)
+            {
+                double delta = replay_delta[k * A + a];
+                if (delta == 0.0)
+                    continue;
+                double val = std::clamp(replay_q[k * A + a] + delta * inv_used, -1.0, 5.0);
+                nodes[k]->action_values[available_actions[a].id] = val;
+            }
+        }
+        return used;
+    }
+} // namespace dbea
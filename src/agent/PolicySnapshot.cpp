@@ -0,0 +1,188 @@
+#include "dbea/PolicySnapshot.h"
+#include "dbea/Agent.h"
+#include "dbea/FixedPatternSignature.h"
+#include <algorithm>
+#include <cmath>
+
+namespace dbea
+{
+    namespace
+    {
+        int action_index(const std::vector<Action> &actions, uint32_t id)
+        {
+            for (size_t i = 0; i < actions.size(); ++i)
+            {
+                if (actions[i].id == id)
+                    return static_cast<int>(i);
+            }
+            return -1;
+        }
+    } // namespace
+
+    const PolicySnapshot::Partition *PolicySnapshot::partition_for(size_t width) const
+    {
+        for (const auto &part : partitions)
+        {
+            if (part.width == width)
+                return &part;
+        }
+        return nullptr;
+    }
+
+    void Agent::snapshot_policy(PolicySnapshot &out) const
+    {
+        out.actions = available_actions;
+        out.emotion = emotion;
+        out.epsilon = current_epsilon;
+        out.partitions.clear();
+        const size_t num_actions = available_actions.size();
+        // Cold beliefs are included: a snapshot never promotes, so it has to hold every
+        // belief compete() could bring back, as the live agent would score them
+        std::vector<std::shared_ptr<BeliefNode>> tiered;
+        if (belief_graph.cold_tier_state())
+            tiered = belief_graph.all_beliefs();
+        for (const auto &node : belief_graph.cold_tier_state() ? tiered : belief_graph.nodes)
+        {
+            const auto &features = node->prototype.features;
+            if (features.empty())
+                continue;
+            auto part = std::find_if(out.partitions.begin(), out.partitions.end(),
+                                     [&](const PolicySnapshot::Partition &p)
+                                     { return p.width == features.size(); });
+            if (part == out.partitions.end())
+            {
+                out.partitions.emplace_back();
+                part = out.partitions.end() - 1;
+                part->width = features.size();
+            }
+            part->prototypes.insert(part->prototypes.end(), features.begin(), features.end());
+            part->confidence.push_back(node->confidence);
+            for (size_t a = 0; a < num_actions; ++a)
+                part->q.push_back(node->predict_action_value(static_cast<int>(available_actions[a].id)));
+        }
+    }
+
+    SnapshotPolicy::SnapshotPolicy(const Config &cfg, uint64_t seed)
+        : config(cfg),
+          state_discretizer(cfg.novelty_resolution, static_cast<size_t>(std::max(0, cfg.novelty_dims))),
+          novelty(make_novelty_estimator(cfg)),
+          rng(static_cast<std::mt19937::result_type>(seed))
+    {
+    }
+
+    const PolicySnapshot::Partition *PolicySnapshot::score(const Real *input, size_t width, std::vector<Real> &matches,
+                                                           std::vector<double> &weights,
+                                                           std::vector<double> &scores) const
+    {
+        const size_t num_actions = actions.size();
+        const Partition *part = partition_for(width);
+        const size_t rows = part ? part->confidence.size() : 0;
+        matches.resize(rows);
+        if (rows > 0)
+            pattern_kernels(width).match_rows(input, part->prototypes.data(), rows, width, matches.data());
+        weights.assign(rows, 0.0);
+        double total_activation = 0.0;
+        for (size_t r = 0; r < rows; ++r)
+        {
+            weights[r] = matches[r] * part->confidence[r];
+            total_activation += weights[r];
+        }
+        for (auto &w : weights)
+            w /= (total_activation + 1e-6);
+
+        scores.assign(num_actions, 0.0);
+        for (size_t r = 0; r < rows; ++r)
+        {
+            for (size_t a = 0; a < num_actions; ++a)
+                scores[a] += weights[r] * part->q[r * num_actions + a];
+        }
+        return part;
+    }
+
+    void PolicySnapshot::add_curiosity(std::vector<double> &scores, const Config &config,
+                                       const StateDiscretizer &states, const std::vector<Real> &perception,
+                                       uint32_t visits) const
+    {
+        auto bump = [&](uint32_t id, double amount)
+        {
+            int a = action_index(actions, id);
+            if (a >= 0)
+                scores[a] += amount;
+        };
+        int64_t grid_x = states.bin(perception[0]);
+        int64_t grid_y = states.bin(perception[1]);
+        double visit_inverse = 1.0 / (1.0 + visits * 0.08);
+        double curiosity_bonus = config.curiosity_boost * 0.7 * visit_inverse;
+        int far_bin = states.resolution() * 2 / 5;
+        if (grid_x >= far_bin && grid_y >= far_bin)
+            curiosity_bonus *= 3.6;
+        bump(1, curiosity_bonus * 1.2); // down
+        bump(3, curiosity_bonus * 1.4); // right
+    }
+
+    void PolicySnapshot::add_emotion_bias(std::vector<double> &scores, const Config &config) const
+    {
+        auto bump = [&](uint32_t id, double amount)
+        {
+            int a = action_index(actions, id);
+            if (a >= 0)
+                scores[a] += amount;
+        };
+        double emotional_bonus = emotion.explore_bias * config.explore_bias_scale;
+        double fear_penalty = emotion.fear * 0.40;
+        bump(3, emotional_bonus);
+        bump(0, -emotional_bonus * 0.7);
+        bump(1, -fear_penalty);
+    }
+
+    size_t PolicySnapshot::best_action(const std::vector<double> &scores)
+    {
+        size_t best = 0;
+        for (size_t a = 1; a < scores.size(); ++a)
+        {
+            if (scores[a] > scores[best])
+                best = a;
+        }
+        return best;
+    }
+
+    double PolicySnapshot::predicted_value(const Partition *part, const std::vector<double> &weights,
+                                           size_t action) const
+    {
+        const size_t num_actions = actions.size();
+        double value = 0.0;
+        for (size_t r = 0; r < weights.size(); ++r)
+            value += weights[r] * part->q[r * num_actions + action];
+        return value;
+    }
+
+    const Action &SnapshotPolicy::decide(const PolicySnapshot &snapshot, const PatternSignature &input)
+    {
+        // perceive(): blend with the previous perception, then compete
+        const size_t width = input.features.size();
+        blended.assign(input.features.begin(), input.features.end());
+        if (width > 0 && last_perception.size() >= width)
+            pattern_kernels(width).blend(blended.data(), last_perception.data(), width);
+        last_perception.assign(input.features.begin(), input.features.end());
+
+        // decide(): the scoring of Agent::select_action
+        const PolicySnapshot::Partition *part = snapshot.score(blended.data(), width, matches, weights, scores);
+        if (width >= 2)
+        {
+            uint32_t visits = novelty->visit(state_discretizer.cell(last_perception.data(), width));
+            snapshot.add_curiosity(scores, config, state_discretizer, last_perception, visits);
+        }
+
+        std::uniform_real_distribution<double> epsilon_dist(0.0, 1.0);
+        if (epsilon_dist(rng) < snapshot.epsilon)
+        {
+            std::uniform_int_distribution<size_t> action_dist(0, snapshot.actions.size() - 1);
+            return snapshot.actions[action_dist(rng)];
+        }
+
+        snapshot.add_emotion_bias(scores, config);
+        const size_t best = PolicySnapshot::best_action(scores);
+        last_predicted = snapshot.predicted_value(part, weights, best);
+        return snapshot.actions[best];
+    }
+} // namespace dbea
@@ -0,0 +1,108 @@
+#include "dbea/ReplayBuffer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace dbea
+{
+    SumTree::SumTree(size_t capacity) : leaf_capacity(capacity), leaves(1)
+    {
+        while (leaves < capacity)
+            leaves <<= 1;
+        tree.assign(2 * leaves, 0.0);
+    }
+
+    void SumTree::update(size_t leaf, double priority)
+    {
+        size_t node = leaves + leaf;
+        double delta = priority - tree[node];
+        for (; node >= 1; node >>= 1)
+            tree[node] += delta;
+    }
+
+    size_t SumTree::find(double mass) const
+    {
+        size_t node = 1;
+        while (node < leaves)
+        {
+            size_t left = 2 * node;
+            if (mass < tree[left])
+                node = left;
+            else
+            {
+                mass -= tree[left];
+                node = left + 1;
+            }
+        }
+        // Rounding can walk past the last filled leaf; clamp back into range
+        return std::min(node - leaves, leaf_capacity - 1);
+    }
+
+    ReplayBuffer::ReplayBuffer(size_t capacity, size_t max_features, double alpha_)
+        : slots(std::max<size_t>(1, capacity)),
+          stride(max_features),
+          alpha(alpha_),
+          perceptions(slots * stride, 0.0),
+          next_perceptions(slots * stride, 0.0),
+          widths(slots, 0),
+          next_widths(slots, 0),
+          actions(slots, 0),
+          rewards(slots, 0.0),
+          priorities(slots)
+    {
+    }
+
+    bool ReplayBuffer::push(const PatternSignature &perception, int action, double reward,
+                            const PatternSignature &next_perception)
+    {
+        if (perception.features.size() > stride || next_perception.features.size() > stride)
+            return false;
+
+        size_t i = head;
+        std::copy(perception.features.begin(), perception.features.end(), perceptions.begin() + i * stride);
+        std::copy(next_perception.features.begin(), next_perception.features.end(), next_perceptions.begin() + i * stride);
+        widths[i] = static_cast<uint32_t>(perception.features.size());
+        next_widths[i] = static_cast<uint32_t>(next_perception.features.size());
+        actions[i] = action;
+        rewards[i] = reward;
+
+        // New transitions get the highest priority seen so far so each is replayed at least once
+        priorities.update(i, std::pow(max_priority, alpha));
+
+        head = (head + 1) % slots;
+        count = std::min(count + 1, slots);
+        return true;
+    }
+
+    void ReplayBuffer::sample(size_t batch_size, double beta, std::mt19937 &rng, ReplayBatch &out) const
+    {
+        out.indices.clear();
+        out.weights.clear();
+        double total = priorities.total();
+        if (count == 0 || total <= 0.0)
+            return;
+
+        // Stratified sampling: one draw per equal-mass segment
+        double segment = total / static_cast<double>(batch_size);
+        std::uniform_real_distribution<double> uni(0.0, 1.0);
+        double max_weight = 0.0;
+        for (size_t b = 0; b < batch_size; ++b)
+        {
+            double mass = (static_cast<double>(b) + uni(rng)) * segment;
+            size_t idx = std::min(priorities.find(mass), count - 1);
+            double prob = priorities.priority(idx) / total;
+            double weight = std::pow(static_cast<double>(count) * std::max(prob, 1e-12), -beta);
+            out.indices.push_back(idx);
+            out.weights.push_back(weight);
+            max_weight = std::max(max_weight, weight);
+        }
+        for (auto &w : out.weights)
+            w /= max_weight;
+    }
+
+    void ReplayBuffer::update_priority(size_t index, double td_error, double epsilon)
+    {
+        double p = std::abs(td_error) + epsilon;
+        max_priority = std::max(max_priority, p);
+        priorities.update(index, std::pow(p, alpha));
+    }
+} // namespace dbea
@@ -0,0 +1,281 @@
+#include "dbea/BackgroundMaintenance.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <unordered_set>
+
+namespace dbea
+{
+    namespace
+    {
+        Config worker_config_for(const Config &cfg)
+        {
+            Config worker = cfg;
+            worker.maintenance_mode = "inline";
+            return worker;
+        }
+
+        double elapsed_ms(std::chrono::steady_clock::time_point since)
+        {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since).count();
+        }
+    } // namespace
+
+    // Adds what `live` learned since `base` onto `target`, the worker's copy of the same belief
+    void BackgroundMaintenance::replay_learning(BeliefNode &target, const BeliefNode &live, const Baseline &base) const
+    {
+        const auto *values = baseline_values.data() + base.values_begin;
+        for (const auto &[action, value] : live.action_values)
+        {
+            Real before = 0.0;
+            for (size_t k = 0; k < base.values_count; ++k)
+            {
+                if (values[k].first == action)
+                {
+                    before = values[k].second;
+                    break;
+                }
+            }
+            target.action_values[action] += value - before;
+        }
+        target.confidence = std::clamp<Real>(target.confidence + (live.confidence - base.confidence), 0.0, 1.0);
+        target.fitness = std::max<Real>(0.0, target.fitness + (live.fitness - base.fitness));
+        target.evidence_count += live.evidence_count - base.evidence_count;
+        // Running state rather than accumulators: the live value is the current one
+        target.prediction_error = live.prediction_error;
+        target.last_predicted_reward = live.last_predicted_reward;
+        target.last_active_step = std::max(target.last_active_step, live.last_active_step);
+    }
+
+    BackgroundMaintenance::BackgroundMaintenance(const Config &cfg)
+        : worker_config(worker_config_for(cfg)), worker_graph(worker_config)
+    {
+        worker_graph.log_merges = !cfg.telemetry_shm.empty();
+        worker = std::thread(&BackgroundMaintenance::run, this);
+    }
+
+    BackgroundMaintenance::~BackgroundMaintenance()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
+
+    bool BackgroundMaintenance::submit(BeliefGraph &graph, const Request &req)
+    {
+        if (in_flight)
+            return false;
+
+        // Shared, not copied: the acting thread clones a belief before writing to it
+        // while the worker still holds it, and the worker clones its own generation
+        auto start = std::chrono::steady_clock::now();
+        graph.share_all();
+        baseline.clear();
+        baseline_ids.clear();
+        baseline_values.clear();
+        for (const auto &node : graph.nodes)
+        {
+            Baseline base;
+            base.id_begin = baseline_ids.size();
+            base.id_length = node->id.size();
+            base.values_begin = baseline_values.size();
+            base.values_count = node->action_values.size();
+            base.confidence = node->confidence;
+            base.fitness = node->fitness;
+            base.evidence_count = node->evidence_count;
+            baseline_ids += node->id;
+            baseline_values.insert(baseline_values.end(), node->action_values.begin(), node->action_values.end());
+            baseline.push_back(base);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            request = req;
+            job_nodes = graph.nodes;
+            worker_graph.share_id_counter(graph);
+            // Only parasite scoring reads co-activations, and it is a no-op without uplift
+            if (req.evolve && worker_config.symbiotic_uplift != 0.0)
+                job_co_activations = graph.share_co_activations();
+            state = State::Submitted;
+        }
+        wake.notify_one();
+        in_flight = true;
+        stale = false;
+        counters.submitted++;
+        counters.last_submit_ms = elapsed_ms(start);
+        return true;
+    }
+
+    bool BackgroundMaintenance::try_install(BeliefGraph &graph)
+    {
+        if (!in_flight || !ready.load(std::memory_order_acquire))
+            return false;
+        install(graph);
+        return true;
+    }
+
+    void BackgroundMaintenance::wait_and_install(BeliefGraph &graph)
+    {
+        if (!in_flight)
+            return;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            done.wait(lock, [this]
+                      { return state == State::Ready; });
+        }
+        install(graph);
+    }
+
+    void BackgroundMaintenance::discard()
+    {
+        stale = true;
+    }
+
+    void BackgroundMaintenance::install(BeliefGraph &graph)
+    {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::shared_ptr<BeliefNode>> next;
+        std::vector<std::pair<std::string, std::string>> merges;
+        std::vector<std::pair<std::string, bool>> lives;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            next = std::move(result);
+            merges = std::move(result_merges);
+            lives = std::move(result_lives);
+            result.clear();
+            result_merges.clear();
+            result_lives.clear();
+            counters.last_worker_ms = worker_ms;
+            state = State::Idle;
+            ready.store(false, std::memory_order_relaxed);
+        }
+        in_flight = false;
+        if (stale)
+        {
+            counters.discarded++;
+            baseline.clear();
+            return;
+        }
+
+        std::unordered_map<std::string, BeliefNode *> by_id;
+        by_id.reserve(next.size());
+        for (const auto &node : next)
+            by_id[node->id] = node.get();
+
+        std::unordered_map<std::string_view, const Baseline *> base_by_id;
+        base_by_id.reserve(baseline.size());
+        for (const Baseline &base : baseline)
+            base_by_id.emplace(std::string_view(baseline_ids).substr(base.id_begin, base.id_length), &base);
+
+        std::unordered_set<std::string_view> live_ids;
+        live_ids.reserve(graph.nodes.size());
+        for (const auto &live : graph.nodes)
+        {
+            live_ids.insert(live->id);
+            auto base = base_by_id.find(live->id);
+            if (base == base_by_id.end())
+            {
+                next.push_back(live); // created after the copy was taken
+                continue;
+            }
+            auto target = by_id.find(live->id);
+            if (target != by_id.end())
+                replay_learning(*target->second, *live, *base->second);
+        }
+        // Removed on the acting side since the copy (threshold prune, capacity eviction)
+        next.erase(std::remove_if(next.begin(), next.end(),
+                                  [&](const std::shared_ptr<BeliefNode> &n)
+                                  { return base_by_id.count(n->id) && !live_ids.count(n->id); }),
+                   next.end());
+
+        if (graph.log_merges)
+        {
+            // Beliefs already gone on the acting side were logged there
+            for (const auto &[id, born] : lives)
+            {
+                if ((born || live_ids.count(id)) && graph.life_log.size() < 4096)
+                    graph.life_log.emplace_back(id, born);
+            }
+        }
+
+        // Keep the proto-belief at the front, where the agent looks for it
+        auto proto = std::find_if(next.begin(), next.end(), [](const auto &n)
+                                  { return n->id == "proto-belief"; });
+        if (proto != next.end() && proto != next.begin())
+            std::rotate(next.begin(), proto, proto + 1);
+
+        graph.replace_nodes(std::move(next));
+        if (graph.log_merges)
+            graph.merge_log.insert(graph.merge_log.end(), merges.begin(), merges.end());
+        baseline.clear();
+        counters.installed++;
+        counters.last_install_ms = elapsed_ms(start);
+        if (worker_config.verbose)
+            std::cout << "[NDBE] Installed belief generation " << counters.installed << " | Pop: " << graph.nodes.size()
+                      << " | Submit: " << counters.last_submit_ms << " ms | Worker: " << counters.last_worker_ms
+                      << " ms | Swap: " << counters.last_install_ms << " ms\n";
+    }
+
+    void BackgroundMaintenance::run()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;)
+        {
+            wake.wait(lock, [this]
+                      { return stopping || state == State::Submitted; });
+            if (stopping)
+                return;
+            Request req = request;
+            std::vector<std::shared_ptr<BeliefNode>> shared = std::move(job_nodes);
+            std::shared_ptr<const BeliefGraph::CoActivations> co_activations = std::move(job_co_activations);
+            job_nodes.clear();
+            job_co_activations.reset();
+            lock.unlock();
+
+            // The worker's own generation; dropping each shared belief once it is cloned
+            // lets the acting thread take it back without a copy
+            auto start = std::chrono::steady_clock::now();
+            std::vector<std::shared_ptr<BeliefNode>> nodes;
+            nodes.reserve(shared.size());
+            for (auto &node : shared)
+            {
+                nodes.push_back(std::make_shared<BeliefNode>(*node));
+                nodes.back()->shared = false;
+                node.reset();
+            }
+            shared.clear();
+            if (co_activations)
+            {
+                worker_graph.mutable_co_activations() = *co_activations;
+                co_activations.reset();
+            }
+
+            // Same passes, in the same order, as inline maintenance in Agent::learn
+            worker_graph.replace_nodes(std::move(nodes));
+            worker_graph.merge_beliefs(req.merge_threshold);
+            worker_graph.prune(req.prune_threshold);
+            if (req.evolve)
+                worker_graph.evolve_cycle(req.emotion);
+            std::vector<std::shared_ptr<BeliefNode>> restructured = std::move(worker_graph.nodes);
+            std::vector<std::pair<std::string, std::string>> merges = std::move(worker_graph.merge_log);
+            std::vector<std::pair<std::string, bool>> lives = std::move(worker_graph.life_log);
+            worker_graph.merge_log.clear();
+            worker_graph.life_log.clear();
+            worker_graph.clear();
+            worker_graph.mutable_co_activations().clear();
+            double ms = elapsed_ms(start);
+
+            lock.lock();
+            result = std::move(restructured);
+            result_merges = std::move(merges);
+            result_lives = std::move(lives);
+            worker_ms = ms;
+            state = State::Ready;
+            ready.store(true, std::memory_order_release);
+            done.notify_all();
+        }
+    }
+} // namespace dbea
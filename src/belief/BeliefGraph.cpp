@@ -1,34 +1,859 @@
 #include "dbea/BeliefGraph.h"
+#include "dbea/FixedPatternSignature.h"
 #include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <limits>
+#include <map>
 #include <memory>
 #include <random>
 #include <cmath>
+#include <stdexcept>
+#include <unordered_set>
 
 namespace dbea
 {
-    static int NEXT_BELIEF_ID = 0;
+    // Budgeted maintenance costs, in MaintenanceScheduler ops (one op ~ one prototype comparison)
+    static constexpr size_t kEraseOps = 8;
+
+    // Evidence-weighted fusion of `other` into `keeper` (merge_beliefs)
+    static void absorb_belief(BeliefNode &keeper, const BeliefNode &other)
+    {
+        int total_evidence = keeper.evidence_count + other.evidence_count;
+        for (size_t k = 0; k < keeper.prototype.features.size(); ++k)
+        {
+            keeper.prototype.features[k] =
+                (keeper.prototype.features[k] * keeper.evidence_count +
+                 other.prototype.features[k] * other.evidence_count) /
+                total_evidence;
+        }
+        keeper.confidence =
+            (keeper.confidence * keeper.evidence_count +
+             other.confidence * other.evidence_count) /
+            total_evidence;
+        for (const auto &[action_id, value] : other.action_values)
+        {
+            Real old_val = keeper.action_values[action_id];
+            keeper.action_values[action_id] = old_val * 0.9 + value * 0.1;
+        }
+        keeper.evidence_count = total_evidence;
+    }
+
+    // Mean of the positive fitness values, 1.0 when there are none
+    static double positive_mean_fitness(const std::vector<std::shared_ptr<BeliefNode>> &pop)
+    {
+        double total_fitness = 0.0;
+        size_t valid_count = 0;
+        for (const auto &node : pop)
+        {
+            if (node->fitness > 0.0)
+            {
+                total_fitness += node->fitness;
+                valid_count++;
+            }
+        }
+        return (valid_count > 0) ? total_fitness / valid_count : 1.0;
+    }
+
+    BeliefGraph::BeliefGraph(const Config &cfg)
+        : config(cfg), id_counter(std::make_shared<std::atomic<uint64_t>>(0)),
+          co_activation_counts(std::make_shared<CoActivations>()),
+          evo_rng(cfg.seed ? static_cast<std::mt19937::result_type>(cfg.seed * 0x9E3779B97F4A7C15ull >> 32)
+                           : std::random_device{}())
+    {
+        if (config.quantized_screening)
+            quantized = std::make_unique<QuantizedPrototypeStore>();
+        if (config.compete_cache_entries > 0)
+            compete_cache = std::make_unique<CompeteCache>(static_cast<size_t>(config.compete_cache_entries),
+                                                           config.compete_cache_resolution,
+                                                           config.compete_cache_tolerance);
+
+        if (config.retention_score == "confidence")
+            retention_kind = Retention::Confidence;
+        else if (config.retention_score == "fitness")
+            retention_kind = Retention::Fitness;
+        else if (config.retention_score == "recency")
+            retention_kind = Retention::Recency;
+        else
+            throw std::runtime_error("Unknown retention score: " + config.retention_score);
+
+        if (config.maintenance_mode == "budgeted")
+            maintenance = std::make_unique<MaintenanceScheduler>(
+                static_cast<size_t>(std::max(1, config.maintenance_budget_ops)), config.maintenance_budget_us);
+        else if (config.maintenance_mode != "inline" && config.maintenance_mode != "background")
+            throw std::runtime_error("Unknown maintenance mode: " + config.maintenance_mode);
+
+        if (config.cold_tier_window > 0)
+        {
+            // A background generation would bring back beliefs demoted while it was in flight
+            if (config.maintenance_mode == "background")
+                throw std::runtime_error("The cold tier needs inline or budgeted maintenance");
+            cold = std::make_unique<ColdBeliefStore>(config.cold_tier_resolution);
+        }
+    }
+
+    std::string BeliefGraph::new_belief_id()
+    {
+        return "belief_" + std::to_string(id_counter->fetch_add(1, std::memory_order_relaxed));
+    }
 
     void BeliefGraph::add_belief(const std::shared_ptr<BeliefNode> &node)
     {
+        note_life(*node, true);
+        insert_belief(node);
+    }
+
+    void BeliefGraph::insert_belief(const std::shared_ptr<BeliefNode> &node)
+    {
+        sync_index();
+        make_room(1);
+        node->last_active_step = compete_clock; // a new belief counts as just seen
         nodes.push_back(node);
+        on_insert(node);
+    }
+
+    BeliefGraph::CoActivations &BeliefGraph::mutable_co_activations()
+    {
+        // A map still referenced by a fork is copied before the first write
+        if (co_activation_counts.use_count() > 1)
+            co_activation_counts = std::make_shared<CoActivations>(*co_activation_counts);
+        else // pairs with the release of the last other reference, possibly on the maintenance worker
+            std::atomic_thread_fence(std::memory_order_acquire);
+        return *co_activation_counts;
+    }
+
+    void BeliefGraph::share_from(BeliefGraph &source)
+    {
+        source.sync_index();
+        source.share_all();
+        nodes = source.nodes;
+        co_activation_counts = source.co_activation_counts;
+        // Rows are copied rather than rebuilt, so the fork scores beliefs in the source's order
+        partitions = source.partitions;
+        partition_row = source.partition_row;
+        active_width = source.active_width;
+        empty_prototypes = source.empty_prototypes;
+        compete_clock = source.compete_clock;
+        id_counter = std::make_shared<std::atomic<uint64_t>>(source.next_belief_id());
+        for (auto &[width, part] : partitions)
+        {
+            std::fill(part.activations.begin(), part.activations.end(), Real(0.0));
+            // The fork starts its idle windows afresh
+            if (cold)
+                part.hot_steps.assign(part.members.size(), compete_clock);
+            else
+                part.hot_steps.clear();
+        }
+        active_total = 0.0;
+        active_winner = nullptr;
+        evolution_job = EvolutionJob{};
+        rebuild_secondary();
+        make_room(0);
+        if (source.cold && cold)
+            *cold = *source.cold;
+        else if (source.cold)
+        {
+            // No cold tier here: the source's cold beliefs come back as ordinary ones
+            for (const auto &node : source.cold->snapshot())
+                add_belief(node);
+        }
+    }
+
+    size_t BeliefGraph::share_all()
+    {
+        // Nothing is written once every belief is shared, so concurrent forks of a
+        // fully shared graph are safe
+        size_t marked = 0;
+        for (const auto &node : nodes)
+        {
+            if (!node->shared)
+            {
+                node->shared = true;
+                marked++;
+            }
+        }
+        if (marked > 0)
+            shared_nodes += marked;
+        return marked;
+    }
+
+    BeliefNode &BeliefGraph::own(BeliefNode *node)
+    {
+        if (!node->shared)
+            return *node;
+        return *own_slot(node_slot.at(node));
+    }
+
+    void BeliefGraph::own_all()
+    {
+        if (shared_nodes == 0)
+            return;
+        sync_index();
+        for (size_t slot = 0; slot < nodes.size() && shared_nodes > 0; ++slot)
+            own_slot(slot);
+    }
+
+    const std::shared_ptr<BeliefNode> &BeliefGraph::own_slot(size_t slot)
+    {
+        std::shared_ptr<BeliefNode> &node = nodes[slot];
+        if (!node->shared)
+            return node;
+        shared_nodes--;
+        if (node.use_count() == 1)
+        {
+            // Every graph it was shared with has dropped it; take it back without a copy.
+            // The fence pairs with that release, which may come from the maintenance worker.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            node->shared = false;
+            return node;
+        }
+        std::shared_ptr<BeliefNode> base = std::move(node);
+        node = std::make_shared<BeliefNode>(*base);
+        node->shared = false;
+        repoint(base.get(), node);
+        return node;
+    }
+
+    void BeliefGraph::repoint(const BeliefNode *old, const std::shared_ptr<BeliefNode> &now)
+    {
+        auto slot = node_slot.find(old);
+        if (slot != node_slot.end())
+        {
+            node_slot.emplace(now.get(), slot->second);
+            node_slot.erase(slot);
+        }
+        auto row = partition_row.find(old);
+        if (row != partition_row.end())
+        {
+            partitions.find(now->prototype.features.size())->second.members[row->second] = now.get();
+            partition_row.emplace(now.get(), row->second);
+            partition_row.erase(row);
+        }
+        if (active_winner == old)
+            active_winner = now.get();
+        retention.replace(old, now.get());
+        if (quantized)
+            quantized->replace(old, now.get());
+        if (compete_cache)
+            compete_cache->replace(old, now.get());
+        if (maintenance)
+        {
+            confidence_index.replace(old, now.get());
+            maintenance->replace(old, now.get());
+        }
+        if (evolution_job.pending)
+        {
+            for (auto *list : {&evolution_job.pop, &evolution_job.survivors})
+            {
+                for (auto &entry : *list)
+                {
+                    if (entry.get() == old)
+                        entry = now;
+                }
+            }
+        }
+    }
+
+    double BeliefGraph::retention_key(const BeliefNode &node) const
+    {
+        if (node.id == "proto-belief")
+            return std::numeric_limits<double>::infinity();
+        switch (retention_kind)
+        {
+        case Retention::Fitness:
+            return node.fitness;
+        case Retention::Recency:
+            return static_cast<double>(node.last_active_step);
+        default:
+            return node.confidence;
+        }
+    }
+
+    void BeliefGraph::touch(BeliefNode *node)
+    {
+        if (capacity_enforced() && retention.contains(node))
+            retention.update(node, retention_key(*node));
+        if (maintenance && confidence_index.contains(node))
+            confidence_index.update(node, node->confidence);
+        if (compete_cache)
+            compete_cache->note_confidence(node);
+    }
+
+    void BeliefGraph::make_room(size_t incoming)
+    {
+        if (!capacity_enforced())
+            return;
+        const size_t cap = static_cast<size_t>(config.max_beliefs);
+        while (nodes.size() + incoming > cap && !retention.empty() && std::isfinite(retention.top_key()))
+        {
+            BeliefNode *weakest = retention.top();
+            if (config.verbose)
+                std::cout << "[DBEA] Evicted belief at capacity: " << weakest->id
+                          << " (retention=" << retention.top_key() << ")\n";
+            note_life(*weakest, false);
+            erase_node(weakest);
+        }
+    }
+
+    void BeliefGraph::clear()
+    {
+        nodes.clear();
+        if (cold)
+            cold->clear();
+        evolution_job = EvolutionJob{};
+        reindex();
+    }
+
+    void BeliefGraph::replace_nodes(std::vector<std::shared_ptr<BeliefNode>> next)
+    {
+        nodes = std::move(next);
+        evolution_job = EvolutionJob{};
+        reindex();
+        make_room(0);
+    }
+
+    void BeliefGraph::on_insert(const std::shared_ptr<BeliefNode> &node)
+    {
+        const auto &features = node->prototype.features;
+        if (features.empty())
+            empty_prototypes++;
+        else
+        {
+            Partition &part = partitions[features.size()];
+            if (!part.kernels)
+            {
+                part.width = features.size();
+                part.kernels = &pattern_kernels(part.width);
+            }
+            partition_row[node.get()] = part.members.size();
+            part.members.push_back(node.get());
+            part.prototypes.insert(part.prototypes.end(), features.begin(), features.end());
+            part.activations.push_back(0.0);
+            if (cold)
+                part.hot_steps.push_back(compete_clock); // a new belief counts as just activated
+        }
+        node_slot[node.get()] = nodes.size() - 1;
+        if (node->shared)
+            shared_nodes++;
+        if (capacity_enforced())
+            retention.push(node.get(), retention_key(*node));
+        if (quantized)
+            quantized->upsert(node.get());
+        if (compete_cache)
+        {
+            compete_cache->track(node.get());
+            compete_cache->invalidate();
+        }
+        if (maintenance)
+        {
+            confidence_index.push(node.get(), node->confidence);
+            maintenance->mark_dirty(node.get());
+        }
+    }
+
+    void BeliefGraph::on_erase(const BeliefNode *node)
+    {
+        auto it = partition_row.find(node);
+        if (it != partition_row.end())
+        {
+            Partition &part = partitions[node->prototype.features.size()];
+            const size_t w = part.width;
+            size_t row = it->second;
+            size_t last = part.members.size() - 1;
+            if (w == active_width)
+                active_total -= part.activations[row];
+            if (row != last)
+            {
+                // Swap-remove keeps the partition dense
+                part.members[row] = part.members[last];
+                std::copy(part.prototypes.begin() + last * w, part.prototypes.begin() + (last + 1) * w,
+                          part.prototypes.begin() + row * w);
+                part.activations[row] = part.activations[last];
+                if (cold)
+                    part.hot_steps[row] = part.hot_steps[last];
+                partition_row[part.members[row]] = row;
+            }
+            part.members.pop_back();
+            part.prototypes.resize(part.members.size() * w);
+            part.activations.pop_back();
+            if (cold)
+                part.hot_steps.pop_back();
+            partition_row.erase(it);
+        }
+        else if (node->prototype.features.empty() && empty_prototypes > 0)
+            empty_prototypes--;
+        if (node->shared && shared_nodes > 0)
+            shared_nodes--;
+        if (node == active_winner)
+            active_winner = nullptr;
+        retention.erase(node);
+        if (quantized)
+            quantized->erase(node);
+        if (compete_cache)
+        {
+            compete_cache->forget(node);
+            compete_cache->invalidate();
+        }
+        if (maintenance)
+        {
+            confidence_index.erase(node);
+            maintenance->forget(node);
+        }
+    }
+
+    void BeliefGraph::on_prototype_changed(BeliefNode *node)
+    {
+        auto it = partition_row.find(node);
+        if (it != partition_row.end())
+        {
+            Partition &part = partitions[node->prototype.features.size()];
+            std::copy(node->prototype.features.begin(), node->prototype.features.end(),
+                      part.prototypes.begin() + it->second * part.width);
+        }
+        if (quantized)
+            quantized->upsert(node);
+        if (compete_cache)
+            compete_cache->invalidate();
+        if (maintenance)
+            maintenance->mark_dirty(node);
+    }
+
+    void BeliefGraph::reindex()
+    {
+        // Rows are rebuilt in `nodes` order; activations of surviving beliefs carry over
+        std::unordered_map<const BeliefNode *, Real> carried;
+        if (Partition *active = partition_for(active_width))
+        {
+            for (size_t row = 0; row < active->members.size(); ++row)
+                carried.emplace(active->members[row], active->activations[row]);
+        }
+        std::unordered_map<const BeliefNode *, uint64_t> carried_hot;
+        for (auto &[width, part] : partitions)
+        {
+            for (size_t row = 0; row < part.hot_steps.size(); ++row)
+                carried_hot.emplace(part.members[row], part.hot_steps[row]);
+            part.members.clear();
+            part.prototypes.clear();
+            part.activations.clear();
+            part.hot_steps.clear();
+        }
+        partition_row.clear();
+        empty_prototypes = 0;
+        for (const auto &node : nodes)
+        {
+            const auto &features = node->prototype.features;
+            if (features.empty())
+            {
+                empty_prototypes++;
+                continue;
+            }
+            Partition &part = partitions[features.size()];
+            if (!part.kernels)
+            {
+                part.width = features.size();
+                part.kernels = &pattern_kernels(part.width);
+            }
+            partition_row[node.get()] = part.members.size();
+            part.members.push_back(node.get());
+            part.prototypes.insert(part.prototypes.end(), features.begin(), features.end());
+            auto kept = carried.find(node.get());
+            part.activations.push_back(kept == carried.end() ? Real(0.0) : kept->second);
+            if (cold)
+            {
+                auto hot = carried_hot.find(node.get());
+                part.hot_steps.push_back(hot == carried_hot.end() ? compete_clock : hot->second);
+            }
+        }
+        active_total = 0.0;
+        for (const auto &[node, activation] : carried)
+        {
+            if (partition_row.count(node))
+                active_total += activation;
+            else if (node == active_winner)
+                active_winner = nullptr;
+        }
+        rebuild_secondary();
+    }
+
+    void BeliefGraph::rebuild_secondary()
+    {
+        rebuild_slots();
+        if (quantized)
+            quantized->rebuild(nodes);
+        if (compete_cache)
+            compete_cache->rebuild(nodes);
+        if (maintenance)
+        {
+            // Rows were rebuilt from scratch, so nothing is known to be merged
+            maintenance->clear();
+            for (const auto &node : nodes)
+                maintenance->mark_dirty(node.get());
+        }
+    }
+
+    void BeliefGraph::rebuild_slots()
+    {
+        node_slot.clear();
+        shared_nodes = 0;
+        std::vector<std::pair<double, BeliefNode *>> keys;
+        std::vector<std::pair<double, BeliefNode *>> confidences;
+        for (size_t i = 0; i < nodes.size(); ++i)
+        {
+            node_slot[nodes[i].get()] = i;
+            if (nodes[i]->shared)
+                shared_nodes++;
+            if (capacity_enforced())
+                keys.emplace_back(retention_key(*nodes[i]), nodes[i].get());
+            if (maintenance)
+                confidences.emplace_back(nodes[i]->confidence, nodes[i].get());
+        }
+        retention.assign(std::move(keys));
+        confidence_index.assign(std::move(confidences));
+    }
+
+    void BeliefGraph::sync_index()
+    {
+        // Callers that edit `nodes` directly bypass the hooks; resync rather than use stale rows
+        if (partition_row.size() + empty_prototypes != nodes.size() || node_slot.size() != nodes.size())
+            reindex();
+    }
+
+    BeliefGraph::Partition *BeliefGraph::partition_for(size_t width)
+    {
+        auto it = partitions.find(width);
+        return (it == partitions.end() || it->second.members.empty()) ? nullptr : &it->second;
+    }
+
+    void BeliefGraph::activate_partition(size_t width)
+    {
+        if (width == active_width)
+            return;
+        // Only the previously active partition can hold non-zero activations
+        if (Partition *old = partition_for(active_width))
+            std::fill(old->activations.begin(), old->activations.end(), Real(0.0));
+        active_width = width;
+        active_total = 0.0;
+        active_winner = nullptr;
+    }
+
+    const std::vector<BeliefNode *> &BeliefGraph::active_beliefs() const
+    {
+        static const std::vector<BeliefNode *> none;
+        auto it = partitions.find(active_width);
+        return (it == partitions.end()) ? none : it->second.members;
+    }
+
+    const std::vector<Real> &BeliefGraph::active_activations() const
+    {
+        static const std::vector<Real> none;
+        auto it = partitions.find(active_width);
+        return (it == partitions.end()) ? none : it->second.activations;
+    }
+
+    Real BeliefGraph::activation_of(const BeliefNode &node) const
+    {
+        if (node.prototype.features.size() != active_width)
+            return 0.0;
+        auto row = partition_row.find(&node);
+        if (row == partition_row.end())
+            return 0.0;
+        return partitions.at(active_width).activations[row->second];
+    }
+
+    void BeliefGraph::width_slots(size_t width, std::vector<std::pair<size_t, size_t>> &out)
+    {
+        sync_index();
+        out.clear();
+        const Partition *part = partition_for(width);
+        if (!part)
+            return;
+        out.reserve(part->members.size());
+        for (size_t row = 0; row < part->members.size(); ++row)
+            out.emplace_back(node_slot.at(part->members[row]), row);
+        std::sort(out.begin(), out.end());
+    }
+
+    void BeliefGraph::match_width(const Real *features, size_t width, std::vector<Real> &scores) const
+    {
+        auto it = partitions.find(width);
+        if (it == partitions.end() || it->second.members.empty())
+        {
+            scores.clear();
+            return;
+        }
+        const Partition &part = it->second;
+        scores.resize(part.members.size());
+        part.kernels->match_rows(features, part.prototypes.data(), part.members.size(), width, scores.data());
+    }
+
+    size_t BeliefGraph::active_winner_row() const
+    {
+        if (!active_winner)
+            return 0;
+        auto row = partition_row.find(active_winner);
+        return (row == partition_row.end()) ? 0 : row->second;
+    }
+
+    void BeliefGraph::erase_node(const BeliefNode *node)
+    {
+        auto it = node_slot.find(node);
+        if (it == node_slot.end())
+            return;
+        size_t slot = it->second;
+        node_slot.erase(it);
+        on_erase(node);
+        // Swap-remove; the proto-belief at the front is never erased this way
+        if (slot + 1 != nodes.size())
+        {
+            nodes[slot] = std::move(nodes.back());
+            node_slot[nodes[slot].get()] = slot;
+        }
+        nodes.pop_back();
+    }
+
+    bool BeliefGraph::screening_active() const
+    {
+        return quantized && nodes.size() >= static_cast<size_t>(config.quantized_min_population);
     }
 
     std::shared_ptr<BeliefNode> BeliefGraph::compete(const PatternSignature &input)
     {
+        sync_index();
+        if (cold && !cold->empty())
+            promote_cold(input);
+        const size_t width = input.features.size();
+        activate_partition(width);
+        active_winner = nullptr;
+        Partition *part = partition_for(width);
+        if (!part)
+            return nodes.empty() ? nullptr : nodes.front(); // nothing can match; every activation is zero
+
+        // A recurring observation reuses the last result while the graph is unchanged
+        if (compete_cache)
+        {
+            if (const CompeteCache::Entry *hit = compete_cache->find(input.features.data(), width))
+            {
+                std::copy(hit->activations.begin(), hit->activations.end(), part->activations.begin());
+                active_total = hit->total;
+                if (cold)
+                    note_hot(*part);
+                return stamp_winner(part->members[hit->winner_row])->shared_from_this();
+            }
+        }
+        BeliefNode *best = screening_active()      ? compete_screened(input, *part)
+                           : sharding_active(*part) ? compete_sharded(input, *part)
+                                                    : compete_exact(input, *part);
+        if (!best)
+            return nodes.empty() ? nullptr : nodes.front();
+        if (compete_cache)
+            compete_cache->store(part->activations, active_total, partition_row.at(best));
+        if (cold)
+            note_hot(*part);
+        return stamp_winner(best)->shared_from_this();
+    }
+
+    void BeliefGraph::promote_cold(const PatternSignature &input)
+    {
+        thawed.clear();
+        if (cold->take_matching(input.features.data(), input.features.size(), config.cold_tier_activation, thawed) == 0)
+            return;
+        for (const auto &node : thawed)
+        {
+            if (log_merges && tier_log.size() < 4096)
+                tier_log.emplace_back(node->id, true);
+            insert_belief(node);
+        }
+        if (config.verbose)
+            std::cout << "[DBEA] Promoted " << thawed.size() << " beliefs from the cold tier\n";
+    }
+
+    void BeliefGraph::note_hot(Partition &part)
+    {
+        const Real negligible = static_cast<Real>(config.cold_tier_activation);
+        for (size_t row = 0; row < part.members.size(); ++row)
+        {
+            if (part.activations[row] >= negligible)
+                part.hot_steps[row] = compete_clock;
+        }
+    }
+
+    size_t BeliefGraph::demote_idle()
+    {
+        // Beliefs held by an evolution cycle in progress stay put until it commits
+        if (!cold || evolution_job.pending)
+            return 0;
+        sync_index();
+        const uint64_t window = static_cast<uint64_t>(config.cold_tier_window);
+        std::vector<BeliefNode *> idle;
+        for (const auto &[width, part] : partitions)
+        {
+            for (size_t row = 0; row < part.members.size(); ++row)
+            {
+                BeliefNode *node = part.members[row];
+                if (compete_clock - part.hot_steps[row] >= window && node != active_winner &&
+                    node->id != "proto-belief")
+                    idle.push_back(node);
+            }
+        }
+        for (BeliefNode *node : idle)
+        {
+            if (log_merges && tier_log.size() < 4096)
+                tier_log.emplace_back(node->id, false);
+            cold->store(*node);
+            erase_node(node);
+        }
+        if (config.verbose && !idle.empty())
+            std::cout << "[DBEA] Moved " << idle.size() << " idle beliefs to the cold tier (" << cold->size()
+                      << " cold)\n";
+        return idle.size();
+    }
+
+    std::vector<std::shared_ptr<BeliefNode>> BeliefGraph::all_beliefs() const
+    {
+        std::vector<std::shared_ptr<BeliefNode>> all = nodes;
+        if (cold)
+        {
+            auto frozen = cold->snapshot();
+            all.insert(all.end(), frozen.begin(), frozen.end());
+        }
+        return all;
+    }
+
+    BeliefNode *BeliefGraph::compete_exact(const PatternSignature &input, Partition &part)
+    {
+        // Only the partition of matching width is scored, straight from its packed rows
         double best_score = -1.0;
-        std::shared_ptr<BeliefNode> winner = nullptr;
-        for (auto &node : nodes)
+        BeliefNode *best = nullptr;
+        active_total = 0.0;
+        row_scores.resize(part.members.size());
+        part.kernels->match_rows(input.features.data(), part.prototypes.data(), part.members.size(), part.width,
+                                 row_scores.data());
+        for (size_t row = 0; row < part.members.size(); ++row)
         {
-            double match = node->match_score(input);
-            node->activation = match * node->confidence;
-            if (node->activation > best_score)
+            BeliefNode *node = part.members[row];
+            Real activation = row_scores[row] * node->confidence;
+            part.activations[row] = activation;
+            active_total += activation;
+            if (activation > best_score)
             {
-                best_score = node->activation;
-                winner = node;
+                best_score = activation;
+                best = node;
             }
         }
-        return winner;
+        return best;
+    }
+
+    bool BeliefGraph::sharding_active(const Partition &part) const
+    {
+        return config.compete_threads > 0 &&
+               part.members.size() >= static_cast<size_t>(std::max(1, config.compete_parallel_min));
+    }
+
+    BeliefNode *BeliefGraph::compete_sharded(const PatternSignature &input, Partition &part)
+    {
+        // compete_exact() over fixed shards of rows. Shard bounds depend only on the
+        // partition size, and the partials are combined in shard order below, so the
+        // thread count never changes the winner or the rounding of the total.
+        if (!shard_pool)
+            shard_pool = std::make_unique<ShardPool>(static_cast<size_t>(config.compete_threads));
+        const size_t rows = part.members.size();
+        const size_t shard_rows = static_cast<size_t>(std::max(1, config.compete_shard_rows));
+        const size_t shards = (rows + shard_rows - 1) / shard_rows;
+        row_scores.resize(rows);
+        shard_results.assign(shards, ShardResult{});
+
+        const Real *in = input.features.data();
+        auto score_shard = [&](size_t shard)
+        {
+            const size_t begin = shard * shard_rows;
+            const size_t end = std::min(rows, begin + shard_rows);
+            part.kernels->match_rows(in, part.prototypes.data() + begin * part.width, end - begin, part.width,
+                                     row_scores.data() + begin);
+            ShardResult &result = shard_results[shard];
+            for (size_t row = begin; row < end; ++row)
+            {
+                Real activation = row_scores[row] * part.members[row]->confidence;
+                part.activations[row] = activation;
+                result.total += activation;
+                if (activation > result.best_score)
+                {
+                    result.best_score = activation;
+                    result.best_row = row;
+                    result.has_best = true;
+                }
+            }
+        };
+        shard_pool->run(shards, score_shard);
+
+        // Strict > keeps the earliest row among ties, as the serial scan does
+        double best_score = -1.0;
+        BeliefNode *best = nullptr;
+        active_total = 0.0;
+        for (const ShardResult &result : shard_results)
+        {
+            active_total += result.total;
+            if (result.has_best && result.best_score > best_score)
+            {
+                best_score = result.best_score;
+                best = part.members[result.best_row];
+            }
+        }
+        return best;
+    }
+
+    BeliefNode *BeliefGraph::stamp_winner(BeliefNode *best)
+    {
+        active_winner = best;
+        ++compete_clock;
+        // Only recency retention reads the stamp, so a shared winner is left alone otherwise
+        if (best->shared && retention_kind != Retention::Recency)
+            return best;
+        BeliefNode &winner = own(best);
+        winner.last_active_step = compete_clock;
+        touch(&winner);
+        return &winner;
+    }
+
+    BeliefNode *BeliefGraph::compete_screened(const PatternSignature &input, Partition &part)
+    {
+        // Beliefs screened out are treated as non-matching
+        std::fill(part.activations.begin(), part.activations.end(), Real(0.0));
+        active_total = 0.0;
+
+        double best_score = -1.0;
+        BeliefNode *best = nullptr;
+        if (quantized->begin_screen(input.features.data(), input.features.size()))
+        {
+            const size_t budget = static_cast<size_t>(config.quantized_shortlist);
+            const Real sqrt_width = std::sqrt(static_cast<Real>(input.features.size()));
+            size_t rescored = 0;
+            bool bounded = false;
+            while (!bounded && rescored < budget &&
+                   quantized->next_candidates(std::min<size_t>(16, budget - rescored), candidates) > 0)
+            {
+                for (const auto &cand : candidates)
+                {
+                    // confidence <= 1, so the distance bound caps any remaining activation
+                    Real upper = std::max<Real>(0.0, Real(1.0) - cand.distance_lower_bound / sqrt_width);
+                    if (upper <= best_score)
+                    {
+                        bounded = true;
+                        break;
+                    }
+                    BeliefNode *node = cand.node;
+                    Real activation = node->match_score(input) * node->confidence;
+                    part.activations[partition_row.at(node)] = activation;
+                    active_total += activation;
+                    rescored++;
+                    if (activation > best_score)
+                    {
+                        best_score = activation;
+                        best = node;
+                    }
+                }
+            }
+        }
+        return best;
     }
 
     std::shared_ptr<BeliefNode> BeliefGraph::maybe_create_belief(
@@ -36,15 +861,13 @@ namespace dbea
         double activation_threshold)
     {
         auto winner = compete(input);
-        if (!winner || winner->activation < activation_threshold)
+        if (!winner || activation_of(*winner) < activation_threshold)
         {
-            auto newborn = std::make_shared<BeliefNode>(
-                "belief_" + std::to_string(NEXT_BELIEF_ID++),
-                input);
+            auto newborn = std::make_shared<BeliefNode>(new_belief_id(), input);
             newborn->local_lr = 0.1;
-            newborn->emotional_affinity = std::vector<double>(5, 0.0);
-            nodes.push_back(newborn);
-            std::cout << "[DBEA] New belief created: " << newborn->id << std::endl;
+            add_belief(newborn);
+            if (config.verbose)
+                std::cout << "[DBEA] New belief created: " << newborn->id << std::endl;
             return newborn;
         }
         return winner;
@@ -52,50 +875,75 @@ namespace dbea
 
     void BeliefGraph::prune(double threshold)
     {
+        if (maintenance)
+        {
+            // Same set of beliefs as the scan below, popped off the confidence heap
+            sync_index();
+            while (!confidence_index.empty() && confidence_index.top_key() < threshold)
+            {
+                note_life(*confidence_index.top(), false);
+                erase_node(confidence_index.top());
+                maintenance->stats.pruned++;
+            }
+            return;
+        }
+        const size_t before = nodes.size();
         nodes.erase(
             std::remove_if(nodes.begin(), nodes.end(),
-                           [threshold](const std::shared_ptr<BeliefNode> &n)
-                           { return n->confidence < threshold; }),
+                           [this, threshold](const std::shared_ptr<BeliefNode> &n)
+                           {
+                               if (n->confidence >= threshold)
+                                   return false;
+                               note_life(*n, false);
+                               on_erase(n.get());
+                               return true;
+                           }),
             nodes.end());
+        if (nodes.size() != before)
+            rebuild_slots();
     }
 
     void BeliefGraph::merge_beliefs(double merge_threshold)
     {
-        for (size_t i = 0; i < nodes.size(); ++i)
+        sync_index();
+        if (screening_active())
         {
-            if (nodes[i]->id == "proto-belief")
+            merge_screened(merge_threshold);
+            return;
+        }
+
+        // Beliefs of different widths never match, so pairs are only formed within a partition
+        for (auto &[width, part] : partitions)
+            merge_partition(part, merge_threshold);
+    }
+
+    void BeliefGraph::merge_partition(Partition &part, double merge_threshold)
+    {
+        const size_t w = part.width;
+        for (size_t i = 0; i < part.members.size(); ++i)
+        {
+            BeliefNode *keeper = part.members[i];
+            if (keeper->id == "proto-belief")
                 continue;
-            for (size_t j = i + 1; j < nodes.size();)
+            for (size_t j = i + 1; j < part.members.size();)
             {
-                if (nodes[j]->id == "proto-belief")
+                BeliefNode *other = part.members[j];
+                if (other->id == "proto-belief")
                 {
                     ++j;
                     continue;
                 }
-                double similarity = nodes[i]->match_score(nodes[j]->prototype);
-                if (similarity > merge_threshold && std::abs(nodes[i]->evidence_count - nodes[j]->evidence_count) < 20)
+                double similarity = part.kernels->match(&part.prototypes[i * w], &part.prototypes[j * w], w);
+                if (similarity > merge_threshold && std::abs(keeper->evidence_count - other->evidence_count) < 20)
                 {
-                    int total_evidence = nodes[i]->evidence_count + nodes[j]->evidence_count;
-                    for (size_t k = 0; k < nodes[i]->prototype.features.size(); ++k)
-                    {
-                        nodes[i]->prototype.features[k] =
-                            (nodes[i]->prototype.features[k] * nodes[i]->evidence_count +
-                             nodes[j]->prototype.features[k] * nodes[j]->evidence_count) /
-                            total_evidence;
-                    }
-                    nodes[i]->confidence =
-                        (nodes[i]->confidence * nodes[i]->evidence_count +
-                         nodes[j]->confidence * nodes[j]->evidence_count) /
-                        total_evidence;
-                    for (const auto &[action_id, value] : nodes[j]->action_values)
-                    {
-                        double old_val = nodes[i]->action_values[action_id];
-                        nodes[i]->action_values[action_id] = old_val * 0.9 + value * 0.1;
-                    }
-                    nodes[i]->evidence_count = total_evidence;
-                    nodes.erase(nodes.begin() + j);
-                    if (config.debug_merging)
-                        std::cout << "[DBEA] Merged: " << nodes[i]->id << " ← (sim=" << similarity << ", ev=" << total_evidence << ")\n";
+                    keeper = &own(keeper);
+                    absorb_belief(*keeper, *other);
+                    note_merge(*keeper, *other);
+                    erase_node(other); // swap-removes row j, so j is re-examined
+                    on_prototype_changed(keeper);
+                    touch(keeper);
+                    if (config.debug_merging && config.verbose)
+                        std::cout << "[DBEA] Merged: " << keeper->id << " ← (sim=" << similarity << ", ev=" << keeper->evidence_count << ")\n";
                 }
                 else
                     ++j;
@@ -103,30 +951,84 @@ namespace dbea
         }
     }
 
+    void BeliefGraph::merge_screened(double merge_threshold)
+    {
+        // Same fusion rule as the exact pass, but each belief is only compared
+        // with its quantized nearest neighbours instead of every later belief.
+        // Erasing reorders `nodes`, so walk a snapshot and skip beliefs merged away.
+        std::vector<BeliefNode *> keepers;
+        keepers.reserve(nodes.size());
+        for (const auto &node : nodes)
+            keepers.push_back(node.get());
+        for (BeliefNode *keeper : keepers)
+        {
+            if (!node_slot.count(keeper) || keeper->id == "proto-belief")
+                continue;
+            const size_t width = keeper->prototype.features.size();
+            if (!quantized->begin_screen(keeper->prototype.features.data(), width))
+                continue;
+            quantized->next_candidates(static_cast<size_t>(config.quantized_shortlist) + 1, candidates);
+            // similarity > threshold requires distance < (1 - threshold) * sqrt(width)
+            const Real max_distance = static_cast<Real>((1.0 - merge_threshold) * std::sqrt(static_cast<double>(width)));
+            for (const auto &cand : candidates)
+            {
+                if (cand.distance_lower_bound >= max_distance)
+                    break;
+                BeliefNode *other = cand.node;
+                // A keeper cloned by own() below leaves its shared original among the candidates
+                if (other == keeper || other->id == "proto-belief" || !node_slot.count(other))
+                    continue;
+                double similarity = keeper->match_score(other->prototype);
+                if (similarity <= merge_threshold || std::abs(keeper->evidence_count - other->evidence_count) >= 20)
+                    continue;
+
+                keeper = &own(keeper);
+                absorb_belief(*keeper, *other);
+                note_merge(*keeper, *other);
+                erase_node(other);
+                on_prototype_changed(keeper);
+                touch(keeper);
+                if (config.debug_merging && config.verbose)
+                    std::cout << "[DBEA] Merged: " << keeper->id << " ← (sim=" << similarity << ", ev=" << keeper->evidence_count << ")\n";
+            }
+        }
+    }
+
+    std::vector<std::shared_ptr<BeliefNode>> BeliefGraph::top_by_fitness(size_t count) const
+    {
+        std::vector<std::shared_ptr<BeliefNode>> ranked;
+        ranked.reserve(nodes.size());
+        for (const auto &node : nodes)
+        {
+            if (node->id != "proto-belief")
+                ranked.push_back(node);
+        }
+        count = std::min(count, ranked.size());
+        std::partial_sort(ranked.begin(), ranked.begin() + count, ranked.end(),
+                          [](const auto &a, const auto &b)
+                          { return a->fitness > b->fitness; });
+        ranked.resize(count);
+        return ranked;
+    }
+
     // UPDATED: Now takes emotion reference
+    // Evolution runs separately inside each width partition: beliefs of different
+    // widths can never match the same perception, so they never compete for a niche.
     void BeliefGraph::evolve_cycle(const EmotionState &emotion)
     {
         if (nodes.size() < 4)
             return; // Almost no evolution when population tiny
+        own_all(); // reproduce() writes to surviving beliefs
 
-        std::cout << "[NDBE] Starting gentle evolution cycle | Pop: " << nodes.size() << std::endl;
+        if (config.verbose)
+            std::cout << "[NDBE] Starting gentle evolution cycle | Pop: " << nodes.size() << std::endl;
 
-        // Protect proto-belief
-        std::shared_ptr<BeliefNode> proto = nullptr;
-        for (const auto &n : nodes)
-        {
-            if (n->id == "proto-belief")
-            {
-                proto = n;
-                break;
-            }
-        }
-
-        // Compute avg fitness (only positive)
+        std::map<size_t, std::vector<std::shared_ptr<BeliefNode>>> populations;
         double total_fitness = 0.0;
         size_t valid_count = 0;
         for (const auto &node : nodes)
         {
+            populations[node->prototype.features.size()].push_back(node);
             if (node->fitness > 0.0)
             {
                 total_fitness += node->fitness;
@@ -135,70 +1037,382 @@ namespace dbea
         }
         double avg_fitness = (valid_count > 0) ? total_fitness / valid_count : 1.0;
 
-        // Survivors list — start with everyone
-        std::vector<std::shared_ptr<BeliefNode>> survivors = nodes;
+        EvolutionStats stats;
+        std::vector<std::shared_ptr<BeliefNode>> next;
+        next.reserve(nodes.size());
+        for (auto &[width, pop] : populations)
+        {
+            if (pop.size() >= 4)
+                evolve_partition(pop, emotion, evo_rng, stats);
+            next.insert(next.end(), pop.begin(), pop.end());
+        }
+        // Regrouping orders beliefs by width; keep the proto-belief at the front, where the agent looks for it
+        auto proto = std::find_if(next.begin(), next.end(), [](const auto &n)
+                                  { return n->id == "proto-belief"; });
+        if (proto != next.end() && proto != next.begin())
+            std::rotate(next.begin(), proto, proto + 1);
+        nodes = std::move(next);
+        reindex();
+        make_room(0);
 
-        // Only kill clear parasites — very high threshold + evidence protection
-        for (auto it = survivors.begin(); it != survivors.end();)
+        if (config.verbose)
+            std::cout << "[NDBE] Cycle complete | Killed: " << stats.killed << " | Born: " << stats.born
+                      << " | New pop: " << nodes.size() << " | Avg fitness: " << avg_fitness
+                      << " | Partitions: " << populations.size() << std::endl;
+    }
+
+    void BeliefGraph::request_evolution(const EmotionState &emotion)
+    {
+        EvolutionJob &job = evolution_job;
+        if (job.pending || nodes.size() < 4)
+            return;
+
+        std::map<size_t, size_t> sizes;
+        for (const auto &node : nodes)
+            sizes[node->prototype.features.size()]++;
+        job = EvolutionJob{};
+        job.pending = true;
+        job.emotion = emotion;
+        for (const auto &[width, count] : sizes)
+        {
+            if (count >= 4)
+                job.widths.push_back(width);
+        }
+        job.partitions = sizes.size();
+        job.cycle_avg_fitness = positive_mean_fitness(nodes);
+        if (config.verbose)
+            std::cout << "[NDBE] Starting gentle evolution cycle | Pop: " << nodes.size() << std::endl;
+    }
+
+    bool BeliefGraph::evolution_step()
+    {
+        EvolutionJob &job = evolution_job;
+        while (job.pending)
+        {
+            if (job.pop.empty())
+            {
+                if (job.widths.empty())
+                {
+                    job.pending = false;
+                    maintenance->stats.evolution_cycles++;
+                    if (config.verbose)
+                        std::cout << "[NDBE] Cycle complete | Killed: " << job.stats.killed << " | Born: " << job.stats.born
+                                  << " | New pop: " << nodes.size() << " | Avg fitness: " << job.cycle_avg_fitness
+                                  << " | Partitions: " << job.partitions << std::endl;
+                    return true;
+                }
+                size_t width = job.widths.back();
+                job.widths.pop_back();
+                // Live members of the partition at the time it is reached
+                for (const auto &node : nodes)
+                {
+                    if (node->prototype.features.size() == width)
+                        job.pop.push_back(node);
+                }
+                if (job.pop.size() < 4)
+                {
+                    job.pop.clear();
+                    continue;
+                }
+                job.avg_fitness = positive_mean_fitness(job.pop);
+                job.survivors.clear();
+                job.cursor = 0;
+            }
+
+            // Parasite scoring scans every co-activation pair, so it is sliced per belief
+            while (job.cursor < job.pop.size())
+            {
+                if (!maintenance->spend(config.symbiotic_uplift == 0.0 ? 1 : 1 + co_activations().size()))
+                    return false;
+                const auto &b = job.pop[job.cursor++];
+                if (!is_parasite(*b, job.pop, job.avg_fitness))
+                    job.survivors.push_back(b);
+            }
+            if (!maintenance->spend(job.pop.size() * kEraseOps))
+                return false;
+            commit_evolved_partition();
+        }
+        return true;
+    }
+
+    void BeliefGraph::commit_evolved_partition()
+    {
+        EvolutionJob &job = evolution_job;
+        // Beliefs merged or pruned away while the partition was being assessed drop out here
+        std::vector<std::shared_ptr<BeliefNode>> pop;
+        pop.reserve(job.survivors.size());
+        for (const auto &node : job.survivors)
         {
-            const auto &b = *it;
-            if (b->id == "proto-belief" || b->evidence_count < 8)
-            { // Protect young beliefs
-                ++it;
+            if (node_slot.count(node.get()))
+                pop.push_back(own_slot(node_slot.at(node.get()))); // reproduce() writes to survivors
+        }
+        if (pop.size() >= 4)
+            reproduce(pop, job.emotion, evo_rng, job.stats, job.avg_fitness);
+
+        // Apply the result through the index hooks instead of a full reindex
+        std::unordered_set<const BeliefNode *> kept;
+        for (const auto &node : pop)
+            kept.insert(node.get());
+        std::unordered_set<const BeliefNode *> assessed;
+        if (log_merges)
+        {
+            for (const auto &node : job.survivors)
+                assessed.insert(node.get());
+        }
+        for (const auto &node : job.pop)
+        {
+            if (kept.count(node.get()) || !node_slot.count(node.get()))
                 continue;
+            if (log_merges && !assessed.count(node.get())) // reproduce() noted the ones it culled
+                note_life(*node, false);
+            erase_node(node.get());
+        }
+        for (const auto &node : pop)
+        {
+            if (!node_slot.count(node.get()))
+            {
+                nodes.push_back(node);
+                on_insert(node);
             }
+        }
+        make_room(0);
+        job.pop.clear();
+        job.survivors.clear();
+    }
+
+    void BeliefGraph::prune_step(double threshold)
+    {
+        while (!confidence_index.empty() && confidence_index.top_key() < threshold && maintenance->spend(kEraseOps))
+        {
+            note_life(*confidence_index.top(), false);
+            erase_node(confidence_index.top());
+            maintenance->stats.pruned++;
+        }
+    }
+
+    void BeliefGraph::note_merge(const BeliefNode &keeper, const BeliefNode &absorbed)
+    {
+        // Bounded so an undrained log cannot grow without limit
+        if (log_merges && merge_log.size() < 4096)
+            merge_log.emplace_back(absorbed.id, keeper.id);
+    }
+
+    void BeliefGraph::note_life(const BeliefNode &node, bool born)
+    {
+        if (log_merges && life_log.size() < 4096)
+            life_log.emplace_back(node.id, born);
+    }
 
-            double symbiotic_income = 0.0;
-            int partner_count = 0;
-            for (const auto &[key, count] : co_activations)
+    // Checks one belief against the rest of its partition under the merge rule of
+    // merge_partition(): of each matching pair, the belief in the earlier partition row
+    // keeps its id and absorbs the other. Returns false, leaving the belief queued, if
+    // the budget ran out.
+    bool BeliefGraph::merge_one(BeliefNode *node, double merge_threshold)
+    {
+        if (node->id == "proto-belief")
+            return true;
+        const size_t width = node->prototype.features.size();
+        Partition *part = partition_for(width);
+        if (!part || part->members.size() < 2)
+            return true;
+
+        std::vector<BeliefNode *> &others = merge_partners;
+        others.clear();
+        if (screening_active())
+        {
+            if (!maintenance->spend(static_cast<size_t>(config.quantized_shortlist)))
+                return false;
+            if (!quantized->begin_screen(node->prototype.features.data(), width))
+                return true;
+            quantized->next_candidates(static_cast<size_t>(config.quantized_shortlist) + 1, candidates);
+            const Real max_distance = static_cast<Real>((1.0 - merge_threshold) * std::sqrt(static_cast<double>(width)));
+            for (const auto &cand : candidates)
             {
-                if (key.find(b->id) != std::string::npos && count > 10)
-                { // stricter co-activation
-                    std::string other_id = (key.substr(0, key.find("_")) == b->id)
-                                               ? key.substr(key.find("_") + 1)
-                                               : key.substr(0, key.find("_"));
-                    for (const auto &other : nodes)
-                    {
-                        if (other->id == other_id)
-                        {
-                            symbiotic_income += std::max(0.0, other->fitness);
-                            partner_count++;
-                            break;
-                        }
-                    }
-                }
+                if (cand.distance_lower_bound >= max_distance)
+                    break;
+                others.push_back(cand.node);
             }
-            symbiotic_income *= config.symbiotic_uplift / (partner_count + 1e-6);
+        }
+        else
+        {
+            if (!maintenance->spend(part->members.size()))
+                return false;
+            row_scores.resize(part->members.size());
+            part->kernels->match_rows(node->prototype.features.data(), part->prototypes.data(),
+                                      part->members.size(), width, row_scores.data());
+            for (size_t row = 0; row < part->members.size(); ++row)
+            {
+                if (row_scores[row] > merge_threshold)
+                    others.push_back(part->members[row]);
+            }
+        }
 
-            double parasite_score = symbiotic_income / (b->fitness + 1e-6);
+        for (BeliefNode *other : others)
+        {
+            if (other == node || other->id == "proto-belief" || !node_slot.count(other))
+                continue;
+            double similarity = node->match_score(other->prototype);
+            if (similarity <= merge_threshold || std::abs(node->evidence_count - other->evidence_count) >= 20)
+                continue;
+
+            BeliefNode *keeper = partition_row.at(other) < partition_row.at(node) ? other : node;
+            BeliefNode *absorbed = (keeper == node) ? other : node;
+            keeper = &own(keeper);
+            if (absorbed != node)
+                node = keeper;
+            absorb_belief(*keeper, *absorbed);
+            note_merge(*keeper, *absorbed);
+            erase_node(absorbed);
+            on_prototype_changed(keeper); // re-queues the keeper against its new prototype
+            touch(keeper);
+            maintenance->stats.merged++;
+            if (config.debug_merging && config.verbose)
+                std::cout << "[DBEA] Merged: " << keeper->id << " ← (sim=" << similarity << ", ev=" << keeper->evidence_count << ")\n";
+            if (absorbed == node)
+                break;
+        }
+        return true;
+    }
 
-            // Much higher bar + evidence check
-            if (parasite_score > 12.0 && b->fitness < 0.3 * avg_fitness)
+    void BeliefGraph::maintain(double merge_threshold, double prune_threshold)
+    {
+        if (!maintenance)
+        {
+            merge_beliefs(merge_threshold);
+            prune(prune_threshold);
+            return;
+        }
+        sync_index();
+        maintenance->begin_step();
+
+        prune_step(prune_threshold);
+
+        // Beliefs that are new or whose prototype moved are the only ones that can have gained a partner
+        while (BeliefNode *node = maintenance->next_dirty())
+        {
+            if (!node_slot.count(node))
+                continue;
+            if (!merge_one(node, merge_threshold))
             {
-                std::cout << "[NDBE] Killed weak parasite: " << b->id
-                          << " (score=" << parasite_score << ", fitness=" << b->fitness << ")\n";
-                it = survivors.erase(it);
+                maintenance->mark_dirty(node);
+                break;
             }
+        }
+
+        if (!maintenance->exhausted())
+            evolution_step();
+
+        // Spare budget re-checks clean beliefs round-robin, so drifting thresholds and
+        // evidence counts are picked up without a full pass
+        for (size_t visited = 0; visited < nodes.size() && !maintenance->exhausted() && maintenance->dirty_count() == 0; ++visited)
+            merge_one(nodes[maintenance->next_sweep_slot(nodes.size())].get(), merge_threshold);
+
+        if (maintenance->dirty_count() > 0 || evolution_job.pending)
+            maintenance->stats.carried_steps++;
+    }
+
+    void BeliefGraph::run_full_maintenance(double merge_threshold, double prune_threshold)
+    {
+        if (!maintenance)
+        {
+            merge_beliefs(merge_threshold);
+            prune(prune_threshold);
+            return;
+        }
+        sync_index();
+        maintenance->begin_unbounded();
+        evolution_step();
+        merge_beliefs(merge_threshold);
+        prune(prune_threshold);
+        // Every remaining pair has just been compared
+        maintenance->clear();
+    }
+
+    void BeliefGraph::evolve_partition(std::vector<std::shared_ptr<BeliefNode>> &pop, const EmotionState &emotion,
+                                       std::mt19937 &rng, EvolutionStats &stats)
+    {
+        double avg_fitness = positive_mean_fitness(pop);
+
+        // Only kill clear parasites — very high threshold + evidence protection
+        std::vector<std::shared_ptr<BeliefNode>> survivors;
+        survivors.reserve(pop.size());
+        for (const auto &b : pop)
+        {
+            if (!is_parasite(*b, pop, avg_fitness))
+                survivors.push_back(b);
             else
-            {
-                ++it;
+                note_life(*b, false);
+        }
+        pop = std::move(survivors);
+
+        reproduce(pop, emotion, rng, stats, avg_fitness);
+    }
+
+    bool BeliefGraph::is_parasite(const BeliefNode &b, const std::vector<std::shared_ptr<BeliefNode>> &pop,
+                                  double avg_fitness) const
+    {
+        if (b.id == "proto-belief" || b.evidence_count < 8)
+            return false; // Protect young beliefs
+        // Without uplift the score below is always 0; skip the scan over every co-activation pair
+        if (config.symbiotic_uplift == 0.0)
+            return false;
+
+        double symbiotic_income = 0.0;
+        int partner_count = 0;
+        for (const auto &[key, count] : co_activations())
+        {
+            if (key.find(b.id) != std::string::npos && count > 10)
+            { // stricter co-activation
+                std::string other_id = (key.substr(0, key.find("_")) == b.id)
+                                           ? key.substr(key.find("_") + 1)
+                                           : key.substr(0, key.find("_"));
+                for (const auto &other : pop)
+                {
+                    if (other->id == other_id)
+                    {
+                        symbiotic_income += std::max<Real>(0.0, other->fitness);
+                        partner_count++;
+                        break;
+                    }
+                }
             }
         }
+        symbiotic_income *= config.symbiotic_uplift / (partner_count + 1e-6);
 
-        nodes = std::move(survivors);
+        double parasite_score = symbiotic_income / (b.fitness + 1e-6);
 
-        // If population dropped too low, keep at least proto + 2 others
-        if (nodes.size() < 4 && proto)
+        // Much higher bar + evidence check
+        if (parasite_score > 12.0 && b.fitness < 0.3 * avg_fitness)
+        {
+            if (config.verbose)
+                std::cout << "[NDBE] Killed weak parasite: " << b.id
+                          << " (score=" << parasite_score << ", fitness=" << b.fitness << ")\n";
+            return true;
+        }
+        return false;
+    }
+
+    // Selection, reproduction and culling over a population already cleared of parasites
+    void BeliefGraph::reproduce(std::vector<std::shared_ptr<BeliefNode>> &pop, const EmotionState &emotion,
+                                std::mt19937 &rng, EvolutionStats &stats, double avg_fitness)
+    {
+        // Protect proto-belief
+        std::shared_ptr<BeliefNode> proto = nullptr;
+        for (const auto &n : pop)
         {
-            // ... add some logic if needed, but usually not necessary now
+            if (n->id == "proto-belief")
+            {
+                proto = n;
+                break;
+            }
         }
 
         // Selection — stronger bias toward high fitness
         std::vector<double> selection_probs;
         double prob_sum = 0.0;
-        for (const auto &node : nodes)
+        for (const auto &node : pop)
         {
-            double prob = std::pow(std::max(0.01, node->fitness), 2.0) + 0.1; // Square to favor high fitness
+            double prob = std::pow(std::max<Real>(0.01, node->fitness), 2.0) + 0.1; // Square to favor high fitness
             selection_probs.push_back(prob);
             prob_sum += prob;
         }
@@ -207,31 +1421,28 @@ namespace dbea
 
         // Reproduction — top 30% now, 1 child each
         std::vector<std::shared_ptr<BeliefNode>> children;
-        std::mt19937 rng(std::random_device{}());
         std::uniform_real_distribution<double> uni(0.0, 1.0);
         std::normal_distribution<double> gauss(0.0, 0.8);
-        int num_parents = std::max(1, static_cast<int>(nodes.size() * 0.3));
+        int num_parents = std::max(1, static_cast<int>(pop.size() * 0.3));
 
         for (int i = 0; i < num_parents; ++i)
         {
             double roll = uni(rng);
             double cum = 0.0;
             std::shared_ptr<BeliefNode> parent = nullptr;
-            for (size_t j = 0; j < nodes.size(); ++j)
+            for (size_t j = 0; j < pop.size(); ++j)
             {
                 cum += selection_probs[j];
                 if (roll <= cum)
                 {
-                    parent = nodes[j];
+                    parent = pop[j];
                     break;
                 }
             }
             if (!parent)
                 continue;
 
-            auto child = std::make_shared<BeliefNode>(
-                "belief_" + std::to_string(NEXT_BELIEF_ID++),
-                parent->prototype);
+            auto child = std::make_shared<BeliefNode>(new_belief_id(), parent->prototype);
 
             // Milder mutation
             for (auto &feat : child->prototype.features)
@@ -250,6 +1461,7 @@ namespace dbea
 
             child->fitness = parent->fitness * 0.75 + 0.4; // Decent inheritance + boost
             child->confidence = parent->confidence * 0.8;
+            child->last_active_step = compete_clock;
 
             children.push_back(child);
         }
@@ -259,8 +1471,8 @@ namespace dbea
         {
             if (uni(rng) < 0.15)
             { // Reduced prob
-                std::uniform_int_distribution<size_t> dist(0, nodes.size() - 1);
-                auto target = nodes[dist(rng)];
+                std::uniform_int_distribution<size_t> dist(0, pop.size() - 1);
+                auto target = pop[dist(rng)];
                 if (target == child)
                     continue;
 
@@ -276,30 +1488,44 @@ namespace dbea
 
         // Gentle replacement: kill only 5–15%
         double prune_frac = (avg_fitness < config.crisis_reward_thresh) ? 0.15 : 0.05;
-        int num_kill = static_cast<int>(nodes.size() * prune_frac);
-        std::sort(nodes.begin(), nodes.end(),
-                  [](const auto &a, const auto &b)
-                  { return a->fitness < b->fitness; });
-        nodes.erase(nodes.begin(), nodes.begin() + num_kill);
-
-        // Guarantee proto survival
-        if (proto && std::find(nodes.begin(), nodes.end(), proto) == nodes.end())
+        int num_kill = static_cast<int>(pop.size() * prune_frac);
+        // Lowest fitness first: O(n) heapify + O(k log n) pops instead of a full sort.
+        // The proto-belief is never a candidate.
+        std::vector<std::pair<double, BeliefNode *>> fitness_keys;
+        fitness_keys.reserve(pop.size());
+        for (const auto &node : pop)
+        {
+            if (node != proto)
+                fitness_keys.emplace_back(node->fitness, node.get());
+        }
+        BeliefHeap weakest;
+        weakest.assign(std::move(fitness_keys));
+        std::unordered_set<const BeliefNode *> culled;
+        while (static_cast<int>(culled.size()) < num_kill && !weakest.empty())
         {
-            nodes.push_back(proto);
+            BeliefNode *weak = weakest.pop();
+            note_life(*weak, false);
+            culled.insert(weak);
         }
+        pop.erase(std::remove_if(pop.begin(), pop.end(),
+                                 [&culled](const auto &n)
+                                 { return culled.count(n.get()) > 0; }),
+                  pop.end());
 
         // Add children
         for (auto &child : children)
-            add_belief(child);
+        {
+            note_life(*child, true);
+            pop.push_back(child);
+        }
 
         // Arousal boost (milder)
         if (emotion.arousal > 0.7)
         {
-            for (auto &node : nodes)
+            for (auto &node : pop)
                 node->mutation_rate = std::min(0.45, node->mutation_rate * 1.1);
         }
-
-        std::cout << "[NDBE] Cycle complete | Killed: " << num_kill << " | Born: " << children.size()
-                  << " | New pop: " << nodes.size() << " | Avg fitness: " << avg_fitness << std::endl;
+        stats.killed += culled.size();
+        stats.born += children.size();
     }
 } // namespace dbea
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include "dbea/BeliefHeap.h"
+
+namespace dbea
+{
+    void BeliefHeap::clear()
+    {
+        heap.clear();
+        position.clear();
+    }
+
+    void BeliefHeap::assign(std::vector<std::pair<double, BeliefNode *>> entries)
+    {
+        heap = std::move(entries);
+        position.clear();
+        position.reserve(heap.size());
+        for (size_t i = 0; i < heap.size(); ++i)
+            position[heap[i].second] = i;
+        for (size_t i = heap.size() / 2; i-- > 0;)
+            sift_down(i);
+    }
+
+    void BeliefHeap::place(size_t i, std::pair<double, BeliefNode *> entry)
+    {
+        position[entry.second] = i;
+        heap[i] = entry;
+    }
+
+    void BeliefHeap::sift_up(size_t i)
+    {
+        auto entry = heap[i];
+        while (i > 0)
+        {
+            size_t parent = (i - 1) / 2;
+            if (heap[parent].first <= entry.first)
+                break;
+            place(i, heap[parent]);
+            i = parent;
+        }
+        place(i, entry);
+    }
+
+    void BeliefHeap::sift_down(size_t i)
+    {
+        auto entry = heap[i];
+        const size_t n = heap.size();
+        for (;;)
+        {
+            size_t child = 2 * i + 1;
+            if (child >= n)
+                break;
+            if (child + 1 < n && heap[child + 1].first < heap[child].first)
+                ++child;
+            if (entry.first <= heap[child].first)
+                break;
+            place(i, heap[child]);
+            i = child;
+        }
+        place(i, entry);
+    }
+
+    void BeliefHeap::push(BeliefNode *node, double key)
+    {
+        heap.emplace_back(key, node);
+        sift_up(heap.size() - 1);
+    }
+
+    void BeliefHeap::update(BeliefNode *node, double key)
+    {
+        auto it = position.find(node);
+        if (it == position.end())
+        {
+            push(node, key);
+            return;
+        }
+        size_t i = it->second;
+        double old_key = heap[i].first;
+        if (key == old_key)
+            return;
+        heap[i].first = key;
+        if (key < old_key)
+            sift_up(i);
+        else
+            sift_down(i);
+    }
+
+    void BeliefHeap::erase(const BeliefNode *node)
+    {
+        auto it = position.find(node);
+        if (it == position.end())
+            return;
+        size_t i = it->second;
+        position.erase(it);
+        auto last = heap.back();
+        heap.pop_back();
+        if (i == heap.size())
+            return;
+        place(i, last);
+        if (i > 0 && heap[(i - 1) / 2].first > last.first)
+            sift_up(i);
+        else
+            sift_down(i);
+    }
+
+    void BeliefHeap::replace(const BeliefNode *old, BeliefNode *now)
+    {
+        auto it = position.find(old);
+        if (it == position.end())
+            return;
+        size_t i = it->second;
+        position.erase(it);
+        place(i, {heap[i].first, now});
+    }
+
+    BeliefNode *BeliefHeap::pop()
+    {
+        if (heap.empty())
+            return nullptr;
+        BeliefNode *node = heap.front().second;
+        erase(node);
+        return node;
+    }
+} // namespace dbea
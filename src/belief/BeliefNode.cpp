@@ -1,15 +1,14 @@
 #include "dbea/BeliefNode.h"
+#include "dbea/FixedPatternSignature.h"
 #include <cmath>
 #include <algorithm>
 #include <string>
-#include <random> // NEW for init
 namespace dbea
 {
     BeliefNode::BeliefNode(const std::string &id_, const PatternSignature &proto)
         : id(id_),
           prototype(proto),
           confidence(id_ == "proto-belief" ? 0.3 : 0.5),
-          activation(0.0),
           evidence_count(1),
           last_predicted_reward(0.0),
           prediction_error(0.0),
@@ -18,46 +17,33 @@ namespace dbea
           local_lr(0.1),
           emotional_affinity(5, 0.0)
     {
-        // Random init for affinity only if not proto-belief
-        if (id_ != "proto-belief")
-        {
-            std::mt19937 rng(std::random_device{}());
-            std::uniform_real_distribution<double> dist(-0.2, 0.2);
-            for (auto &aff : emotional_affinity)
-                aff = dist(rng);
-        }
+        // Affinity starts neutral; evolved, migrated and loaded beliefs copy theirs in
     }
 
-    double BeliefNode::match_score(const PatternSignature &input) const
+    Real BeliefNode::match_score(const PatternSignature &input) const
     {
-        if (input.features.size() != prototype.features.size() || input.features.empty())
-            return 0.0;
+        return match_score(input.features.data(), input.features.size());
+    }
 
-        double sum_sq_diff = 0.0;
-        double max_range = 0.0;
-        for (size_t i = 0; i < input.features.size(); ++i)
-        {
-            double diff = input.features[i] - prototype.features[i];
-            sum_sq_diff += diff * diff;
-            max_range += 1.0;
-        }
-        double dist = std::sqrt(sum_sq_diff);
-        double normalized = 1.0 - (dist / std::sqrt(max_range));
-        return std::max(0.0, normalized);
+    Real BeliefNode::match_score(const Real *features, size_t count) const
+    {
+        if (count != prototype.features.size() || count == 0)
+            return 0.0;
+        return pattern_kernels(count).match(features, prototype.features.data(), count);
     }
 
     void BeliefNode::reinforce(double amount)
     {
-        confidence = std::min(1.0, confidence + amount);
+        confidence = static_cast<Real>(std::min(1.0, confidence + amount));
         evidence_count++;
     }
 
     void BeliefNode::decay(double amount)
     {
-        confidence = std::max(0.0, confidence - amount);
+        confidence = static_cast<Real>(std::max(0.0, confidence - amount));
     }
 
-    double BeliefNode::predict_action_value(int action_id) const
+    Real BeliefNode::predict_action_value(int action_id) const
     {
         auto it = action_values.find(action_id);
         return (it != action_values.end()) ? it->second : 0.0;
@@ -65,12 +51,12 @@ namespace dbea
 
     void BeliefNode::learn_action_value(int action_id, double reward, double learning_rate, double gamma)
     {
-        double old_value = action_values[action_id];
-        double next_max = 0.0;
+        Real old_value = action_values[action_id];
+        Real next_max = 0.0;
         for (const auto &[_, v] : action_values)
             next_max = std::max(next_max, v);
         double target = reward + gamma * next_max;
         double new_value = old_value + learning_rate * (target - old_value);
-        action_values[action_id] = new_value;
+        action_values[action_id] = static_cast<Real>(new_value);
     }
 } // namespace dbea
@@ -0,0 +1,292 @@
+#include "dbea/ColdBeliefStore.h"
+#include "dbea/FixedPatternSignature.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace dbea
+{
+    namespace
+    {
+        uint64_t mix(uint64_t h)
+        {
+            // splitmix64 finalizer
+            h ^= h >> 30;
+            h *= 0xBF58476D1CE4E5B9ull;
+            h ^= h >> 27;
+            h *= 0x94D049BB133111EBull;
+            return h ^ (h >> 31);
+        }
+
+        // Record layout (native byte order), all reals as f32:
+        //   u16 id length, u16 actions, u16 affinities, u16 reserved, i32 evidence,
+        //   u64 last_active_step, confidence, last_predicted_reward, prediction_error,
+        //   fitness, mutation_rate, local_lr, id bytes, prototype[width],
+        //   per action (i32 id, value), affinity[affinities]
+        struct RecordHeader
+        {
+            uint16_t id_length;
+            uint16_t actions;
+            uint16_t affinities;
+            uint16_t reserved;
+            int32_t evidence_count;
+            uint64_t last_active_step;
+            float confidence;
+            float last_predicted_reward;
+            float prediction_error;
+            float fitness;
+            float mutation_rate;
+            float local_lr;
+        };
+
+        template <typename T>
+        void put(std::vector<unsigned char> &out, const T &value)
+        {
+            const size_t at = out.size();
+            out.resize(at + sizeof(T));
+            std::memcpy(out.data() + at, &value, sizeof(T));
+        }
+
+        template <typename T>
+        T get(const unsigned char *&in)
+        {
+            T value;
+            std::memcpy(&value, in, sizeof(T));
+            in += sizeof(T);
+            return value;
+        }
+
+        uint16_t count16(size_t n, const char *what)
+        {
+            if (n > std::numeric_limits<uint16_t>::max())
+                throw std::runtime_error(std::string("Too many ") + what + " for a cold belief record");
+            return static_cast<uint16_t>(n);
+        }
+    } // namespace
+
+    ColdBeliefStore::ColdBeliefStore(double res) : resolution(res > 0.0 ? res : 1.0)
+    {
+    }
+
+    size_t ColdBeliefStore::cell_codes(const Real *features, size_t width, int64_t *codes) const
+    {
+        const size_t dims = std::min(width, kIndexDims);
+        for (size_t k = 0; k < dims; ++k)
+        {
+            const double scaled = std::floor(static_cast<double>(features[k]) * resolution);
+            // Non-finite features all share one code; the clamp leaves room for the +-1 probes
+            codes[k] = std::isfinite(scaled) ? static_cast<int64_t>(std::clamp(scaled, -1e18, 1e18))
+                                             : std::numeric_limits<int64_t>::min() / 2;
+        }
+        return dims;
+    }
+
+    uint64_t ColdBeliefStore::cell_key(size_t width, const int64_t *codes, size_t dims)
+    {
+        uint64_t key = mix(static_cast<uint64_t>(width));
+        for (size_t k = 0; k < dims; ++k)
+            key = mix(key ^ static_cast<uint64_t>(codes[k]));
+        return key;
+    }
+
+    void ColdBeliefStore::store(const BeliefNode &node)
+    {
+        const size_t width = node.prototype.features.size();
+        Record record;
+        record.offset = arena.size();
+        record.width = static_cast<uint32_t>(width);
+        int64_t codes[kIndexDims];
+        record.cell = cell_key(width, codes, cell_codes(node.prototype.features.data(), width, codes));
+
+        RecordHeader header{};
+        header.id_length = count16(node.id.size(), "id bytes");
+        header.actions = count16(node.action_values.size(), "action values");
+        header.affinities = count16(node.emotional_affinity.size(), "affinities");
+        header.evidence_count = node.evidence_count;
+        header.last_active_step = node.last_active_step;
+        header.confidence = static_cast<float>(node.confidence);
+        header.last_predicted_reward = static_cast<float>(node.last_predicted_reward);
+        header.prediction_error = static_cast<float>(node.prediction_error);
+        header.fitness = static_cast<float>(node.fitness);
+        header.mutation_rate = static_cast<float>(node.mutation_rate);
+        header.local_lr = static_cast<float>(node.local_lr);
+        put(arena, header);
+        arena.insert(arena.end(), node.id.begin(), node.id.end());
+        for (Real x : node.prototype.features)
+            put(arena, static_cast<float>(x));
+        for (const auto &[action, value] : node.action_values)
+        {
+            put(arena, static_cast<int32_t>(action));
+            put(arena, static_cast<float>(value));
+        }
+        for (Real a : node.emotional_affinity)
+            put(arena, static_cast<float>(a));
+        record.length = static_cast<uint32_t>(arena.size() - record.offset);
+
+        cells[record.cell].push_back(static_cast<uint32_t>(records.size()));
+        records.push_back(record);
+        live++;
+        stats.demoted++;
+    }
+
+    std::shared_ptr<BeliefNode> ColdBeliefStore::decode(const Record &record) const
+    {
+        const unsigned char *in = arena.data() + record.offset;
+        const RecordHeader header = get<RecordHeader>(in);
+        std::string id(reinterpret_cast<const char *>(in), header.id_length);
+        in += header.id_length;
+        PatternSignature prototype;
+        prototype.features.resize(record.width);
+        for (Real &x : prototype.features)
+            x = get<float>(in);
+
+        auto node = std::make_shared<BeliefNode>(id, prototype);
+        node->confidence = header.confidence;
+        node->evidence_count = header.evidence_count;
+        node->last_predicted_reward = header.last_predicted_reward;
+        node->prediction_error = header.prediction_error;
+        node->fitness = header.fitness;
+        node->mutation_rate = header.mutation_rate;
+        node->local_lr = header.local_lr;
+        node->last_active_step = header.last_active_step;
+        for (uint16_t a = 0; a < header.actions; ++a)
+        {
+            const int32_t action = get<int32_t>(in);
+            node->action_values[action] = get<float>(in);
+        }
+        node->emotional_affinity.resize(header.affinities);
+        for (Real &a : node->emotional_affinity)
+            a = get<float>(in);
+        return node;
+    }
+
+    Real ColdBeliefStore::activation(const Record &record, const Real *features) const
+    {
+        const unsigned char *in = arena.data() + record.offset;
+        const RecordHeader header = get<RecordHeader>(in);
+        in += header.id_length;
+        Real prototype[8];
+        std::vector<Real> wide;
+        Real *proto = prototype;
+        if (record.width > 8)
+        {
+            wide.resize(record.width);
+            proto = wide.data();
+        }
+        for (uint32_t k = 0; k < record.width; ++k)
+            proto[k] = get<float>(in);
+        return pattern_kernels(record.width).match(features, proto, record.width) * header.confidence;
+    }
+
+    size_t ColdBeliefStore::take_matching(const Real *features, size_t width, double threshold,
+                                          std::vector<std::shared_ptr<BeliefNode>> &out)
+    {
+        int64_t center[kIndexDims];
+        const size_t dims = cell_codes(features, width, center);
+        // Odometer over the 3^dims cells at -1, 0, +1 from the input's own cell
+        int offset[kIndexDims];
+        std::fill(offset, offset + dims, -1);
+        size_t taken = 0;
+        for (;;)
+        {
+            int64_t codes[kIndexDims];
+            for (size_t k = 0; k < dims; ++k)
+                codes[k] = center[k] + offset[k];
+            auto it = cells.find(cell_key(width, codes, dims));
+            if (it != cells.end())
+            {
+                // Walked backwards so remove() can swap-remove from the same list
+                std::vector<uint32_t> &list = it->second;
+                for (size_t i = list.size(); i-- > 0;)
+                {
+                    const Record &record = records[list[i]];
+                    if (record.width != width || activation(record, features) < threshold)
+                        continue;
+                    out.push_back(decode(record));
+                    remove(list[i]);
+                    taken++;
+                }
+                if (it->second.empty())
+                    cells.erase(it);
+            }
+            size_t k = 0;
+            while (k < dims && offset[k] == 1)
+                offset[k++] = -1;
+            if (k == dims)
+                break;
+            offset[k]++;
+        }
+        stats.promoted += taken;
+        if (dead_bytes > arena.size() / 2)
+            compact();
+        return taken;
+    }
+
+    void ColdBeliefStore::remove(uint32_t index)
+    {
+        Record &record = records[index];
+        std::vector<uint32_t> &list = cells[record.cell];
+        auto pos = std::find(list.begin(), list.end(), index);
+        *pos = list.back();
+        list.pop_back();
+        dead_bytes += record.length;
+        record.length = 0;
+        live--;
+    }
+
+    void ColdBeliefStore::compact()
+    {
+        // Live records move to the front in their original order; the index is rebuilt
+        std::vector<unsigned char> packed;
+        packed.reserve(arena.size() - dead_bytes);
+        std::vector<Record> kept;
+        kept.reserve(live);
+        cells.clear();
+        for (const Record &record : records)
+        {
+            if (record.length == 0)
+                continue;
+            Record moved = record;
+            moved.offset = packed.size();
+            packed.insert(packed.end(), arena.begin() + record.offset, arena.begin() + record.offset + record.length);
+            cells[moved.cell].push_back(static_cast<uint32_t>(kept.size()));
+            kept.push_back(moved);
+        }
+        arena = std::move(packed);
+        records = std::move(kept);
+        dead_bytes = 0;
+        stats.compactions++;
+    }
+
+    std::vector<std::shared_ptr<BeliefNode>> ColdBeliefStore::snapshot() const
+    {
+        std::vector<std::shared_ptr<BeliefNode>> out;
+        out.reserve(live);
+        for (const Record &record : records)
+        {
+            if (record.length != 0)
+                out.push_back(decode(record));
+        }
+        return out;
+    }
+
+    void ColdBeliefStore::clear()
+    {
+        arena.clear();
+        records.clear();
+        cells.clear();
+        live = 0;
+        dead_bytes = 0;
+    }
+
+    size_t ColdBeliefStore::bytes() const
+    {
+        size_t total = arena.capacity() + records.capacity() * sizeof(Record);
+        for (const auto &[cell, list] : cells)
+            total += sizeof(cell) + sizeof(list) + list.capacity() * sizeof(uint32_t) + 2 * sizeof(void *);
+        return total;
+    }
+} // namespace dbea
@@ -0,0 +1,145 @@
+#include "dbea/CompeteCache.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace dbea
+{
+    namespace
+    {
+        uint64_t mix(uint64_t h)
+        {
+            // splitmix64 finalizer
+            h ^= h >> 30;
+            h *= 0xBF58476D1CE4E5B9ull;
+            h ^= h >> 27;
+            h *= 0x94D049BB133111EBull;
+            return h ^ (h >> 31);
+        }
+    } // namespace
+
+    CompeteCache::CompeteCache(size_t cap, double res, double tol)
+        : capacity(std::max<size_t>(1, cap)), resolution(res), tolerance(tol)
+    {
+    }
+
+    void CompeteCache::invalidate()
+    {
+        ++current_epoch;
+        stats.invalidations++;
+    }
+
+    const CompeteCache::Entry *CompeteCache::find(const Real *features, size_t width)
+    {
+        probe.resize(width);
+        uint64_t key = mix(static_cast<uint64_t>(width));
+        for (size_t k = 0; k < width; ++k)
+        {
+            const double scaled = static_cast<double>(features[k]) * resolution;
+            // Non-finite features all share one code; clamping keeps llround defined
+            probe[k] = std::isfinite(scaled) ? std::llround(std::clamp(scaled, -1e18, 1e18))
+                                             : std::numeric_limits<int64_t>::min();
+            key = mix(key ^ static_cast<uint64_t>(probe[k]));
+        }
+        probe_key = key;
+
+        auto it = entries.find(key);
+        if (it == entries.end() || it->second.codes != probe)
+        {
+            stats.misses++;
+            return nullptr;
+        }
+        if (it->second.epoch != current_epoch)
+        {
+            stats.misses++;
+            stats.stale++;
+            return nullptr;
+        }
+        stats.hits++;
+        return &it->second;
+    }
+
+    void CompeteCache::store(const std::vector<Real> &activations, double total, size_t winner_row)
+    {
+        auto it = entries.find(probe_key);
+        if (it == entries.end())
+        {
+            make_room();
+            it = entries.emplace(probe_key, Entry{}).first;
+        }
+        // A colliding key is overwritten; buffers of a refreshed entry are reused
+        Entry &entry = it->second;
+        entry.codes.assign(probe.begin(), probe.end());
+        entry.epoch = current_epoch;
+        entry.activations.assign(activations.begin(), activations.end());
+        entry.total = total;
+        entry.winner_row = winner_row;
+    }
+
+    void CompeteCache::make_room()
+    {
+        if (entries.size() < capacity)
+            return;
+        // Entries from older epochs can never hit again; drop them first
+        for (auto it = entries.begin(); it != entries.end();)
+        {
+            if (it->second.epoch != current_epoch)
+            {
+                it = entries.erase(it);
+                stats.evictions++;
+            }
+            else
+                ++it;
+        }
+        if (entries.size() >= capacity)
+        {
+            stats.evictions += entries.size();
+            entries.clear();
+        }
+    }
+
+    void CompeteCache::track(const BeliefNode *node)
+    {
+        confidence_mark[node] = node->confidence;
+    }
+
+    void CompeteCache::forget(const BeliefNode *node)
+    {
+        confidence_mark.erase(node);
+    }
+
+    void CompeteCache::replace(const BeliefNode *old, const BeliefNode *now)
+    {
+        auto it = confidence_mark.find(old);
+        if (it == confidence_mark.end())
+            return;
+        Real mark = it->second;
+        confidence_mark.erase(it);
+        confidence_mark.emplace(now, mark);
+    }
+
+    void CompeteCache::note_confidence(const BeliefNode *node)
+    {
+        auto it = confidence_mark.find(node);
+        if (it == confidence_mark.end())
+        {
+            confidence_mark.emplace(node, node->confidence);
+            invalidate();
+            return;
+        }
+        // Marks move only when the epoch does, so small steps add up until they cross the tolerance
+        if (std::abs(static_cast<double>(node->confidence) - static_cast<double>(it->second)) > tolerance)
+        {
+            it->second = node->confidence;
+            invalidate();
+        }
+    }
+
+    void CompeteCache::rebuild(const std::vector<std::shared_ptr<BeliefNode>> &nodes)
+    {
+        confidence_mark.clear();
+        for (const auto &node : nodes)
+            confidence_mark.emplace(node.get(), node->confidence);
+        invalidate();
+    }
+} // namespace dbea
@@ -0,0 +1,332 @@
+#include "dbea/IslandModel.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+namespace dbea
+{
+    namespace
+    {
+        constexpr uint32_t kIslandMagic = 0x44424549; // "DBEI"
+        constexpr uint32_t kIslandVersion = 1;
+        constexpr size_t kInboxSlots = 64;             // power of two
+        constexpr size_t kMigrantMaxFeatures = 16;
+        constexpr size_t kMigrantMaxActions = 8;
+        constexpr size_t kMigrantMaxAffinity = 8;
+
+        static_assert((kInboxSlots & (kInboxSlots - 1)) == 0, "inbox size must be a power of two");
+        static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared-memory ring needs lock-free atomics");
+
+        // Fixed-size, trivially copyable belief image. Always double so islands
+        // built with different numeric settings can still exchange beliefs.
+        struct MigrantRecord
+        {
+            uint32_t source_island;
+            uint32_t num_features;
+            uint32_t num_actions;
+            uint32_t num_affinity;
+            int32_t evidence_count;
+            double confidence;
+            double fitness;
+            double mutation_rate;
+            double local_lr;
+            double features[kMigrantMaxFeatures];
+            int32_t action_ids[kMigrantMaxActions];
+            double action_values[kMigrantMaxActions];
+            double affinity[kMigrantMaxAffinity];
+        };
+
+        // Bounded multi-producer ring (Vyukov); each island is the single consumer of its inbox
+        struct InboxCell
+        {
+            std::atomic<uint64_t> sequence;
+            MigrantRecord record;
+        };
+
+        struct Inbox
+        {
+            alignas(64) std::atomic<uint64_t> enqueue_pos;
+            alignas(64) std::atomic<uint64_t> dequeue_pos;
+            std::atomic<uint64_t> dropped;
+            InboxCell cells[kInboxSlots];
+        };
+
+        struct IslandHeader
+        {
+            std::atomic<uint32_t> magic;
+            uint32_t version;
+            uint32_t num_islands;
+            std::atomic<uint32_t> attached;
+        };
+
+        size_t header_bytes()
+        {
+            return (sizeof(IslandHeader) + 63) & ~static_cast<size_t>(63);
+        }
+
+        IslandHeader *header_of(const SharedMemoryRegion &region)
+        {
+            return static_cast<IslandHeader *>(region.data());
+        }
+
+        Inbox *inbox_of(const SharedMemoryRegion &region, int island)
+        {
+            auto *base = static_cast<char *>(region.data()) + header_bytes();
+            return reinterpret_cast<Inbox *>(base) + island;
+        }
+
+        bool push(Inbox &inbox, const MigrantRecord &record)
+        {
+            uint64_t pos = inbox.enqueue_pos.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                InboxCell &cell = inbox.cells[pos & (kInboxSlots - 1)];
+                uint64_t seq = cell.sequence.load(std::memory_order_acquire);
+                int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+                if (diff == 0)
+                {
+                    if (inbox.enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        cell.record = record;
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    // Inbox full: the receiving island is slow or gone, drop the migrant
+                    inbox.dropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                else
+                {
+                    pos = inbox.enqueue_pos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        bool pop(Inbox &inbox, MigrantRecord &out)
+        {
+            uint64_t pos = inbox.dequeue_pos.load(std::memory_order_relaxed);
+            InboxCell &cell = inbox.cells[pos & (kInboxSlots - 1)];
+            uint64_t seq = cell.sequence.load(std::memory_order_acquire);
+            if (static_cast<int64_t>(seq) - static_cast<int64_t>(pos + 1) < 0)
+                return false;
+            out = cell.record;
+            cell.sequence.store(pos + kInboxSlots, std::memory_order_release);
+            inbox.dequeue_pos.store(pos + 1, std::memory_order_relaxed);
+            return true;
+        }
+
+        bool fits_record(const BeliefNode &node)
+        {
+            return node.prototype.features.size() <= kMigrantMaxFeatures &&
+                   node.action_values.size() <= kMigrantMaxActions &&
+                   node.emotional_affinity.size() <= kMigrantMaxAffinity;
+        }
+
+        // Callers check fits_record() first
+        MigrantRecord to_record(const BeliefNode &node, int island)
+        {
+            MigrantRecord rec{};
+            rec.source_island = static_cast<uint32_t>(island);
+            rec.evidence_count = node.evidence_count;
+            rec.confidence = node.confidence;
+            rec.fitness = node.fitness;
+            rec.mutation_rate = node.mutation_rate;
+            rec.local_lr = node.local_lr;
+            rec.num_features = static_cast<uint32_t>(node.prototype.features.size());
+            for (uint32_t i = 0; i < rec.num_features; ++i)
+                rec.features[i] = node.prototype.features[i];
+            for (const auto &[id, val] : node.action_values)
+            {
+                rec.action_ids[rec.num_actions] = id;
+                rec.action_values[rec.num_actions] = val;
+                rec.num_actions++;
+            }
+            rec.num_affinity = static_cast<uint32_t>(node.emotional_affinity.size());
+            for (uint32_t i = 0; i < rec.num_affinity; ++i)
+                rec.affinity[i] = node.emotional_affinity[i];
+            return rec;
+        }
+    } // namespace
+
+    IslandModel::IslandModel(const Config &cfg) : config(cfg)
+    {
+        if (config.num_islands < 1 || config.island_id < 0 || config.island_id >= config.num_islands)
+            throw std::runtime_error("Invalid island configuration: id " + std::to_string(config.island_id) +
+                                     " of " + std::to_string(config.num_islands));
+
+        size_t bytes = header_bytes() + sizeof(Inbox) * static_cast<size_t>(config.num_islands);
+        if (config.island_reset && config.island_id == 0)
+            SharedMemoryRegion::remove(config.island_shm_name);
+        auto try_attach = [&]
+        {
+            try
+            {
+                return attach_segment(bytes);
+            }
+            catch (const std::runtime_error &)
+            {
+                return false; // e.g. the smaller segment of a crashed run with fewer islands
+            }
+        };
+        bool attached = try_attach();
+        if (!attached && config.island_id == 0)
+        {
+            // A segment of another layout is a crashed run's; island 0 replaces it
+            if (config.verbose)
+                std::cout << "[NDBE] Replacing stale island segment " << config.island_shm_name << "\n";
+            region.close();
+            SharedMemoryRegion::remove(config.island_shm_name);
+            attached = attach_segment(bytes);
+        }
+        // The other islands wait for island 0 to replace it, so they all attach to the same one
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (!attached && std::chrono::steady_clock::now() < deadline)
+        {
+            region.close();
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            attached = try_attach();
+        }
+        if (!attached)
+            throw std::runtime_error("Island segment " + config.island_shm_name + " does not match " +
+                                     std::to_string(config.num_islands) + " islands; start island 0 to replace it");
+        header_of(region)->attached.fetch_add(1, std::memory_order_acq_rel);
+
+        int n = config.num_islands;
+        int self = config.island_id;
+        if (config.island_topology == "full")
+        {
+            for (int i = 0; i < n; ++i)
+                if (i != self)
+                    neighbor_ids.push_back(i);
+        }
+        else if (config.island_topology == "star")
+        {
+            if (self == 0)
+            {
+                for (int i = 1; i < n; ++i)
+                    neighbor_ids.push_back(i);
+            }
+            else
+                neighbor_ids.push_back(0);
+        }
+        else if (config.island_topology == "ring")
+        {
+            if (n > 1)
+                neighbor_ids.push_back((self + 1) % n);
+        }
+        else
+            throw std::runtime_error("Unknown island topology: " + config.island_topology);
+
+        if (config.verbose)
+            std::cout << "[NDBE] Island " << self << " / " << n << " attached (" << config.island_topology
+                      << ", " << neighbor_ids.size() << " neighbours)\n";
+    }
+
+    bool IslandModel::attach_segment(size_t bytes)
+    {
+        bool created = region.open_or_create(config.island_shm_name, bytes);
+        IslandHeader *header = header_of(region);
+        if (created)
+        {
+            header->version = kIslandVersion;
+            header->num_islands = static_cast<uint32_t>(config.num_islands);
+            for (int i = 0; i < config.num_islands; ++i)
+            {
+                Inbox *inbox = inbox_of(region, i);
+                for (size_t c = 0; c < kInboxSlots; ++c)
+                    inbox->cells[c].sequence.store(c, std::memory_order_relaxed);
+            }
+            header->magic.store(kIslandMagic, std::memory_order_release);
+            return true;
+        }
+        for (int tries = 0; tries < 1000 && header->magic.load(std::memory_order_acquire) != kIslandMagic; ++tries)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return header->magic.load(std::memory_order_acquire) == kIslandMagic && header->version == kIslandVersion &&
+               header->num_islands == static_cast<uint32_t>(config.num_islands);
+    }
+
+    IslandModel::~IslandModel()
+    {
+        if (!region.is_open())
+            return;
+        // Last island out removes the segment so the next run starts clean
+        if (header_of(region)->attached.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            region.unlink();
+        region.close();
+    }
+
+    void IslandModel::migrate(BeliefGraph &graph)
+    {
+        size_t sent = emigrate(graph);
+        size_t received = immigrate(graph);
+        if (config.verbose)
+            std::cout << "[NDBE] Island " << config.island_id << " migration | Sent: " << sent
+                      << " | Received: " << received << " | Oversized: " << oversized << " | Malformed: " << malformed
+                      << " | Pop: " << graph.nodes.size() << std::endl;
+    }
+
+    size_t IslandModel::emigrate(const BeliefGraph &graph)
+    {
+        if (neighbor_ids.empty() || graph.nodes.empty())
+            return 0;
+        size_t count = static_cast<size_t>(std::ceil(config.migration_rate * graph.nodes.size()));
+        auto emigrants = graph.top_by_fitness(count);
+
+        size_t sent = 0;
+        for (const auto &node : emigrants)
+        {
+            // A cut-down prototype would land in the wrong width partition elsewhere
+            if (!fits_record(*node))
+            {
+                oversized++;
+                continue;
+            }
+            MigrantRecord rec = to_record(*node, config.island_id);
+            for (int target : neighbor_ids)
+                sent += push(*inbox_of(region, target), rec) ? 1 : 0;
+        }
+        return sent;
+    }
+
+    size_t IslandModel::immigrate(BeliefGraph &graph)
+    {
+        Inbox &inbox = *inbox_of(region, config.island_id);
+        MigrantRecord rec;
+        size_t received = 0;
+        while (pop(inbox, rec))
+        {
+            // Any process can attach to the segment, so the counts are checked before use
+            if (rec.num_features > kMigrantMaxFeatures || rec.num_actions > kMigrantMaxActions ||
+                rec.num_affinity > kMigrantMaxAffinity)
+            {
+                malformed++;
+                continue;
+            }
+            std::vector<Real> features(rec.features, rec.features + rec.num_features);
+            auto node = std::make_shared<BeliefNode>(graph.new_belief_id(), PatternSignature(features));
+            node->evidence_count = rec.evidence_count;
+            node->confidence = rec.confidence * 0.8; // same discount as evolved children
+            node->fitness = rec.fitness;
+            node->mutation_rate = rec.mutation_rate;
+            node->local_lr = rec.local_lr;
+            for (uint32_t i = 0; i < rec.num_actions; ++i)
+                node->action_values[rec.action_ids[i]] = rec.action_values[i];
+            node->emotional_affinity.assign(rec.affinity, rec.affinity + rec.num_affinity);
+            graph.add_belief(node);
+            received++;
+        }
+        return received;
+    }
+
+    uint64_t IslandModel::dropped_migrants() const
+    {
+        return inbox_of(region, config.island_id)->dropped.load(std::memory_order_relaxed);
+    }
+} // namespace dbea
@@ -0,0 +1,89 @@
+#include "dbea/MaintenanceScheduler.h"
+#include <algorithm>
+#include <limits>
+
+namespace dbea
+{
+    MaintenanceScheduler::MaintenanceScheduler(size_t ops, double micros)
+        : ops_per_step(ops),
+          time_per_step(std::chrono::nanoseconds(static_cast<int64_t>(micros * 1000.0)))
+    {
+    }
+
+    void MaintenanceScheduler::begin_step()
+    {
+        spent = 0;
+        limit = ops_per_step;
+        timed = time_per_step.count() > 0;
+        if (timed)
+            deadline = std::chrono::steady_clock::now() + time_per_step;
+        stats.steps++;
+    }
+
+    void MaintenanceScheduler::begin_unbounded()
+    {
+        spent = 0;
+        limit = std::numeric_limits<size_t>::max();
+        timed = false;
+    }
+
+    bool MaintenanceScheduler::spend(size_t ops)
+    {
+        if (exhausted())
+            return false;
+        if (timed && std::chrono::steady_clock::now() >= deadline)
+        {
+            limit = spent;
+            return false;
+        }
+        spent = (ops > limit - spent) ? limit : spent + ops;
+        if (spent > stats.max_ops_step && limit != std::numeric_limits<size_t>::max())
+            stats.max_ops_step = spent;
+        return true;
+    }
+
+    void MaintenanceScheduler::mark_dirty(BeliefNode *node)
+    {
+        if (dirty.insert(node).second)
+            queue.push_back(node);
+    }
+
+    void MaintenanceScheduler::forget(const BeliefNode *node)
+    {
+        // The stale queue entry is skipped by next_dirty()
+        dirty.erase(node);
+    }
+
+    void MaintenanceScheduler::replace(const BeliefNode *old, BeliefNode *now)
+    {
+        if (!dirty.erase(old))
+            return;
+        dirty.insert(now);
+        std::replace(queue.begin(), queue.end(), const_cast<BeliefNode *>(old), now);
+    }
+
+    BeliefNode *MaintenanceScheduler::next_dirty()
+    {
+        while (!queue.empty())
+        {
+            BeliefNode *node = queue.front();
+            queue.pop_front();
+            if (dirty.erase(node))
+                return node;
+        }
+        return nullptr;
+    }
+
+    void MaintenanceScheduler::clear()
+    {
+        queue.clear();
+        dirty.clear();
+    }
+
+    size_t MaintenanceScheduler::next_sweep_slot(size_t population)
+    {
+        if (sweep_slot >= population)
+            sweep_slot = 0;
+        return sweep_slot++;
+    }
+} // namespace dbea
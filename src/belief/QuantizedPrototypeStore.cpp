@@ -0,0 +1,242 @@
+#include "dbea/QuantizedPrototypeStore.h"
+#include <algorithm>
+#include <cmath>
+
+namespace dbea
+{
+    namespace
+    {
+        constexpr float kCodeLevels = 254.0f;     // codes span [-127, 127]
+        constexpr float kRangeMargin = 0.05f;     // head-room added on recalibration
+        constexpr float kMinSpan = 1e-3f;
+        constexpr float kWeightUnit = 64.0f;      // weight of the finest dimension
+        constexpr uint32_t kMaxWeight = 1u << 16; // keeps the integer accumulator far from overflow
+        // Rounding weights to integers overstates scale^2 by at most half a unit
+        constexpr float kWeightSlack = 1.0f - 0.5f / kWeightUnit;
+    } // namespace
+
+    void QuantizedPrototypeStore::clear()
+    {
+        groups.clear();
+        location.clear();
+        screen_group = nullptr;
+    }
+
+    void QuantizedPrototypeStore::rebuild(const std::vector<std::shared_ptr<BeliefNode>> &nodes)
+    {
+        clear();
+        for (const auto &node : nodes)
+        {
+            size_t width = node->prototype.features.size();
+            if (width == 0)
+                continue;
+            Group &g = group_for(width);
+            location[node.get()] = g.owners.size();
+            g.owners.push_back(node.get());
+        }
+        for (auto &[width, g] : groups)
+            recalibrate(g);
+    }
+
+    QuantizedPrototypeStore::Group &QuantizedPrototypeStore::group_for(size_t width)
+    {
+        Group &g = groups[width];
+        g.width = width;
+        return g;
+    }
+
+    void QuantizedPrototypeStore::recalibrate(Group &g)
+    {
+        const size_t w = g.width;
+        std::vector<float> lo(w, 0.0f), hi(w, 0.0f);
+        bool first = true;
+        auto widen = [&](const Real *x)
+        {
+            for (size_t d = 0; d < w; ++d)
+            {
+                float v = static_cast<float>(x[d]);
+                lo[d] = first ? v : std::min(lo[d], v);
+                hi[d] = first ? v : std::max(hi[d], v);
+            }
+            first = false;
+        };
+        for (const BeliefNode *owner : g.owners)
+            widen(owner->prototype.features.data());
+
+        g.offset.resize(w);
+        g.scale.resize(w);
+        g.weight.resize(w);
+        float min_scale = 0.0f;
+        float sum_sq_scale = 0.0f;
+        for (size_t d = 0; d < w; ++d)
+        {
+            float span = std::max(hi[d] - lo[d], kMinSpan);
+            g.offset[d] = lo[d] - kRangeMargin * span;
+            g.scale[d] = span * (1.0f + 2.0f * kRangeMargin) / kCodeLevels;
+            min_scale = (d == 0) ? g.scale[d] : std::min(min_scale, g.scale[d]);
+            sum_sq_scale += g.scale[d] * g.scale[d];
+        }
+        for (size_t d = 0; d < w; ++d)
+        {
+            float ratio = g.scale[d] / min_scale;
+            g.weight[d] = static_cast<uint32_t>(std::min(static_cast<float>(kMaxWeight), std::round(kWeightUnit * ratio * ratio)));
+        }
+        g.min_scale = min_scale;
+        g.code_error = 0.5f * std::sqrt(sum_sq_scale);
+
+        g.codes.resize(g.owners.size() * w);
+        for (size_t row = 0; row < g.owners.size(); ++row)
+            encode(g, g.owners[row]->prototype.features.data(), &g.codes[row * w]);
+    }
+
+    void QuantizedPrototypeStore::encode(const Group &g, const Real *features, int8_t *out) const
+    {
+        for (size_t d = 0; d < g.width; ++d)
+        {
+            float q = std::round((static_cast<float>(features[d]) - g.offset[d]) / g.scale[d]) - 127.0f;
+            out[d] = static_cast<int8_t>(std::clamp(q, -127.0f, 127.0f));
+        }
+    }
+
+    bool QuantizedPrototypeStore::in_range(const Group &g, const Real *features) const
+    {
+        for (size_t d = 0; d < g.width; ++d)
+        {
+            float q = (static_cast<float>(features[d]) - g.offset[d]) / g.scale[d];
+            if (q < 0.0f || q > kCodeLevels)
+                return false;
+        }
+        return true;
+    }
+
+    void QuantizedPrototypeStore::upsert(BeliefNode *node)
+    {
+        size_t width = node->prototype.features.size();
+        if (width == 0)
+            return;
+        Group &g = group_for(width);
+        const Real *features = node->prototype.features.data();
+
+        auto it = location.find(node);
+        if (it == location.end())
+        {
+            location[node] = g.owners.size();
+            g.owners.push_back(node);
+            g.codes.resize(g.owners.size() * width);
+            if (g.offset.empty() || !in_range(g, features))
+                recalibrate(g);
+            else
+                encode(g, features, &g.codes[(g.owners.size() - 1) * width]);
+            return;
+        }
+
+        if (!in_range(g, features))
+            recalibrate(g);
+        else
+            encode(g, features, &g.codes[it->second * width]);
+    }
+
+    void QuantizedPrototypeStore::erase(const BeliefNode *node)
+    {
+        auto it = location.find(node);
+        if (it == location.end())
+            return;
+        Group &g = groups[node->prototype.features.size()];
+        size_t row = it->second;
+        size_t last = g.owners.size() - 1;
+        if (row != last)
+        {
+            // Swap-remove keeps rows dense
+            g.owners[row] = g.owners[last];
+            std::copy(g.codes.begin() + last * g.width, g.codes.begin() + (last + 1) * g.width,
+                      g.codes.begin() + row * g.width);
+            location[g.owners[row]] = row;
+        }
+        g.owners.pop_back();
+        g.codes.resize(g.owners.size() * g.width);
+        location.erase(it);
+    }
+
+    void QuantizedPrototypeStore::replace(const BeliefNode *old, BeliefNode *now)
+    {
+        auto it = location.find(old);
+        if (it == location.end())
+            return;
+        size_t row = it->second;
+        location.erase(it);
+        groups[now->prototype.features.size()].owners[row] = now;
+        location[now] = row;
+    }
+
+    bool QuantizedPrototypeStore::begin_screen(const Real *features, size_t width)
+    {
+        screen_group = nullptr;
+        auto git = groups.find(width);
+        if (git == groups.end() || git->second.owners.empty())
+            return false;
+        const Group &g = git->second;
+
+        query_codes.resize(width);
+        encode(g, features, query_codes.data());
+        // The query may lie outside the calibrated range, so measure its error exactly
+        float sq = 0.0f;
+        for (size_t d = 0; d < width; ++d)
+        {
+            float decoded = g.offset[d] + (static_cast<float>(query_codes[d]) + 127.0f) * g.scale[d];
+            float e = static_cast<float>(features[d]) - decoded;
+            sq += e * e;
+        }
+        query_error = std::sqrt(sq);
+
+        // Integer screening pass over the packed codes
+        const size_t rows = g.owners.size();
+        scored.resize(rows);
+        const int8_t *codes = g.codes.data();
+        for (size_t row = 0; row < rows; ++row)
+        {
+            uint64_t dist = 0;
+            for (size_t d = 0; d < width; ++d)
+            {
+                int32_t diff = static_cast<int32_t>(codes[row * width + d]) - query_codes[d];
+                dist += static_cast<uint64_t>(g.weight[d]) * static_cast<uint64_t>(diff * diff);
+            }
+            scored[row] = {dist, row};
+        }
+        screen_cursor = 0;
+        screen_group = &g;
+        return true;
+    }
+
+    size_t QuantizedPrototypeStore::next_candidates(size_t count, std::vector<Candidate> &out)
+    {
+        out.clear();
+        if (!screen_group || screen_cursor >= scored.size())
+            return 0;
+        const Group &g = *screen_group;
+
+        auto first = scored.begin() + screen_cursor;
+        size_t n = std::min(count, scored.size() - screen_cursor);
+        if (first + n != scored.end())
+            std::nth_element(first, first + n, scored.end());
+        std::sort(first, first + n);
+
+        out.reserve(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            const auto &[dist, row] = first[i];
+            float approx = g.min_scale * std::sqrt(static_cast<float>(dist) * kWeightSlack / kWeightUnit);
+            float bound = std::max(0.0f, approx - g.code_error - static_cast<float>(query_error));
+            out.push_back({static_cast<Real>(bound), g.owners[row]});
+        }
+        screen_cursor += n;
+        return n;
+    }
+
+    size_t QuantizedPrototypeStore::code_bytes() const
+    {
+        size_t bytes = 0;
+        for (const auto &[width, g] : groups)
+            bytes += g.codes.size();
+        return bytes;
+    }
+} // namespace dbea
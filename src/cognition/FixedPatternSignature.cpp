@@ -0,0 +1,73 @@
+#include "dbea/FixedPatternSignature.h"
+
+namespace dbea
+{
+    namespace
+    {
+        Real generic_match(const Real *a, const Real *b, size_t width)
+        {
+            Real sum_sq_diff = 0.0;
+            for (size_t i = 0; i < width; ++i)
+            {
+                Real diff = a[i] - b[i];
+                sum_sq_diff += diff * diff;
+            }
+            Real normalized = Real(1.0) - (std::sqrt(sum_sq_diff) / std::sqrt(static_cast<Real>(width)));
+            return std::max(Real(0.0), normalized);
+        }
+
+        void generic_match_rows(const Real *input, const Real *rows, size_t count, size_t width, Real *out)
+        {
+            for (size_t r = 0; r < count; ++r)
+                out[r] = generic_match(input, rows + r * width, width);
+        }
+
+        void generic_blend(Real *out, const Real *previous, size_t width)
+        {
+            for (size_t i = 0; i < width; ++i)
+                out[i] = 0.95 * out[i] + 0.05 * previous[i];
+        }
+
+        template <size_t D>
+        Real fixed_match(const Real *a, const Real *b, size_t)
+        {
+            return fixed::match_score<D>(a, b);
+        }
+
+        template <size_t D>
+        void fixed_match_rows(const Real *input, const Real *rows, size_t count, size_t, Real *out)
+        {
+            // Hoisting the input lets the compiler keep it in registers across rows
+            std::array<Real, D> in;
+            std::copy(input, input + D, in.begin());
+            for (size_t r = 0; r < count; ++r)
+                out[r] = fixed::match_score<D>(in.data(), rows + r * D);
+        }
+
+        template <size_t D>
+        void fixed_blend(Real *out, const Real *previous, size_t)
+        {
+            fixed::blend<D>(out, previous);
+        }
+
+        template <size_t D>
+        constexpr PatternKernels fixed_kernels()
+        {
+            return PatternKernels{D, &fixed_match<D>, &fixed_match_rows<D>, &fixed_blend<D>};
+        }
+
+        constexpr PatternKernels kGeneric{0, &generic_match, &generic_match_rows, &generic_blend};
+        constexpr PatternKernels kFixed[] = {fixed_kernels<1>(), fixed_kernels<2>(), fixed_kernels<3>(),
+                                             fixed_kernels<4>(), fixed_kernels<6>(), fixed_kernels<8>()};
+    } // namespace
+
+    const PatternKernels &pattern_kernels(size_t width)
+    {
+        for (const auto &kernels : kFixed)
+        {
+            if (kernels.width == width)
+                return kernels;
+        }
+        return kGeneric;
+    }
+} // namespace dbea
@@ -0,0 +1,176 @@
+#include "dbea/NoveltyEstimator.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace dbea
+{
+    namespace
+    {
+        constexpr uint64_t kEmptyKey = std::numeric_limits<uint64_t>::max();
+
+        uint64_t mix64(uint64_t x)
+        {
+            // splitmix64 finaliser
+            x += 0x9E3779B97F4A7C15ull;
+            x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+            x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+            return x ^ (x >> 31);
+        }
+
+        size_t round_up_pow2(size_t n)
+        {
+            size_t p = 1;
+            while (p < n)
+                p <<= 1;
+            return p;
+        }
+    } // namespace
+
+    StateDiscretizer::StateDiscretizer(int resolution, size_t dims_)
+        : bins(std::max(1, resolution)), dims(dims_), scale(bins - 1e-3)
+    {
+    }
+
+    uint64_t StateDiscretizer::cell(const Real *features, size_t count) const
+    {
+        uint64_t h = count < dims ? count : dims;
+        for (size_t i = 0; i < dims && i < count; ++i)
+            h = mix64(h ^ static_cast<uint64_t>(bin(features[i])));
+        return h;
+    }
+
+    ExactVisitCounter::ExactVisitCounter(size_t initial_capacity)
+        : keys(round_up_pow2(std::max<size_t>(initial_capacity, 8)), kEmptyKey),
+          counts(keys.size(), 0)
+    {
+    }
+
+    size_t ExactVisitCounter::slot_of(uint64_t key) const
+    {
+        const size_t mask = keys.size() - 1;
+        size_t slot = static_cast<size_t>(mix64(key)) & mask;
+        while (keys[slot] != kEmptyKey && keys[slot] != key)
+            slot = (slot + 1) & mask;
+        return slot;
+    }
+
+    void ExactVisitCounter::grow()
+    {
+        std::vector<uint64_t> old_keys(keys.size() * 2, kEmptyKey);
+        std::vector<uint32_t> old_counts(counts.size() * 2, 0);
+        old_keys.swap(keys); // keys/counts are now the doubled, empty table
+        old_counts.swap(counts);
+        for (size_t i = 0; i < old_keys.size(); ++i)
+        {
+            if (old_keys[i] == kEmptyKey)
+                continue;
+            size_t slot = slot_of(old_keys[i]);
+            keys[slot] = old_keys[i];
+            counts[slot] = old_counts[i];
+        }
+    }
+
+    uint32_t ExactVisitCounter::visit(uint64_t cell)
+    {
+        if (cell == kEmptyKey)
+            cell--; // reserved as the empty marker
+        size_t slot = slot_of(cell);
+        if (keys[slot] == kEmptyKey)
+        {
+            if ((used + 1) * 10 > keys.size() * 7)
+            {
+                grow();
+                slot = slot_of(cell);
+            }
+            keys[slot] = cell;
+            used++;
+        }
+        if (counts[slot] < std::numeric_limits<uint32_t>::max())
+            counts[slot]++;
+        return counts[slot];
+    }
+
+    uint32_t ExactVisitCounter::count(uint64_t cell) const
+    {
+        if (cell == kEmptyKey)
+            cell--;
+        size_t slot = slot_of(cell);
+        return keys[slot] == kEmptyKey ? 0 : counts[slot];
+    }
+
+    void ExactVisitCounter::clear()
+    {
+        std::fill(keys.begin(), keys.end(), kEmptyKey);
+        std::fill(counts.begin(), counts.end(), 0);
+        used = 0;
+    }
+
+    size_t ExactVisitCounter::memory_bytes() const
+    {
+        return keys.size() * sizeof(uint64_t) + counts.size() * sizeof(uint32_t);
+    }
+
+    std::unique_ptr<NoveltyEstimator> ExactVisitCounter::clone() const
+    {
+        return std::make_unique<ExactVisitCounter>(*this);
+    }
+
+    CountMinSketch::CountMinSketch(size_t width, size_t depth_)
+        : width_mask(round_up_pow2(std::max<size_t>(width, 16)) - 1),
+          depth(std::max<size_t>(depth_, 1)),
+          table((width_mask + 1) * depth, 0)
+    {
+    }
+
+    size_t CountMinSketch::index(uint64_t cell, size_t row) const
+    {
+        // Double hashing: row i probes h1 + i * h2
+        uint64_t h1 = mix64(cell);
+        uint64_t h2 = mix64(h1) | 1;
+        return row * (width_mask + 1) + static_cast<size_t>((h1 + row * h2) & width_mask);
+    }
+
+    uint32_t CountMinSketch::visit(uint64_t cell)
+    {
+        uint32_t estimate = count(cell);
+        if (estimate == std::numeric_limits<uint32_t>::max())
+            return estimate;
+        // Conservative update: only raise the counters that hold the minimum
+        for (size_t row = 0; row < depth; ++row)
+        {
+            uint32_t &counter = table[index(cell, row)];
+            if (counter == estimate)
+                counter = estimate + 1;
+        }
+        return estimate + 1;
+    }
+
+    uint32_t CountMinSketch::count(uint64_t cell) const
+    {
+        uint32_t estimate = std::numeric_limits<uint32_t>::max();
+        for (size_t row = 0; row < depth; ++row)
+            estimate = std::min(estimate, table[index(cell, row)]);
+        return estimate;
+    }
+
+    void CountMinSketch::clear()
+    {
+        std::fill(table.begin(), table.end(), 0);
+    }
+
+    std::unique_ptr<NoveltyEstimator> CountMinSketch::clone() const
+    {
+        return std::make_unique<CountMinSketch>(*this);
+    }
+
+    std::unique_ptr<NoveltyEstimator> make_novelty_estimator(const Config &cfg)
+    {
+        if (cfg.novelty_mode == "exact")
+            return std::make_unique<ExactVisitCounter>();
+        if (cfg.novelty_mode == "sketch")
+            return std::make_unique<CountMinSketch>(static_cast<size_t>(std::max(1, cfg.novelty_sketch_width)),
+                                                    static_cast<size_t>(std::max(1, cfg.novelty_sketch_depth)));
+        throw std::runtime_error("Unknown novelty mode: " + cfg.novelty_mode);
+    }
+} // namespace dbea
@@ -1,3 +1,3 @@
 #include "dbea/PatternSignature.h"
 
-PatternSignature::PatternSignature(const std::vector<double>& feats) : features(feats) {}
+PatternSignature::PatternSignature(const std::vector<dbea::Real>& feats) : features(feats) {}
@@ -0,0 +1,79 @@
+#include "dbea/Config.h"
+#include <functional>
+#include <stdexcept>
+#include <unordered_map>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+// Name table for scenario/sweep files; keep in step with the fields in Config.h
+#define DBEA_CONFIG_FIELDS(X)                                                              \
+    X(verbose) X(seed)                                                                     \
+    X(max_beliefs) X(retention_score)                                                      \
+    X(exploration_rate) X(learning_rate) X(belief_learning_rate) X(belief_decay_rate)      \
+    X(merge_threshold) X(debug_merging)                                                    \
+    X(curiosity_boost) X(curiosity_decay) X(curiosity_threshold) X(curiosity_threshold_drop) \
+    X(max_explore_streak) X(streak_punish_prob) X(streak_punish_amount) X(therapy_mode)    \
+    X(epsilon_decay) X(min_exploration) X(explore_bias_scale) X(gamma)                     \
+    X(min_beliefs_before_prune)                                                            \
+    X(evo_cycle_freq) X(crisis_reward_thresh) X(niche_bonus_scale) X(symbiotic_uplift)     \
+    X(niche_radius) X(co_activation_thresh) X(symbiosis_prob) X(parasite_tau) X(parasite_phi) \
+    X(island_mode) X(island_id) X(num_islands) X(island_topology) X(island_shm_name)       \
+    X(island_reset) X(migration_interval) X(migration_rate)                                \
+    X(replay_capacity) X(replay_max_features) X(replay_alpha) X(replay_beta)               \
+    X(replay_priority_eps) X(replay_learning_rate) X(replay_every) X(replay_batch_size)    \
+    X(quantized_screening) X(quantized_shortlist) X(quantized_min_population)              \
+    X(compete_cache_entries) X(compete_cache_resolution) X(compete_cache_tolerance)        \
+    X(compete_threads) X(compete_parallel_min) X(compete_shard_rows)                       \
+    X(cold_tier_window) X(cold_tier_activation) X(cold_tier_interval) X(cold_tier_resolution) \
+    X(novelty_mode) X(novelty_resolution) X(novelty_dims) X(novelty_sketch_width)          \
+    X(novelty_sketch_depth)                                                                \
+    X(maintenance_mode) X(maintenance_budget_ops) X(maintenance_budget_us)                 \
+    X(maintenance_interval) X(record_trace)                                                \
+    X(telemetry_shm) X(telemetry_interval) X(telemetry_max_beliefs)                        \
+    X(actor_threads) X(actor_queue_capacity) X(actor_backpressure) X(actor_snapshot_interval) \
+    X(actor_max_staleness) X(learner_batch)                                                \
+    X(decision_mode) X(decision_order) X(decision_budget_us) X(decision_max_beliefs)
+
+namespace
+{
+    using Setter = std::function<void(Config &, const json &)>;
+
+    const std::unordered_map<std::string, Setter> &config_setters()
+    {
+#define DBEA_CONFIG_SETTER(name) {#name, [](Config &c, const json &v) { v.get_to(c.name); }},
+        static const std::unordered_map<std::string, Setter> setters = {DBEA_CONFIG_FIELDS(DBEA_CONFIG_SETTER)};
+#undef DBEA_CONFIG_SETTER
+        return setters;
+    }
+} // namespace
+
+void apply_config_json(Config &cfg, const json &j)
+{
+    if (!j.is_object())
+        throw std::runtime_error("Config overrides must be a JSON object");
+    const auto &setters = config_setters();
+    for (const auto &[key, value] : j.items())
+    {
+        auto it = setters.find(key);
+        if (it == setters.end())
+            throw std::runtime_error("Unknown config field: " + key);
+        try
+        {
+            it->second(cfg, value);
+        }
+        catch (const json::exception &e)
+        {
+            throw std::runtime_error("Bad value for config field " + key + ": " + e.what());
+        }
+    }
+}
+
+json config_to_json(const Config &cfg)
+{
+    json j;
+#define DBEA_CONFIG_GETTER(name) j[#name] = cfg.name;
+    DBEA_CONFIG_FIELDS(DBEA_CONFIG_GETTER)
+#undef DBEA_CONFIG_GETTER
+    return j;
+}
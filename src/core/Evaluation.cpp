@@ -0,0 +1,125 @@
+#include "dbea/Evaluation.h"
+#include "dbea/FrozenAgent.h"
+#include "gridworld/GridWorld.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace dbea
+{
+    namespace
+    {
+        struct EpisodeOutcome
+        {
+            bool success = false;
+            int steps = 0;
+            double reward = 0.0;
+        };
+
+        double percentile(std::vector<float> &values, double p)
+        {
+            if (values.empty())
+                return 0.0;
+            size_t k = static_cast<size_t>(p * static_cast<double>(values.size() - 1) + 0.5);
+            std::nth_element(values.begin(), values.begin() + k, values.end());
+            return values[k];
+        }
+    } // namespace
+
+    EvaluationResult evaluate_gridworld(const FrozenAgent &policy, const EvaluationSpec &spec)
+    {
+        EvaluationResult result;
+        const size_t episodes = static_cast<size_t>(std::max(0, spec.episodes));
+        size_t workers = spec.threads > 0 ? static_cast<size_t>(spec.threads)
+                                          : std::max(1u, std::thread::hardware_concurrency());
+        workers = std::max<size_t>(1, std::min(workers, episodes));
+        auto start = std::chrono::steady_clock::now();
+
+        // Mapped once and shared read-only by every worker's GridWorld
+        std::shared_ptr<const GridMap> map = spec.map.empty() ? GridMap::builtin() : GridMap::open(spec.map);
+
+        std::vector<EpisodeOutcome> outcomes(episodes);
+        std::vector<std::vector<float>> latencies(workers); // per worker, microseconds per act()
+        std::atomic<size_t> next_episode{0};
+        std::exception_ptr failure;
+        std::mutex failure_mutex;
+        auto worker = [&](size_t w)
+        {
+            FrozenAgent::Episode state;
+            PatternSignature obs;
+            std::vector<float> &lat = latencies[w];
+            try
+            {
+                for (size_t ep = next_episode++; ep < episodes; ep = next_episode++)
+                {
+                    std::seed_seq seq{static_cast<uint32_t>(spec.seed), static_cast<uint32_t>(spec.seed >> 32),
+                                      static_cast<uint32_t>(ep)};
+                    std::mt19937 rng(seq);
+                    GridWorld env(map);
+                    state.reset();
+                    EpisodeOutcome &out = outcomes[ep];
+                    for (int step = 0; step < spec.max_steps && !env.is_done(); ++step)
+                    {
+                        env.observe_into(obs);
+                        auto t0 = std::chrono::steady_clock::now();
+                        const Action &action = policy.act(obs, rng, state);
+                        auto t1 = std::chrono::steady_clock::now();
+                        lat.push_back(std::chrono::duration<float, std::micro>(t1 - t0).count());
+                        out.reward += env.step(action);
+                        out.steps++;
+                    }
+                    out.success = env.is_done();
+                }
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(failure_mutex);
+                if (!failure)
+                    failure = std::current_exception();
+                next_episode = episodes; // stop the other workers early
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (size_t t = 1; t < workers; ++t)
+            pool.emplace_back(worker, t);
+        worker(0);
+        for (auto &t : pool)
+            t.join();
+        if (failure)
+            std::rethrow_exception(failure);
+
+        double total_steps = 0.0;
+        double total_reward = 0.0;
+        for (const auto &out : outcomes)
+        {
+            result.successes += out.success ? 1 : 0;
+            total_steps += out.steps;
+            total_reward += out.reward;
+        }
+        result.episodes = static_cast<int>(episodes);
+        if (episodes > 0)
+        {
+            result.success_rate = static_cast<double>(result.successes) / static_cast<double>(episodes);
+            result.mean_steps = total_steps / static_cast<double>(episodes);
+            result.mean_reward = total_reward / static_cast<double>(episodes);
+        }
+
+        std::vector<float> all;
+        for (auto &lat : latencies)
+            all.insert(all.end(), lat.begin(), lat.end());
+        result.act_p50_us = percentile(all, 0.50);
+        result.act_p90_us = percentile(all, 0.90);
+        result.act_p99_us = percentile(all, 0.99);
+        result.act_max_us = all.empty() ? 0.0 : *std::max_element(all.begin(), all.end());
+        result.threads = static_cast<int>(workers);
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+} // namespace dbea
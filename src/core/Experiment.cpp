@@ -0,0 +1,577 @@
+#include "dbea/Experiment.h"
+#include "dbea/ActorLearner.h"
+#include "dbea/Agent.h"
+#include "dbea/FrozenAgent.h"
+#include "dbea/PatternSignature.h"
+#include "gridworld/GridWorld.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <nlohmann/json.hpp>
+
+namespace dbea
+{
+    namespace
+    {
+        // Slowly evolve baseline personality across lifetimes
+        void evolve_personality_baseline(EmotionState &emotion, std::mt19937 &rng)
+        {
+            std::normal_distribution<double> noise(0.0, 0.015);
+            emotion.dominance = std::clamp(emotion.dominance * 0.985 + noise(rng), 0.0, 1.0);
+            emotion.fear = std::clamp(emotion.fear * 0.97 + noise(rng), 0.0, 1.0);
+            emotion.valence = 0.0;
+            emotion.curiosity = 0.5;
+            emotion.explore_bias = 0.0;
+        }
+
+        std::string output_path(const std::string &dir, const std::string &stem, const std::string &suffix,
+                                const std::string &ext)
+        {
+            return (std::filesystem::path(dir) / (stem + suffix + ext)).string();
+        }
+
+        void run_lifelong(Agent &agent, const Config &cfg, const LifelongScenario &sc, std::mt19937 &rng,
+                          const std::string &save_file, const std::string &emo_file, RunResult &result)
+        {
+            const bool verbose = cfg.verbose;
+            std::uniform_real_distribution<double> dist(0.0, 1.0);
+            std::ofstream emo_csv(emo_file, std::ios::trunc);
+            if (!emo_csv.is_open())
+                throw std::runtime_error("Failed to open " + emo_file + "!");
+            emo_csv << "Lifetime,Episode,Step,Valence,Fear,Dominance,ExploreBias,Phase\n";
+            emo_csv << std::fixed << std::setprecision(6);
+            std::string current_phase = "Normal";
+            int explore_streak = 0;
+
+            for (int life = 0; life < sc.num_lifetimes; ++life)
+            {
+                bool is_trauma = (life == sc.trauma_lifetime);
+                bool is_therapy = (life == sc.therapy_lifetime);
+                int episodes_this_life = is_therapy ? sc.therapy_episodes : sc.base_episodes;
+                if (is_trauma)
+                    current_phase = "Trauma";
+                else if (is_therapy)
+                    current_phase = "Therapy";
+                else
+                    current_phase = "Normal";
+                if (verbose)
+                    std::cout << "\n┌────────────────────────────────────┐\n"
+                              << "│ Starting Lifetime " << (life + 1) << " / " << sc.num_lifetimes << " "
+                              << " [" << current_phase << "] │\n└────────────────────────────────────┘\n";
+                if (life > 0)
+                {
+                    try
+                    {
+                        agent.load(save_file);
+                        EmotionState current = agent.get_emotion();
+                        evolve_personality_baseline(current, rng);
+                        agent.set_emotion(current);
+                    }
+                    catch (const std::exception &e)
+                    {
+                        std::cout << "Load failed: " << e.what() << "\n";
+                    }
+                }
+                agent.set_therapy_mode(is_therapy);
+                for (int ep = 0; ep < episodes_this_life; ++ep)
+                {
+                    if (verbose)
+                        std::cout << "\n=== Episode " << ep << " ===\n";
+                    agent.set_merge_threshold(0.92 - 0.01 * ep); // Adjusted for new merge_threshold
+                    if (is_therapy && ep >= 20)
+                    {
+                        current_phase = (ep < 25) ? "Post-Recovery Stress Test" : "Relapse Prevention";
+                        agent.set_therapy_mode(false);
+                    }
+                    for (int step = 0; step < sc.steps_per_episode; ++step)
+                    {
+                        int discrete_state = step % 4;
+                        std::uniform_real_distribution<double> small_noise(-0.01, 0.01);
+                        PatternSignature perception({static_cast<Real>(discrete_state), static_cast<Real>(0.3 + small_noise(rng))});
+                        agent.perceive(perception);
+                        Action action = agent.decide();
+                        bool is_trigger = (life > sc.trauma_lifetime && discrete_state % 4 == 2);
+                        double trigger_p = is_therapy ? sc.therapy_trigger_prob : sc.stress_trigger_prob;
+                        is_trigger = is_trigger && (dist(rng) < trigger_p);
+                        double r = dist(rng);
+                        double reward_valence, reward_surprise = 0.05 + dist(rng) * 0.1;
+                        if (is_therapy)
+                        {
+                            reward_valence = 0.1 + dist(rng) * 0.2;
+                            reward_surprise = 0.05 + dist(rng) * 0.05;
+                        }
+                        else if (is_trauma)
+                        {
+                            reward_valence = (r < 0.40) ? -0.45 - dist(rng) * 0.20 : (r < 0.60 ? 0.06 : 0.02) + dist(rng) * 0.06;
+                            if (r < 0.40)
+                                reward_surprise += 0.7;
+                        }
+                        else
+                        {
+                            reward_valence = (r < sc.mild_negative_prob) ? -sc.negative_valence_range * dist(rng) : 0.04 + dist(rng) * 0.08;
+                            if (r < sc.mild_negative_prob)
+                                reward_surprise += 0.2;
+                        }
+                        if (is_therapy && dist(rng) < sc.exposure_prob && std::string_view(action.name) == "noop")
+                        {
+                            agent.force_action("explore");
+                            action = agent.decide();
+                            reward_valence = 0.4;
+                            if (verbose)
+                                std::cout << "[DBEA] Exposure therapy: Forcing explore!\n";
+                        }
+                        if (is_trigger && agent.get_emotion().fear > 0.15)
+                        {
+                            reward_surprise += 0.25;
+                            if (verbose)
+                                std::cout << "[DBEA] Trigger activated!\n";
+                        }
+                        if (std::string_view(action.name) == "explore")
+                        {
+                            explore_streak++;
+                            if (explore_streak >= cfg.max_explore_streak && dist(rng) < cfg.streak_punish_prob)
+                            {
+                                reward_valence += cfg.streak_punish_amount;
+                            }
+                        }
+                        else
+                        {
+                            explore_streak = 0;
+                        }
+                        agent.receive_reward(reward_valence, reward_surprise);
+                        agent.learn();
+                        result.steps++;
+                        if (verbose)
+                        {
+                            std::cout << "Step " << step << " | Action: " << action.name
+                                      << " | Reward: " << reward_valence << " | Phase: " << current_phase << "\n";
+                            auto [n, e] = agent.get_proto_action_values();
+                            std::cout << "Proto-belief | Top: " << (e >= n ? "explore" : "noop")
+                                      << " | Values: (noop=" << n << ", explore=" << e << ")\n";
+                        }
+                        emo_csv << (life + 1) << "," << ep << "," << step << ","
+                                << agent.get_emotion().valence << ","
+                                << agent.get_emotion().fear << ","
+                                << agent.get_emotion().dominance << ","
+                                << agent.get_emotion().explore_bias << "," << current_phase << "\n";
+                    }
+                    agent.prune_beliefs(0.40);
+                }
+                try
+                {
+                    agent.save(save_file);
+                    if (verbose)
+                        std::cout << "Saved state after lifetime " << (life + 1) << "\n";
+                }
+                catch (const std::exception &e)
+                {
+                    std::cout << "Save failed: " << e.what() << "\n";
+                }
+            }
+        }
+
+        void run_gridworld(Agent &agent, const Config &cfg, const GridWorldScenario &sc, const std::string &grid_file,
+                           RunResult &result)
+        {
+            const bool verbose = cfg.verbose;
+            // Mapped, not loaded: concurrent runs of one map share its pages
+            std::shared_ptr<const GridMap> map = sc.map.empty() ? GridMap::builtin() : GridMap::open(sc.map);
+            if (cfg.actor_threads > 0)
+            {
+                // Actors step their own environments; the per-step trajectory log is serial-only
+                ActorLearner pipeline(agent, cfg, [map]()
+                                      { return std::make_unique<GridWorldEnvironment>(map); });
+                ActorLearner::Stats stats = pipeline.run(sc.episodes, sc.max_steps);
+                result.goals += stats.goals;
+                result.steps += stats.learned;
+                result.episodes = sc.episodes;
+                return;
+            }
+            dbea::GridWorld env(map);
+            env.reset();
+            agent.set_observation_dimension(env.dimension());
+            std::ofstream grid_log(grid_file);
+            grid_log << "Episode,Step,X,Y,Reward,Done\n";
+            PatternSignature obs; // reused every step
+            for (int ep = 0; ep < sc.episodes; ++ep)
+            {
+                env.reset();
+                double total_reward = 0.0;
+                int steps = 0;
+                bool done = false;
+                while (!done && steps < sc.max_steps)
+                {
+                    env.observe_into(obs);
+                    agent.perceive(obs);
+                    Action action = agent.decide();
+                    double reward = env.step(action);
+                    total_reward += reward;
+                    agent.receive_reward(reward, 0.05);
+                    agent.learn();
+                    auto pos = env.get_position();
+                    done = env.is_done();
+                    grid_log << ep << "," << steps << "," << pos.first << "," << pos.second
+                             << "," << reward << "," << (done ? "true" : "false") << "\n";
+                    steps++;
+                    if (done)
+                    {
+                        result.goals++;
+                        if (verbose)
+                            std::cout << "[SUCCESS] Goal reached in episode " << ep
+                                      << " after " << steps << " steps!\n";
+                    }
+                }
+                result.steps += static_cast<uint64_t>(steps);
+                if (verbose)
+                    std::cout << "Episode " << ep << " finished in " << steps
+                              << " steps | Total reward: " << total_reward << "\n";
+            }
+            result.episodes = sc.episodes;
+            if (verbose && cfg.decision_mode == "anytime")
+            {
+                const DecisionStats &d = agent.decision_stats();
+                std::cout << "[DBEA] Anytime decisions: " << d.decisions << " | Truncated: " << d.truncated
+                          << " | Coverage mean " << d.mean_coverage << " min " << d.min_coverage
+                          << " | Max scoring time: " << d.max_micros << " us\n";
+            }
+            if (verbose && agent.compete_cache_stats())
+            {
+                const CompeteCache::Stats &c = *agent.compete_cache_stats();
+                std::cout << "[DBEA] Compete cache: " << c.hits << " hits | " << c.misses << " misses ("
+                          << c.stale << " stale) | " << c.invalidations << " invalidations | " << c.evictions
+                          << " evictions\n";
+            }
+            if (verbose && agent.cold_tier_state())
+            {
+                const ColdBeliefStore &cold = *agent.cold_tier_state();
+                std::cout << "[DBEA] Cold tier: " << cold.size() << " beliefs in " << cold.bytes() << " bytes | "
+                          << cold.stats.demoted << " demoted | " << cold.stats.promoted << " promoted | "
+                          << agent.get_belief_count() << " hot\n";
+            }
+        }
+
+        EvaluationResult run_evaluation(const Agent &agent, const Config &cfg, const GridWorldScenario &sc)
+        {
+            EvaluationSpec spec;
+            spec.episodes = sc.eval_episodes;
+            spec.max_steps = sc.max_steps;
+            spec.threads = sc.eval_threads;
+            spec.seed = cfg.seed ? cfg.seed : std::random_device{}();
+            spec.map = sc.map;
+            FrozenAgent frozen(agent, sc.eval_epsilon);
+            EvaluationResult r = evaluate_gridworld(frozen, spec);
+            if (cfg.verbose)
+                std::cout << "[DBEA] Frozen evaluation: " << r.successes << " / " << r.episodes << " ("
+                          << 100.0 * r.success_rate << "%) | Mean steps " << r.mean_steps << " | Epsilon "
+                          << frozen.epsilon() << " | act() p50 " << r.act_p50_us << " p90 " << r.act_p90_us
+                          << " p99 " << r.act_p99_us << " max " << r.act_max_us << " us | " << r.threads
+                          << " threads, " << r.seconds << " s\n";
+            return r;
+        }
+    } // namespace
+
+    RunResult run_scenario(const Config &cfg, const Scenario &scenario, const std::string &output_dir,
+                           const std::string &file_suffix, Agent *base)
+    {
+        RunResult result;
+        result.seed = cfg.seed;
+        auto start = std::chrono::steady_clock::now();
+
+        std::filesystem::create_directories(output_dir);
+        const std::string save_file = output_path(output_dir, "agent_lifetime", file_suffix, ".json");
+        const std::string emo_file = output_path(output_dir, "emotion_trajectory_full", file_suffix, ".csv");
+        const std::string grid_file = output_path(output_dir, "gridworld_trajectory", file_suffix, ".csv");
+
+        // Scenario noise gets its own stream so it does not shift the agent's
+        std::mt19937 rng(cfg.seed ? static_cast<std::mt19937::result_type>(cfg.seed ^ 0x5DEECE66Dull)
+                                  : std::random_device{}());
+        std::unique_ptr<Agent> owned = base ? base->fork(cfg) : std::make_unique<Agent>(cfg);
+        Agent &agent = *owned;
+        if (!base && !scenario.checkpoint.empty())
+        {
+            agent.load(scenario.checkpoint);
+            if (cfg.verbose)
+                std::cout << "Loaded checkpoint " << scenario.checkpoint << "\n";
+        }
+        else if (!base && scenario.lifelong.enabled)
+        {
+            run_lifelong(agent, cfg, scenario.lifelong, rng, save_file, emo_file, result);
+
+            if (cfg.verbose)
+                std::cout << "\n=== Starting GridWorld Navigation Test ===\n";
+            agent.load(save_file);
+            if (cfg.verbose)
+                std::cout << "Healed agent loaded successfully.\n";
+        }
+        run_gridworld(agent, cfg, scenario.gridworld, grid_file, result);
+        if (scenario.gridworld.eval_episodes > 0)
+            result.evaluation = run_evaluation(agent, cfg, scenario.gridworld);
+
+        result.beliefs = agent.get_belief_count();
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (cfg.verbose)
+            std::cout << "\nGridWorld test complete.\n"
+                      << "Goals reached: " << result.goals << " / " << result.episodes
+                      << " (" << (result.episodes ? 100.0 * result.goals / result.episodes : 0.0) << "%)\n"
+                      << "Trajectory saved to " << grid_file << "\n";
+        return result;
+    }
+
+    namespace
+    {
+        std::string value_label(const json &v)
+        {
+            return v.is_string() ? v.get<std::string>() : v.dump();
+        }
+
+        void read_scenario(const json &j, Scenario &sc)
+        {
+            sc.name = j.value("name", sc.name);
+            sc.checkpoint = j.value("checkpoint", sc.checkpoint);
+            if (j.contains("lifelong"))
+            {
+                const json &l = j["lifelong"];
+                if (l.is_boolean())
+                    sc.lifelong.enabled = l.get<bool>();
+                else
+                {
+                    auto &life = sc.lifelong;
+                    life.enabled = l.value("enabled", true);
+                    life.num_lifetimes = l.value("num_lifetimes", life.num_lifetimes);
+                    life.base_episodes = l.value("base_episodes", life.base_episodes);
+                    life.therapy_episodes = l.value("therapy_episodes", life.therapy_episodes);
+                    life.steps_per_episode = l.value("steps_per_episode", life.steps_per_episode);
+                    life.trauma_lifetime = l.value("trauma_lifetime", life.trauma_lifetime);
+                    life.therapy_lifetime = l.value("therapy_lifetime", life.therapy_lifetime);
+                    life.exposure_prob = l.value("exposure_prob", life.exposure_prob);
+                    life.therapy_trigger_prob = l.value("therapy_trigger_prob", life.therapy_trigger_prob);
+                    life.mild_negative_prob = l.value("mild_negative_prob", life.mild_negative_prob);
+                    life.stress_trigger_prob = l.value("stress_trigger_prob", life.stress_trigger_prob);
+                    life.negative_valence_range = l.value("negative_valence_range", life.negative_valence_range);
+                }
+            }
+            if (j.contains("gridworld"))
+            {
+                const json &g = j["gridworld"];
+                sc.gridworld.episodes = g.value("episodes", sc.gridworld.episodes);
+                sc.gridworld.max_steps = g.value("max_steps", sc.gridworld.max_steps);
+                sc.gridworld.map = g.value("map", sc.gridworld.map);
+                sc.gridworld.eval_episodes = g.value("eval_episodes", sc.gridworld.eval_episodes);
+                sc.gridworld.eval_threads = g.value("eval_threads", sc.gridworld.eval_threads);
+                sc.gridworld.eval_epsilon = g.value("eval_epsilon", sc.gridworld.eval_epsilon);
+            }
+        }
+    } // namespace
+
+    SweepSpec parse_sweep(const json &j, const Config &base)
+    {
+        SweepSpec spec;
+        spec.name = j.value("name", spec.name);
+        spec.output_dir = j.value("output_dir", spec.output_dir);
+        spec.threads = j.value("threads", spec.threads);
+        if (j.contains("seeds"))
+            spec.seeds = j["seeds"].get<std::vector<uint64_t>>();
+        else if (j.contains("repeats"))
+        {
+            spec.seeds.clear();
+            for (int r = 0; r < j["repeats"].get<int>(); ++r)
+                spec.seeds.push_back(static_cast<uint64_t>(r + 1));
+        }
+        if (spec.seeds.empty())
+            throw std::runtime_error("Sweep " + spec.name + " has no seeds");
+        if (j.contains("scenario"))
+            read_scenario(j["scenario"], spec.scenario);
+
+        Config point_base = base;
+        if (j.contains("config"))
+            apply_config_json(point_base, j["config"]);
+        // Concurrent runs share nothing: no shared-memory islands, no console chatter
+        point_base.island_mode = false;
+        if (!j.contains("config") || !j["config"].contains("verbose"))
+            point_base.verbose = false;
+
+        // Cartesian product of the grid, first key varying slowest
+        spec.points.push_back({"base", point_base});
+        if (j.contains("grid"))
+        {
+            const json &grid = j["grid"];
+            if (!grid.is_object())
+                throw std::runtime_error("Sweep grid must be an object of value lists");
+            bool first_axis = true;
+            for (const auto &[field, values] : grid.items())
+            {
+                if (!values.is_array() || values.empty())
+                    throw std::runtime_error("Sweep grid entry " + field + " must be a non-empty list");
+                std::vector<SweepPoint> expanded;
+                for (const auto &point : spec.points)
+                {
+                    for (const auto &v : values)
+                    {
+                        SweepPoint next = point;
+                        apply_config_json(next.config, json{{field, v}});
+                        std::string label = field + "=" + value_label(v);
+                        next.name = first_axis ? label : point.name + "," + label;
+                        expanded.push_back(std::move(next));
+                    }
+                }
+                spec.points = std::move(expanded);
+                first_axis = false;
+            }
+        }
+        return spec;
+    }
+
+    SweepSpec load_sweep(const std::string &path, const Config &base)
+    {
+        std::ifstream file(path);
+        if (!file.is_open())
+            throw std::runtime_error("Cannot open sweep file: " + path);
+        json j;
+        file >> j;
+        return parse_sweep(j, base);
+    }
+
+    std::vector<RunResult> run_sweep(const SweepSpec &spec)
+    {
+        const size_t num_seeds = spec.seeds.size();
+        const size_t num_jobs = spec.points.size() * num_seeds;
+        std::vector<RunResult> results(num_jobs);
+
+        size_t workers = spec.threads > 0 ? static_cast<size_t>(spec.threads)
+                                          : std::max(1u, std::thread::hardware_concurrency());
+        workers = std::min(workers, num_jobs);
+        std::cout << "[DBEA] Sweep " << spec.name << ": " << spec.points.size() << " configurations x "
+                  << num_seeds << " seeds on " << workers << " threads\n";
+
+        // One parsed copy of the checkpoint, shared by every run's fork
+        std::unique_ptr<Agent> base;
+        if (!spec.scenario.checkpoint.empty())
+        {
+            Config base_cfg = spec.points.front().config; // only holds the beliefs, never runs
+            base_cfg.record_trace.clear();
+            base_cfg.telemetry_shm.clear();
+            base_cfg.maintenance_mode = "inline";
+            base = std::make_unique<Agent>(base_cfg);
+            base->load(spec.scenario.checkpoint);
+            base->compact_overlay(); // fully shared up front, so concurrent forks only read it
+            std::cout << "[DBEA] Runs fork " << spec.scenario.checkpoint << " (" << base->get_belief_count()
+                      << " beliefs)\n";
+        }
+
+        std::atomic<size_t> next_job{0};
+        std::atomic<size_t> finished{0};
+        auto worker = [&]()
+        {
+            for (size_t job = next_job++; job < num_jobs; job = next_job++)
+            {
+                const size_t p = job / num_seeds;
+                const SweepPoint &point = spec.points[p];
+                Config cfg = point.config;
+                cfg.seed = spec.seeds[job % num_seeds];
+                std::ostringstream dir;
+                dir << "p" << std::setw(3) << std::setfill('0') << p << "_seed" << cfg.seed;
+                const std::string run_dir = (std::filesystem::path(spec.output_dir) / dir.str()).string();
+                if (!cfg.record_trace.empty()) // one trace per run, next to its other outputs
+                    cfg.record_trace = (std::filesystem::path(run_dir) / std::filesystem::path(cfg.record_trace).filename()).string();
+                if (!cfg.telemetry_shm.empty()) // concurrent runs need their own rings
+                    cfg.telemetry_shm += "_" + dir.str();
+
+                RunResult &result = results[job];
+                try
+                {
+                    std::filesystem::create_directories(run_dir);
+                    std::ofstream(std::filesystem::path(run_dir) / "config.json") << config_to_json(cfg).dump(2);
+                    result = run_scenario(cfg, spec.scenario, run_dir, "", base.get());
+                }
+                catch (const std::exception &e)
+                {
+                    result.seed = cfg.seed;
+                    result.error = e.what();
+                }
+                result.config_name = point.name;
+                size_t done = ++finished;
+                if (!result.error.empty())
+                    std::cerr << "[DBEA] Run " << point.name << " seed " << cfg.seed << " failed: " << result.error << "\n";
+                else
+                    std::cout << "[DBEA] Run " << done << " / " << num_jobs << " done (" << point.name
+                              << ", seed " << cfg.seed << ")\n";
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (size_t t = 1; t < workers; ++t)
+            pool.emplace_back(worker);
+        worker();
+        for (auto &t : pool)
+            t.join();
+        return results;
+    }
+
+    void write_sweep_summary(const SweepSpec &spec, const std::vector<RunResult> &results, std::ostream &out)
+    {
+        struct Row
+        {
+            int runs = 0, failed = 0, goals = 0, episodes = 0;
+            uint64_t steps = 0;
+            double seconds = 0.0, beliefs = 0.0;
+        };
+        std::vector<Row> rows(spec.points.size());
+        const size_t num_seeds = spec.seeds.size();
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            Row &row = rows[i / num_seeds];
+            const RunResult &r = results[i];
+            if (!r.error.empty())
+            {
+                row.failed++;
+                continue;
+            }
+            row.runs++;
+            row.goals += r.goals;
+            row.episodes += r.episodes;
+            row.steps += r.steps;
+            row.seconds += r.seconds;
+            row.beliefs += static_cast<double>(r.beliefs);
+        }
+
+        std::filesystem::create_directories(spec.output_dir);
+        const std::string csv_path = (std::filesystem::path(spec.output_dir) / "summary.csv").string();
+        std::ofstream csv(csv_path);
+        csv << "Config,Runs,Failed,SuccessRate,StepsPerSec,Beliefs\n";
+
+        size_t name_width = 6;
+        for (const auto &p : spec.points)
+            name_width = std::max(name_width, p.name.size());
+        out << "\n" << std::left << std::setw(static_cast<int>(name_width)) << "Config"
+            << "  Runs  Success%   Steps/s  Beliefs\n";
+        for (size_t p = 0; p < rows.size(); ++p)
+        {
+            const Row &row = rows[p];
+            double success = row.episodes ? 100.0 * row.goals / row.episodes : 0.0;
+            double steps_per_sec = row.seconds > 0.0 ? row.steps / row.seconds : 0.0;
+            double beliefs = row.runs ? row.beliefs / row.runs : 0.0;
+            out << std::left << std::setw(static_cast<int>(name_width)) << spec.points[p].name << std::right
+                << std::setw(6) << row.runs << std::fixed << std::setprecision(1)
+                << std::setw(10) << success << std::setw(10) << std::setprecision(0) << steps_per_sec
+                << std::setw(9) << std::setprecision(1) << beliefs;
+            if (row.failed)
+                out << "  (" << row.failed << " failed)";
+            out << "\n";
+            csv << "\"" << spec.points[p].name << "\"," << row.runs << "," << row.failed << ","
+                << success / 100.0 << "," << steps_per_sec << "," << beliefs << "\n";
+        }
+        out.unsetf(std::ios::floatfield);
+        out << "Summary written to " << csv_path << "\n";
+    }
+} // namespace dbea
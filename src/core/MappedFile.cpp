@@ -0,0 +1,161 @@
+#include "dbea/MappedFile.h"
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace dbea
+{
+    MappedFile::~MappedFile()
+    {
+        close();
+    }
+
+#ifdef _WIN32
+    namespace
+    {
+        void map_handle(const std::string &path, HANDLE h, size_t size, bool writable, void *&file,
+                        void *&mapping, void *&addr)
+        {
+            HANDLE m = CreateFileMappingA(h, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY,
+                                          static_cast<DWORD>(static_cast<unsigned long long>(size) >> 32),
+                                          static_cast<DWORD>(size & 0xFFFFFFFFu), nullptr);
+            if (!m)
+            {
+                CloseHandle(h);
+                throw std::runtime_error("Failed to map file: " + path);
+            }
+            void *view = MapViewOfFile(m, writable ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, 0, 0, size);
+            if (!view)
+            {
+                CloseHandle(m);
+                CloseHandle(h);
+                throw std::runtime_error("Failed to map file: " + path);
+            }
+            file = h;
+            mapping = m;
+            addr = view;
+        }
+    } // namespace
+
+    void MappedFile::open_read(const std::string &path)
+    {
+        close();
+        HANDLE h = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                               FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (h == INVALID_HANDLE_VALUE)
+            throw std::runtime_error("Failed to open file: " + path);
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(h, &size) || size.QuadPart == 0)
+        {
+            CloseHandle(h);
+            throw std::runtime_error("Cannot map empty file: " + path);
+        }
+        map_handle(path, h, static_cast<size_t>(size.QuadPart), false, file, mapping, addr);
+        length = static_cast<size_t>(size.QuadPart);
+    }
+
+    void MappedFile::create(const std::string &path, size_t size)
+    {
+        close();
+        HANDLE h = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                               FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (h == INVALID_HANDLE_VALUE)
+            throw std::runtime_error("Failed to create file: " + path);
+        // The mapping extends the file to `size` zero bytes
+        map_handle(path, h, size, true, file, mapping, addr);
+        length = size;
+    }
+
+    void MappedFile::flush()
+    {
+        if (addr)
+            FlushViewOfFile(addr, length);
+    }
+
+    void MappedFile::close()
+    {
+        if (addr)
+            UnmapViewOfFile(addr);
+        if (mapping)
+            CloseHandle(static_cast<HANDLE>(mapping));
+        if (file)
+            CloseHandle(static_cast<HANDLE>(file));
+        addr = nullptr;
+        mapping = nullptr;
+        file = nullptr;
+        length = 0;
+    }
+#else
+    void MappedFile::open_read(const std::string &path)
+    {
+        close();
+        int handle = ::open(path.c_str(), O_RDONLY);
+        if (handle < 0)
+            throw std::runtime_error("Failed to open " + path + ": " + std::strerror(errno));
+        struct stat st{};
+        if (fstat(handle, &st) != 0 || st.st_size == 0)
+        {
+            ::close(handle);
+            throw std::runtime_error("Cannot map empty file: " + path);
+        }
+        void *view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, handle, 0);
+        if (view == MAP_FAILED)
+        {
+            ::close(handle);
+            throw std::runtime_error("Failed to map " + path + ": " + std::strerror(errno));
+        }
+        fd = handle;
+        addr = view;
+        length = static_cast<size_t>(st.st_size);
+    }
+
+    void MappedFile::create(const std::string &path, size_t size)
+    {
+        close();
+        int handle = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (handle < 0)
+            throw std::runtime_error("Failed to create " + path + ": " + std::strerror(errno));
+        // A sparse extension: untouched pages read as zero and take no disk space
+        if (ftruncate(handle, static_cast<off_t>(size)) != 0)
+        {
+            ::close(handle);
+            throw std::runtime_error("Failed to size " + path + ": " + std::strerror(errno));
+        }
+        void *view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, handle, 0);
+        if (view == MAP_FAILED)
+        {
+            ::close(handle);
+            throw std::runtime_error("Failed to map " + path + ": " + std::strerror(errno));
+        }
+        fd = handle;
+        addr = view;
+        length = size;
+    }
+
+    void MappedFile::flush()
+    {
+        if (addr)
+            msync(addr, length, MS_SYNC);
+    }
+
+    void MappedFile::close()
+    {
+        if (addr)
+            munmap(addr, length);
+        if (fd >= 0)
+            ::close(fd);
+        addr = nullptr;
+        fd = -1;
+        length = 0;
+    }
+#endif
+} // namespace dbea
@@ -0,0 +1,82 @@
+#include "dbea/ShardPool.h"
+
+namespace dbea
+{
+    ShardPool::ShardPool(size_t threads)
+    {
+        for (size_t t = 1; t < threads; ++t)
+            workers.emplace_back(&ShardPool::work, this);
+    }
+
+    ShardPool::~ShardPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto &t : workers)
+            t.join();
+    }
+
+    void ShardPool::run_erased(size_t count, void *context, Invoke invoke)
+    {
+        if (workers.empty() || count < 2)
+        {
+            for (size_t shard = 0; shard < count; ++shard)
+                invoke(context, shard);
+            return;
+        }
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            // A worker still leaving the previous job would otherwise take a shard of this one
+            while (active.load(std::memory_order_acquire) != 0)
+            {
+                lock.unlock();
+                std::this_thread::yield();
+                lock.lock();
+            }
+            job_context = context;
+            job_invoke = invoke;
+            job_count = count;
+            next_shard.store(0, std::memory_order_relaxed);
+            finished.store(0, std::memory_order_relaxed);
+            ++generation;
+        }
+        wake.notify_all();
+        drain(context, invoke, count);
+        // Shards are short; the caller spins rather than sleeping through the wake-up latency
+        while (finished.load(std::memory_order_acquire) < count)
+            std::this_thread::yield();
+    }
+
+    void ShardPool::drain(void *context, Invoke invoke, size_t count)
+    {
+        for (size_t shard = next_shard++; shard < count; shard = next_shard++)
+        {
+            invoke(context, shard);
+            finished.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    void ShardPool::work()
+    {
+        uint64_t seen = 0;
+        for (;;)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping)
+                return;
+            seen = generation;
+            void *context = job_context;
+            Invoke invoke = job_invoke;
+            size_t count = job_count;
+            active.fetch_add(1, std::memory_order_relaxed);
+            lock.unlock();
+
+            drain(context, invoke, count);
+            active.fetch_sub(1, std::memory_order_release);
+        }
+    }
+} // namespace dbea
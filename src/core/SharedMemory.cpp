@@ -0,0 +1,144 @@
+#include "dbea/SharedMemory.h"
+#include <stdexcept>
+#include <thread>
+#include <chrono>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace dbea
+{
+    SharedMemoryRegion::~SharedMemoryRegion()
+    {
+        close();
+    }
+
+#ifdef _WIN32
+    bool SharedMemoryRegion::open_or_create(const std::string &name, size_t size)
+    {
+        close();
+        // Win32 mapping names may not contain a leading slash like POSIX shm names do
+        std::string win_name = (!name.empty() && name[0] == '/') ? name.substr(1) : name;
+        HANDLE h = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                      static_cast<DWORD>(static_cast<unsigned long long>(size) >> 32),
+                                      static_cast<DWORD>(size & 0xFFFFFFFFu), win_name.c_str());
+        if (!h)
+            throw std::runtime_error("Failed to create shared memory: " + name);
+        bool created = (GetLastError() != ERROR_ALREADY_EXISTS);
+        void *view = MapViewOfFile(h, FILE_MAP_ALL_ACCESS, 0, 0, size);
+        if (!view)
+        {
+            CloseHandle(h);
+            throw std::runtime_error("Failed to map shared memory: " + name);
+        }
+        handle = h;
+        addr = view;
+        length = size;
+        region_name = name;
+        return created;
+    }
+
+    void SharedMemoryRegion::close()
+    {
+        if (addr)
+            UnmapViewOfFile(addr);
+        if (handle)
+            CloseHandle(static_cast<HANDLE>(handle));
+        addr = nullptr;
+        handle = nullptr;
+        length = 0;
+    }
+
+    void SharedMemoryRegion::unlink()
+    {
+        // Win32 mappings disappear with their last handle
+    }
+
+    void SharedMemoryRegion::remove(const std::string &)
+    {
+    }
+#else
+    bool SharedMemoryRegion::open_or_create(const std::string &name, size_t size)
+    {
+        close();
+        bool created = true;
+        int handle = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (handle >= 0)
+        {
+            if (ftruncate(handle, static_cast<off_t>(size)) != 0)
+            {
+                ::close(handle);
+                shm_unlink(name.c_str());
+                throw std::runtime_error("Failed to size shared memory " + name + ": " + std::strerror(errno));
+            }
+        }
+        else if (errno == EEXIST)
+        {
+            created = false;
+            handle = shm_open(name.c_str(), O_RDWR, 0600);
+            if (handle < 0)
+                throw std::runtime_error("Failed to open shared memory " + name + ": " + std::strerror(errno));
+
+            // The creator may not have sized the region yet
+            struct stat st{};
+            for (int tries = 0; tries < 1000; ++tries)
+            {
+                if (fstat(handle, &st) == 0 && static_cast<size_t>(st.st_size) >= size)
+                    break;
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            if (static_cast<size_t>(st.st_size) < size)
+            {
+                ::close(handle);
+                throw std::runtime_error("Shared memory " + name + " is smaller than expected");
+            }
+        }
+        else
+        {
+            throw std::runtime_error("Failed to create shared memory " + name + ": " + std::strerror(errno));
+        }
+
+        void *view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, handle, 0);
+        if (view == MAP_FAILED)
+        {
+            ::close(handle);
+            throw std::runtime_error("Failed to map shared memory " + name + ": " + std::strerror(errno));
+        }
+        fd = handle;
+        addr = view;
+        length = size;
+        region_name = name;
+        return created;
+    }
+
+    void SharedMemoryRegion::close()
+    {
+        if (addr)
+            munmap(addr, length);
+        if (fd >= 0)
+            ::close(fd);
+        addr = nullptr;
+        fd = -1;
+        length = 0;
+    }
+
+    void SharedMemoryRegion::unlink()
+    {
+        if (!region_name.empty())
+            shm_unlink(region_name.c_str());
+    }
+
+    void SharedMemoryRegion::remove(const std::string &name)
+    {
+        shm_unlink(name.c_str());
+    }
+#endif
+} // namespace dbea
@@ -0,0 +1,213 @@
+#include "dbea/Telemetry.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+namespace dbea
+{
+    namespace
+    {
+        constexpr uint32_t kTelemetryMagic = 0x4C544244; // "DBTL"
+        constexpr uint32_t kTelemetryVersion = 1;
+        constexpr uint32_t kTelemetrySlots = 8;
+        constexpr uint32_t kTelemetryMaxFeatures = 16;
+        constexpr uint32_t kTelemetryMaxEvents = 256;
+        constexpr size_t kHeaderBytes = 64;
+        constexpr size_t kSlotHeaderBytes = 128;
+        constexpr size_t kIdBytes = 24;
+
+        static_assert(std::atomic<uint64_t>::is_always_lock_free, "seqlock needs lock-free atomics");
+
+        enum EventKind : uint32_t
+        {
+            Birth = 1,
+            Death = 2,
+            Merge = 3,
+            Demote = 4,
+            Promote = 5,
+        };
+
+        struct TelemetryHeader
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t slots;
+            uint32_t slot_bytes;
+            uint32_t max_beliefs;
+            uint32_t max_features;
+            uint32_t max_events;
+            uint32_t reserved;
+            std::atomic<uint64_t> published;
+        };
+
+        struct SlotHeader
+        {
+            std::atomic<uint64_t> sequence;
+            uint64_t snapshot;
+            uint64_t step;
+            uint32_t beliefs;
+            uint32_t total_beliefs;
+            uint32_t events;
+            uint32_t dropped_events;
+            double emotion[6];
+        };
+
+        // Always double, like migrants, so viewers need not know the build precision
+        struct BeliefRecord
+        {
+            char id[kIdBytes];
+            double confidence;
+            double fitness;
+            double activation;
+            int32_t evidence;
+            uint32_t num_features;
+            double features[kTelemetryMaxFeatures];
+        };
+
+        struct EventRecord
+        {
+            uint32_t kind;
+            uint32_t reserved;
+            char id[kIdBytes];
+            char other[kIdBytes];
+        };
+
+        // The Python readers hard-code these sizes
+        static_assert(sizeof(TelemetryHeader) <= kHeaderBytes, "telemetry header overflows its block");
+        static_assert(sizeof(SlotHeader) <= kSlotHeaderBytes, "slot header overflows its block");
+        static_assert(sizeof(BeliefRecord) == 184, "belief record layout changed");
+        static_assert(sizeof(EventRecord) == 56, "event record layout changed");
+
+        size_t slot_bytes(size_t max_beliefs)
+        {
+            return kSlotHeaderBytes + max_beliefs * sizeof(BeliefRecord) + kTelemetryMaxEvents * sizeof(EventRecord);
+        }
+
+        void copy_id(char (&dst)[kIdBytes], const std::string &id)
+        {
+            size_t n = std::min(id.size(), kIdBytes - 1);
+            std::memcpy(dst, id.data(), n);
+            std::memset(dst + n, 0, kIdBytes - n);
+        }
+    } // namespace
+
+    TelemetryPublisher::TelemetryPublisher(const Config &cfg) : config(cfg)
+    {
+        if (config.telemetry_max_beliefs <= 0)
+            throw std::runtime_error("telemetry_max_beliefs must be positive");
+        const size_t max_beliefs = static_cast<size_t>(config.telemetry_max_beliefs);
+        const size_t bytes = slot_bytes(max_beliefs);
+        const size_t total = kHeaderBytes + kTelemetrySlots * bytes;
+
+        // The writer owns the name. A region left behind by an earlier run may have another
+        // layout or size, and opening it would wait for a resize that never comes: start fresh
+        SharedMemoryRegion::remove(config.telemetry_shm);
+        region.open_or_create(config.telemetry_shm, total);
+        auto *header = static_cast<TelemetryHeader *>(region.data());
+        header->version = kTelemetryVersion;
+        header->slots = kTelemetrySlots;
+        header->slot_bytes = static_cast<uint32_t>(bytes);
+        header->max_beliefs = static_cast<uint32_t>(max_beliefs);
+        header->max_features = kTelemetryMaxFeatures;
+        header->max_events = kTelemetryMaxEvents;
+        header->published.store(0, std::memory_order_relaxed);
+        // Readers check the magic last
+        std::atomic_thread_fence(std::memory_order_release);
+        header->magic = kTelemetryMagic;
+
+        staging.assign((bytes + sizeof(uint64_t) - 1) / sizeof(uint64_t), 0);
+        if (config.verbose)
+            std::cout << "[DBEA] Telemetry ring " << config.telemetry_shm << ": " << kTelemetrySlots << " x "
+                      << bytes / 1024 << " KiB snapshots every " << config.telemetry_interval << " steps\n";
+    }
+
+    TelemetryPublisher::~TelemetryPublisher()
+    {
+        // Attached viewers keep their mapping; the name goes so the next run starts clean
+        region.unlink();
+    }
+
+    void TelemetryPublisher::tick(BeliefGraph &graph, const EmotionState &emotion)
+    {
+        ++steps;
+        if (config.telemetry_interval <= 1 || steps % static_cast<uint64_t>(config.telemetry_interval) == 0)
+            publish(graph, emotion);
+    }
+
+    void TelemetryPublisher::publish(BeliefGraph &graph, const EmotionState &emotion)
+    {
+        auto *header = static_cast<TelemetryHeader *>(region.data());
+        const size_t max_beliefs = header->max_beliefs;
+        auto *base = reinterpret_cast<unsigned char *>(staging.data());
+        auto *snap = reinterpret_cast<SlotHeader *>(base);
+        auto *beliefs = reinterpret_cast<BeliefRecord *>(base + kSlotHeaderBytes);
+        auto *events = reinterpret_cast<EventRecord *>(base + kSlotHeaderBytes + max_beliefs * sizeof(BeliefRecord));
+
+        // Gather into staging
+        size_t num_beliefs = std::min(graph.nodes.size(), max_beliefs);
+        for (size_t i = 0; i < num_beliefs; ++i)
+        {
+            const BeliefNode &node = *graph.nodes[i];
+            BeliefRecord &rec = beliefs[i];
+            copy_id(rec.id, node.id);
+            rec.confidence = node.confidence;
+            rec.fitness = node.fitness;
+            rec.activation = graph.activation_of(node);
+            rec.evidence = node.evidence_count;
+            rec.num_features = static_cast<uint32_t>(std::min<size_t>(node.prototype.features.size(), kTelemetryMaxFeatures));
+            for (uint32_t f = 0; f < rec.num_features; ++f)
+                rec.features[f] = node.prototype.features[f];
+        }
+
+        size_t num_events = 0;
+        uint32_t dropped = 0;
+        auto emit = [&](uint32_t kind, const std::string &id, const std::string &other)
+        {
+            if (num_events == kTelemetryMaxEvents)
+            {
+                dropped++;
+                return;
+            }
+            EventRecord &ev = events[num_events++];
+            ev.kind = kind;
+            ev.reserved = 0;
+            copy_id(ev.id, id);
+            copy_id(ev.other, other);
+        };
+        // The graph logs every event as it happens; a snapshot only copies them out
+        static const std::string none;
+        for (const auto &[id, born] : graph.life_log)
+            emit(born ? Birth : Death, id, none);
+        graph.life_log.clear();
+        for (const auto &[id, keeper] : graph.merge_log)
+            emit(Merge, id, keeper);
+        graph.merge_log.clear();
+        for (const auto &[id, promoted] : graph.tier_log)
+            emit(promoted ? Promote : Demote, id, none);
+        graph.tier_log.clear();
+
+        snap->snapshot = snapshots;
+        snap->step = steps;
+        snap->beliefs = static_cast<uint32_t>(num_beliefs);
+        snap->total_beliefs = static_cast<uint32_t>(graph.nodes.size());
+        snap->events = static_cast<uint32_t>(num_events);
+        snap->dropped_events = dropped;
+        const Real values[6] = {emotion.valence, emotion.arousal, emotion.dominance,
+                                emotion.curiosity, emotion.fear, emotion.explore_bias};
+        std::copy(values, values + 6, snap->emotion);
+
+        // Seqlock write into the ring: only the used records are copied
+        auto *slot = static_cast<unsigned char *>(region.data()) + kHeaderBytes + (snapshots % kTelemetrySlots) * header->slot_bytes;
+        auto *sequence = reinterpret_cast<std::atomic<uint64_t> *>(slot);
+        const uint64_t seq = sequence->load(std::memory_order_relaxed);
+        sequence->store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(slot + sizeof(uint64_t), base + sizeof(uint64_t), sizeof(SlotHeader) - sizeof(uint64_t));
+        std::memcpy(slot + kSlotHeaderBytes, beliefs, num_beliefs * sizeof(BeliefRecord));
+        std::memcpy(slot + kSlotHeaderBytes + max_beliefs * sizeof(BeliefRecord), events, num_events * sizeof(EventRecord));
+        sequence->store(seq + 2, std::memory_order_release);
+        header->published.store(++snapshots, std::memory_order_release);
+    }
+} // namespace dbea
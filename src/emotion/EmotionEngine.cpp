@@ -0,0 +1,159 @@
+#include "dbea/EmotionEngine.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#if defined(_MSC_VER) || defined(__GNUC__)
+#define DBEA_RESTRICT __restrict
+#else
+#define DBEA_RESTRICT
+#endif
+
+namespace dbea
+{
+    namespace
+    {
+        // Clamp in double, then narrow; bounds are exact in float, so this matches
+        // narrowing first and clamping in Real. NaN passes through unchanged.
+        inline Real clamp_real(double x, double lo, double hi)
+        {
+            // Same selects as std::min(std::max(x, lo), hi), but on values rather than
+            // references so the compiler can if-convert them
+            x = (x < lo) ? lo : x;
+            x = (hi < x) ? hi : x;
+            return static_cast<Real>(x);
+        }
+
+        // NaN -> fallback; values are already clamped, so NaN is the only non-finite case
+        inline Real finite_or(Real x, Real fallback)
+        {
+            return (x == x) ? x : fallback;
+        }
+
+        // Parameters (not locals) carry __restrict so GCC trusts it: every array is
+        // distinct, which lets the loop vectorize without per-pair overlap checks
+        void update_lanes(Real *DBEA_RESTRICT valence_out, Real *DBEA_RESTRICT arousal_out,
+                          Real *DBEA_RESTRICT dominance_out, Real *DBEA_RESTRICT curiosity_out,
+                          Real *DBEA_RESTRICT fear_out, Real *DBEA_RESTRICT explore_bias_out,
+                          const double *DBEA_RESTRICT reward_valence, const double *DBEA_RESTRICT reward_surprise,
+                          const double *DBEA_RESTRICT avg_error, size_t count, double curiosity_boost,
+                          double curiosity_decay, double calm_fear_decay, double high_fear_decay)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                const double rv = reward_valence[i];
+                const double rs = reward_surprise[i];
+                const double err = avg_error[i];
+                const Real old_fear = fear_out[i];
+
+                Real valence = clamp_real(valence_out[i] + 0.09 * rv, -1.0, 1.0);
+                Real arousal = clamp_real(arousal_out[i] + 0.05 * rs, 0.0, 1.0);
+
+                // Curiosity update — NaN/inf avg_error counts as zero
+                const double safe_error = (std::abs(err) <= DBL_MAX) ? err : 0.0;
+                Real curiosity = clamp_real(curiosity_out[i] + (curiosity_boost * safe_error - curiosity_decay), 0.0, 1.0);
+
+                // Fear update
+                const double fear_decay = (old_fear > 0.3) ? high_fear_decay : calm_fear_decay;
+                const double error_fear = 0.25 * safe_error;
+                const double fear_delta = 0.3 * (rs > 0.3 ? 0.15 : error_fear);
+                Real fear = clamp_real(old_fear + (fear_delta + fear_decay), 0.0, 1.0);
+
+                // Flashback effect
+                const Real flashback_fear = clamp_real(fear + 0.1, 0.0, 1.0);
+                const Real flashback_arousal = clamp_real(arousal + 0.3, 0.0, 1.0);
+                // fear > 0.3 && rv < 0, folded into one compare (NaN rv never triggers it)
+                const double flashback_level = (rv < 0.0) ? static_cast<double>(fear) : 0.0;
+                arousal = (flashback_level > 0.3) ? flashback_arousal : arousal;
+                fear = (flashback_level > 0.3) ? flashback_fear : fear;
+
+                // Dominance update
+                const double fearful_penalty = 0.05 * safe_error;
+                const double dominance_change = (0.12 * (1.0 - safe_error) - 0.04 * safe_error) -
+                                                (fear > 0.3 ? fearful_penalty : 0.0);
+                Real dominance = clamp_real(dominance_out[i] + dominance_change, 0.0, 1.0);
+
+                // Explore bias
+                Real explore_bias = clamp_real((curiosity - fear) + 0.3 * valence, -1.0, 1.0);
+
+                valence_out[i] = finite_or(valence, 0.0);
+                arousal_out[i] = finite_or(arousal, 0.0);
+                curiosity_out[i] = finite_or(curiosity, 0.5);
+                fear_out[i] = finite_or(fear, 0.0);
+                dominance_out[i] = finite_or(dominance, 0.5);
+                explore_bias_out[i] = finite_or(explore_bias, 0.0);
+            }
+        }
+    } // namespace
+
+    void update_emotions(const EmotionArrays &s, size_t count, const double *reward_valence,
+                         const double *reward_surprise, const double *avg_error, const Config &config)
+    {
+        // Therapy mode overrides both fear decay rates, so fold it in outside the loop
+        const double calm_fear_decay = config.therapy_mode ? -0.05 : -0.003;
+        const double high_fear_decay = config.therapy_mode ? -0.05 : -0.0015;
+        update_lanes(s.valence, s.arousal, s.dominance, s.curiosity, s.fear, s.explore_bias,
+                     reward_valence, reward_surprise, avg_error, count,
+                     config.curiosity_boost, config.curiosity_decay, calm_fear_decay, high_fear_decay);
+    }
+
+    EmotionEngine::EmotionEngine(size_t reserve)
+    {
+        for (auto *field : {&valence, &arousal, &dominance, &curiosity, &fear, &explore_bias})
+            field->reserve(reserve);
+    }
+
+    size_t EmotionEngine::add(const EmotionState &initial)
+    {
+        size_t slot = size();
+        valence.push_back(initial.valence);
+        arousal.push_back(initial.arousal);
+        dominance.push_back(initial.dominance);
+        curiosity.push_back(initial.curiosity);
+        fear.push_back(initial.fear);
+        explore_bias.push_back(initial.explore_bias);
+        return slot;
+    }
+
+    EmotionState EmotionEngine::get(size_t slot) const
+    {
+        EmotionState state;
+        state.valence = valence[slot];
+        state.arousal = arousal[slot];
+        state.dominance = dominance[slot];
+        state.curiosity = curiosity[slot];
+        state.fear = fear[slot];
+        state.explore_bias = explore_bias[slot];
+        return state;
+    }
+
+    void EmotionEngine::set(size_t slot, const EmotionState &state)
+    {
+        valence[slot] = state.valence;
+        arousal[slot] = state.arousal;
+        dominance[slot] = state.dominance;
+        curiosity[slot] = state.curiosity;
+        fear[slot] = state.fear;
+        explore_bias[slot] = state.explore_bias;
+    }
+
+    EmotionArrays EmotionEngine::arrays()
+    {
+        return {valence.data(), arousal.data(), dominance.data(), curiosity.data(), fear.data(), explore_bias.data()};
+    }
+
+    void EmotionEngine::update(size_t slot, double reward_valence, double reward_surprise, double avg_error,
+                               const Config &config)
+    {
+        EmotionArrays s = arrays();
+        EmotionArrays one = {s.valence + slot, s.arousal + slot, s.dominance + slot,
+                             s.curiosity + slot, s.fear + slot, s.explore_bias + slot};
+        update_emotions(one, 1, &reward_valence, &reward_surprise, &avg_error, config);
+    }
+
+    void EmotionEngine::update_all(const double *reward_valence, const double *reward_surprise, const double *avg_error,
+                                   const Config &config)
+    {
+        update_emotions(arrays(), size(), reward_valence, reward_surprise, avg_error, config);
+    }
+} // namespace dbea
@@ -1,25 +1,159 @@
 #include "dbea/Agent.h"
+#include "dbea/CompiledPolicy.h"
 #include "dbea/Config.h"
-#include "dbea/PatternSignature.h"
-#include "gridworld/GridWorld.h"
+#include "dbea/Experiment.h"
+#include "dbea/InputTrace.h"
+#include "gridworld/GridMap.h"
+#include <filesystem>
 #include <iostream>
-#include <fstream>
-#include <random>
-#include <iomanip>
 #include <stdexcept>
 #include <string>
 using namespace dbea;
-// Helper: Slowly evolve baseline personality across lifetimes
-void evolve_personality_baseline(EmotionState &emotion, std::mt19937 &rng)
+// Island-model flags: --island <id> --islands <n> [--topology ring|full|star]
+//                     [--migration-interval <steps>] [--migration-rate <fraction>]
+//                     [--island-reset] (island 0 only: replace a crashed run's segment)
+// Sweep flags:        --sweep <file.json> [--threads <n>]
+// Reproducibility:    --seed <n> (0 = random)
+// Checkpoints:        --checkpoint <agent.json> (start from it instead of the lifelong phase; sweep runs fork one copy)
+// Actor/learner:      --actors <n> [--backpressure block|drop]
+// Decisions:          --decision-budget <us> [--decision-order activation|confidence|index] (anytime decide)
+// Compete cache:      --compete-cache <entries> [--compete-cache-tolerance <confidence drift>]
+// Sharded compete:    --compete-threads <n> [--compete-parallel-min <beliefs>] (large populations only)
+// Cold tier:          --cold-tier <idle competes> [--cold-tier-activation <a>] [--cold-tier-interval <steps>]
+// Telemetry:          --telemetry <shm name, e.g. /dbea_telemetry>
+// Traces:             --record <file.trace> | --replay <file.trace> [--open-loop | --check-open-loop]
+//                     [--replay-save <file.json>]
+// Policy export:      --compile-policy <out.dbpt> --checkpoint <agent.json> [--map <file.dbgm>]
+//                     (greedy action per GridWorld cell, see CompiledPolicy.h)
+// Evaluation:         --eval <episodes> [--eval-threads <n>] [--eval-epsilon <e>] (frozen, parallel, after the test)
+// GridWorld maps:     --map <file.dbgm> [--max-steps <n>]
+//                     --generate-map <file.dbgm> [--map-size <w>[x<h>]] [--wall-density <p>] [--risk-density <p>]
+struct RunOptions
 {
-    std::normal_distribution<double> noise(0.0, 0.015);
-    emotion.dominance = std::clamp(emotion.dominance * 0.985 + noise(rng), 0.0, 1.0);
-    emotion.fear = std::clamp(emotion.fear * 0.97 + noise(rng), 0.0, 1.0);
-    emotion.valence = 0.0;
-    emotion.curiosity = 0.5;
-    emotion.explore_bias = 0.0;
+    Scenario scenario;
+    std::string generate_map;
+    GridMapSpec map_spec;
+    std::string sweep_file;
+    int threads = -1;
+    std::string replay_file;
+    std::string replay_save;
+    bool open_loop = false;
+    bool check_open_loop = false;
+    std::string compile_policy;
+};
+
+// "run.trace" + "_island1" -> "run_island1.trace"
+static std::string with_suffix(const std::string &file, const std::string &suffix)
+{
+    std::filesystem::path path(file);
+    const std::string ext = path.extension().string();
+    path.replace_filename(path.stem().string() + suffix + ext);
+    return path.string();
+}
+
+static void parse_args(int argc, char **argv, Config &cfg, RunOptions &opts)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string
+        {
+            if (i + 1 >= argc)
+                throw std::runtime_error("Missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--island")
+        {
+            cfg.island_mode = true;
+            cfg.island_id = std::stoi(value());
+        }
+        else if (arg == "--islands")
+            cfg.num_islands = std::stoi(value());
+        else if (arg == "--topology")
+            cfg.island_topology = value();
+        else if (arg == "--migration-interval")
+            cfg.migration_interval = std::stoi(value());
+        else if (arg == "--migration-rate")
+            cfg.migration_rate = std::stod(value());
+        else if (arg == "--island-shm")
+            cfg.island_shm_name = value();
+        else if (arg == "--island-reset")
+            cfg.island_reset = true;
+        else if (arg == "--seed")
+            cfg.seed = std::stoull(value());
+        else if (arg == "--checkpoint")
+            opts.scenario.checkpoint = value();
+        else if (arg == "--sweep")
+            opts.sweep_file = value();
+        else if (arg == "--threads")
+            opts.threads = std::stoi(value());
+        else if (arg == "--record")
+            cfg.record_trace = value();
+        else if (arg == "--actors")
+            cfg.actor_threads = std::stoi(value());
+        else if (arg == "--backpressure")
+            cfg.actor_backpressure = value();
+        else if (arg == "--decision-budget")
+        {
+            cfg.decision_mode = "anytime";
+            cfg.decision_budget_us = std::stod(value());
+        }
+        else if (arg == "--decision-order")
+            cfg.decision_order = value();
+        else if (arg == "--compete-cache")
+            cfg.compete_cache_entries = std::stoi(value());
+        else if (arg == "--compete-cache-tolerance")
+            cfg.compete_cache_tolerance = std::stod(value());
+        else if (arg == "--compete-threads")
+            cfg.compete_threads = std::stoi(value());
+        else if (arg == "--compete-parallel-min")
+            cfg.compete_parallel_min = std::stoi(value());
+        else if (arg == "--cold-tier")
+            cfg.cold_tier_window = std::stoi(value());
+        else if (arg == "--cold-tier-activation")
+            cfg.cold_tier_activation = std::stod(value());
+        else if (arg == "--cold-tier-interval")
+            cfg.cold_tier_interval = std::stoi(value());
+        else if (arg == "--telemetry")
+            cfg.telemetry_shm = value();
+        else if (arg == "--map")
+            opts.scenario.gridworld.map = value();
+        else if (arg == "--max-steps")
+            opts.scenario.gridworld.max_steps = std::stoi(value());
+        else if (arg == "--eval")
+            opts.scenario.gridworld.eval_episodes = std::stoi(value());
+        else if (arg == "--eval-threads")
+            opts.scenario.gridworld.eval_threads = std::stoi(value());
+        else if (arg == "--eval-epsilon")
+            opts.scenario.gridworld.eval_epsilon = std::stod(value());
+        else if (arg == "--generate-map")
+            opts.generate_map = value();
+        else if (arg == "--map-size")
+        {
+            std::string size = value();
+            size_t x = size.find('x');
+            opts.map_spec.width = std::stoi(size.substr(0, x));
+            opts.map_spec.height = (x == std::string::npos) ? opts.map_spec.width : std::stoi(size.substr(x + 1));
+        }
+        else if (arg == "--wall-density")
+            opts.map_spec.wall_density = std::stod(value());
+        else if (arg == "--risk-density")
+            opts.map_spec.risk_density = std::stod(value());
+        else if (arg == "--replay")
+            opts.replay_file = value();
+        else if (arg == "--replay-save")
+            opts.replay_save = value();
+        else if (arg == "--open-loop")
+            opts.open_loop = true;
+        else if (arg == "--check-open-loop")
+            opts.check_open_loop = true;
+        else if (arg == "--compile-policy")
+            opts.compile_policy = value();
+        else
+            throw std::runtime_error("Unknown argument: " + arg);
+    }
 }
-int main()
+int main(int argc, char **argv)
 {
     Config cfg;
     // Apply strong exploration / curiosity / discount settings
@@ -33,205 +167,124 @@ int main()
     cfg.min_exploration = 0.42;
     cfg.explore_bias_scale = 0.45;
     cfg.gamma = 0.985;
-    std::mt19937 rng(std::random_device{}()); // better seeding than fixed 42
-    std::uniform_real_distribution<double> dist(0.0, 1.0);
-    const int num_lifetimes = 7;
-    const int base_episodes = 10;
-    const int therapy_episodes = 30;
-    const double exposure_prob = 0.3;
-    const double therapy_trigger_prob = 0.2;
-    // Post-recovery stress parameters (only used in phase switch)
-    const double mild_negative_prob = 0.15;
-    const double stress_trigger_prob = 0.35;
-    const double negative_valence_range = -0.25;
-    std::string save_file = "agent_lifetime.json";
-    std::cout << "DBEA v0 - Lifelong Developmental Simulation + GridWorld Test\n";
-    Agent agent(cfg);
-    std::ofstream emo_csv("emotion_trajectory_full.csv", std::ios::trunc);
-    if (!emo_csv.is_open())
+    RunOptions opts;
+    try
     {
-        std::cerr << "Failed to open emotion_trajectory_full.csv!\n";
+        parse_args(argc, argv, cfg, opts);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << "\n";
         return 1;
     }
-    emo_csv << "Lifetime,Episode,Step,Valence,Fear,Dominance,ExploreBias,Phase\n";
-    emo_csv << std::fixed << std::setprecision(6);
-    std::string current_phase = "Normal";
-    // ──────────────────────────────────────────────────────────────
-    // Lifelong simulation (unchanged, but simplified comments)
-    // ──────────────────────────────────────────────────────────────
-    for (int life = 0; life < num_lifetimes; ++life)
+    if (!opts.generate_map.empty())
     {
-        std::cout << "\n┌────────────────────────────────────┐\n"
-                  << "│ Starting Lifetime " << (life + 1) << " / " << num_lifetimes << " ";
-        bool is_trauma = (life == 2);
-        bool is_therapy = (life == 6);
-        int episodes_this_life = is_therapy ? therapy_episodes : base_episodes;
-        if (is_trauma)
-            current_phase = "Trauma";
-        else if (is_therapy)
-            current_phase = "Therapy";
-        else
-            current_phase = "Normal";
-        std::cout << " [" << current_phase << "] │\n└────────────────────────────────────┘\n";
-        if (life > 0)
+        try
         {
-            try
-            {
-                agent.load(save_file);
-                EmotionState current = agent.get_emotion();
-                evolve_personality_baseline(current, rng);
-                agent.set_emotion(current);
-            }
-            catch (const std::exception &e)
-            {
-                std::cout << "Load failed: " << e.what() << "\n";
-            }
+            opts.map_spec.seed = cfg.seed ? cfg.seed : 1;
+            generate_grid_map(opts.generate_map, opts.map_spec);
+            auto map = GridMap::open(opts.generate_map);
+            auto [sx, sy] = map->start();
+            std::cout << "[DBEA] Wrote " << map->width() << "x" << map->height() << " map to " << opts.generate_map
+                      << " | Start-goal distance: " << map->distance(sx, sy) << "\n";
         }
-        agent.set_therapy_mode(is_therapy);
-        for (int ep = 0; ep < episodes_this_life; ++ep)
+        catch (const std::exception &e)
         {
-            std::cout << "\n=== Episode " << ep << " ===\n";
-            agent.set_merge_threshold(0.92 - 0.01 * ep); // Adjusted for new merge_threshold
-            if (is_therapy && ep >= 20)
+            std::cerr << "Map generation failed: " << e.what() << "\n";
+            return 1;
+        }
+        return 0;
+    }
+    if (!opts.replay_file.empty())
+    {
+        try
+        {
+            if (opts.check_open_loop)
             {
-                current_phase = (ep < 25) ? "Post-Recovery Stress Test" : "Relapse Prevention";
-                agent.set_therapy_mode(false);
+                const bool agree = replay_modes_agree(opts.replay_file);
+                std::cout << "[DBEA] Open-loop and checked replay " << (agree ? "save identical" : "save different")
+                          << " checkpoints\n";
+                return agree ? 0 : 2;
             }
-            for (int step = 0; step < 5; ++step)
+            ReplayMode mode = opts.open_loop ? ReplayMode::OpenLoop : ReplayMode::Checked;
+            ReplayResult r = replay_trace(opts.replay_file, mode, opts.replay_save);
+            std::cout << "[DBEA] Replayed " << r.records << " records (" << r.steps << " steps) in " << r.seconds
+                      << " s | " << (r.seconds > 0.0 ? r.steps / r.seconds : 0.0) << " steps/s | Beliefs: " << r.beliefs << "\n";
+            if (mode == ReplayMode::Checked)
             {
-                int discrete_state = step % 4;
-                std::uniform_real_distribution<double> small_noise(-0.01, 0.01);
-                PatternSignature perception({static_cast<double>(discrete_state), 0.3 + small_noise(rng)});
-                agent.perceive(perception);
-                Action action = agent.decide();
-                bool is_trigger = (life > 2 && discrete_state % 4 == 2);
-                double trigger_p = is_therapy ? therapy_trigger_prob : stress_trigger_prob;
-                is_trigger = is_trigger && (dist(rng) < trigger_p);
-                double r = dist(rng);
-                double reward_valence, reward_surprise = 0.05 + dist(rng) * 0.1;
-                if (is_therapy)
-                {
-                    reward_valence = 0.1 + dist(rng) * 0.2;
-                    reward_surprise = 0.05 + dist(rng) * 0.05;
-                }
-                else if (is_trauma)
-                {
-                    reward_valence = (r < 0.40) ? -0.45 - dist(rng) * 0.20 : (r < 0.60 ? 0.06 : 0.02) + dist(rng) * 0.06;
-                    if (r < 0.40)
-                        reward_surprise += 0.7;
-                }
-                else
-                {
-                    reward_valence = (r < mild_negative_prob) ? -negative_valence_range * dist(rng) : 0.04 + dist(rng) * 0.08;
-                    if (r < mild_negative_prob)
-                        reward_surprise += 0.2;
-                }
-                if (is_therapy && dist(rng) < exposure_prob && action.name == "noop")
-                {
-                    agent.force_action("explore");
-                    action = agent.decide();
-                    reward_valence = 0.4;
-                    std::cout << "[DBEA] Exposure therapy: Forcing explore!\n";
-                }
-                if (is_trigger && agent.get_emotion().fear > 0.15)
-                {
-                    reward_surprise += 0.25;
-                    std::cout << "[DBEA] Trigger activated!\n";
-                }
-                static int explore_streak = 0;
-                if (action.name == "explore")
-                {
-                    explore_streak++;
-                    if (explore_streak >= cfg.max_explore_streak && dist(rng) < cfg.streak_punish_prob)
-                    {
-                        reward_valence += cfg.streak_punish_amount;
-                    }
-                }
-                else
-                {
-                    explore_streak = 0;
-                }
-                agent.receive_reward(reward_valence, reward_surprise);
-                agent.learn();
-                std::cout << "Step " << step << " | Action: " << action.name
-                          << " | Reward: " << reward_valence << " | Phase: " << current_phase << "\n";
-                auto [n, e] = agent.get_proto_action_values();
-                std::cout << "Proto-belief | Top: " << (e >= n ? "explore" : "noop")
-                          << " | Values: (noop=" << n << ", explore=" << e << ")\n";
-                emo_csv << (life + 1) << "," << ep << "," << step << ","
-                        << agent.get_emotion().valence << ","
-                        << agent.get_emotion().fear << ","
-                        << agent.get_emotion().dominance << ","
-                        << agent.get_emotion().explore_bias << "," << current_phase << "\n";
+                std::cout << "[DBEA] Divergent decisions: " << r.divergences << " / " << r.decisions;
+                if (r.first_divergence >= 0)
+                    std::cout << " (first at decision " << r.first_divergence << ")";
+                std::cout << "\n";
+                return r.divergences == 0 ? 0 : 2;
             }
-            agent.prune_beliefs(0.40);
         }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Replay failed: " << e.what() << "\n";
+            return 1;
+        }
+        return 0;
+    }
+    if (!opts.compile_policy.empty())
+    {
         try
         {
-            agent.save(save_file);
-            std::cout << "Saved state after lifetime " << (life + 1) << "\n";
+            if (opts.scenario.checkpoint.empty())
+                throw std::runtime_error("--compile-policy needs --checkpoint <agent.json>");
+            Agent agent(cfg);
+            agent.load(opts.scenario.checkpoint);
+            const std::string &map_file = opts.scenario.gridworld.map;
+            auto map = map_file.empty() ? GridMap::builtin() : GridMap::open(map_file);
+            // GridWorld observations are x / (width - 1), y / (height - 1): one lattice point per cell
+            std::vector<PolicyAxis> axes{{0.0, 1.0, static_cast<uint32_t>(map->width())},
+                                         {0.0, 1.0, static_cast<uint32_t>(map->height())}};
+            CompiledPolicy::compile_grid(agent, axes, opts.compile_policy);
+            auto policy = CompiledPolicy::open(opts.compile_policy);
+            std::cout << "[DBEA] Compiled " << policy->slots() << "-cell policy to " << opts.compile_policy << " ("
+                      << policy->file_bytes() << " bytes)\n";
         }
         catch (const std::exception &e)
         {
-            std::cout << "Save failed: " << e.what() << "\n";
+            std::cerr << "Policy compilation failed: " << e.what() << "\n";
+            return 1;
         }
+        return 0;
     }
-    emo_csv.close();
-    // ──────────────────────────────────────────────────────────────
-    // GridWorld Navigation Test
-    // ──────────────────────────────────────────────────────────────
-    std::cout << "\n=== Starting GridWorld Navigation Test ===\n";
+    if (!opts.sweep_file.empty())
+    {
+        try
+        {
+            SweepSpec spec = load_sweep(opts.sweep_file, cfg);
+            if (opts.threads >= 0)
+                spec.threads = opts.threads;
+            if (!opts.scenario.checkpoint.empty())
+                spec.scenario.checkpoint = opts.scenario.checkpoint;
+            auto results = run_sweep(spec);
+            write_sweep_summary(spec, results, std::cout);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Sweep failed: " << e.what() << "\n";
+            return 1;
+        }
+        return 0;
+    }
+    // Islands share a working directory, so every output gets an island suffix
+    const std::string run_suffix = cfg.island_mode ? "_island" + std::to_string(cfg.island_id) : "";
+    if (!cfg.record_trace.empty())
+        cfg.record_trace = with_suffix(cfg.record_trace, run_suffix);
+    if (!cfg.telemetry_shm.empty())
+        cfg.telemetry_shm += run_suffix;
+    std::cout << "DBEA v0 - Lifelong Developmental Simulation + GridWorld Test\n";
     try
     {
-        agent.load("agent_lifetime.json");
-        std::cout << "Healed agent loaded successfully.\n";
+        run_scenario(cfg, opts.scenario, ".", run_suffix);
     }
     catch (const std::exception &e)
     {
-        std::cerr << "Failed to load agent: " << e.what() << "\n";
+        std::cerr << e.what() << "\n";
         return 1;
     }
-    dbea::GridWorld env;
-    env.reset();
-    std::ofstream grid_log("gridworld_trajectory.csv");
-    grid_log << "Episode,Step,X,Y,Reward,Done\n";
-    const int num_episodes = 200; // Increased as per recommendations
-    const int max_steps_per_episode = 80;
-    int goals_reached = 0;
-    for (int ep = 0; ep < num_episodes; ++ep)
-    {
-        env.reset();
-        double total_reward = 0.0;
-        int steps = 0;
-        bool done = false;
-        while (!done && steps < max_steps_per_episode)
-        {
-            PatternSignature obs = env.observe();
-            agent.perceive(obs);
-            Action action = agent.decide();
-            double reward = env.step(action);
-            total_reward += reward;
-            agent.receive_reward(reward, 0.05);
-            agent.learn();
-            auto pos = env.get_position();
-            done = env.is_done();
-            grid_log << ep << "," << steps << "," << pos.first << "," << pos.second
-                     << "," << reward << "," << (done ? "true" : "false") << "\n";
-            steps++;
-            if (done)
-            {
-                goals_reached++;
-                std::cout << "[SUCCESS] Goal reached in episode " << ep
-                          << " after " << steps << " steps!\n";
-            }
-        }
-        std::cout << "Episode " << ep << " finished in " << steps
-                  << " steps | Total reward: " << total_reward << "\n";
-    }
-    grid_log.close();
-    std::cout << "\nGridWorld test complete.\n"
-              << "Goals reached: " << goals_reached << " / " << num_episodes
-              << " (" << (100.0 * goals_reached / num_episodes) << "%)\n"
-              << "Trajectory saved to gridworld_trajectory.csv\n";
     return 0;
-}
\ No newline at end of file
+}
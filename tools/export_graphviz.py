@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+"""Export a belief graph as Graphviz DOT.
+
+The source is either a saved agent (``agent_lifetime.json``, Agent::save) or a
+live telemetry region (``/dbea_telemetry``, see visualize_belief_graph.py).
+Node size follows confidence and colour follows fitness. Edges are
+co-activation counts for saved agents; snapshots carry no co-activations, so
+there beliefs are linked by prototype similarity and the merges since the
+previous snapshot are drawn dashed.
+
+    python tools/export_graphviz.py agent_lifetime.json -o beliefs.dot
+    python tools/export_graphviz.py /dbea_telemetry | dot -Tsvg > beliefs.svg
+"""
+import argparse
+import json
+import math
+import os
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from visualize_belief_graph import TelemetryReader  # noqa: E402
+
+
+def similarity(a, b):
+    """Same score as BeliefNode::match_score: 1 - distance / sqrt(width)."""
+    if len(a) != len(b) or not a:
+        return 0.0
+    dist = math.sqrt(sum((x - y) ** 2 for x, y in zip(a, b)))
+    return max(0.0, 1.0 - dist / math.sqrt(len(a)))
+
+
+def from_saved_agent(path, min_count):
+    with open(path) as f:
+        agent = json.load(f)
+    beliefs = [{"id": b["id"], "confidence": b.get("confidence", 0.0), "fitness": b.get("fitness", 0.0),
+                "evidence": b.get("evidence_count", 0)} for b in agent.get("beliefs", [])]
+    ids = {b["id"] for b in beliefs}
+    edges = []
+    for key, count in agent.get("co_activations", {}).items():
+        # Keys are "<id1>_<id2>"; ids may contain '_' themselves, so try every split
+        for cut in (i for i, ch in enumerate(key) if ch == "_"):
+            a, b = key[:cut], key[cut + 1:]
+            if a in ids and b in ids:
+                if count >= min_count:
+                    edges.append((a, b, "co-activated %d" % count, "solid", 1.0 + math.log1p(count)))
+                break
+    return beliefs, edges, "saved agent %s" % os.path.basename(path)
+
+
+def from_telemetry(name, min_similarity):
+    snap = TelemetryReader(name).latest()
+    if snap is None:
+        raise RuntimeError("no snapshot published in %s" % name)
+    beliefs = snap["beliefs"]
+    edges = []
+    for i, a in enumerate(beliefs):
+        for b in beliefs[i + 1:]:
+            sim = similarity(a["prototype"], b["prototype"])
+            if sim >= min_similarity:
+                edges.append((a["id"], b["id"], "%.2f" % sim, "solid", 1.0))
+    known = {b["id"] for b in beliefs}
+    for ev in snap["events"]:
+        if ev["kind"] == "merge" and ev["other"] in known:
+            edges.append((ev["id"], ev["other"], "merged", "dashed", 1.0))
+    label = "step %d, %d of %d beliefs" % (snap["step"], len(beliefs), snap["total_beliefs"])
+    return beliefs, edges, label
+
+
+def fitness_colour(fitness, lo, hi):
+    t = 0.0 if hi <= lo else (fitness - lo) / (hi - lo)
+    # Graphviz HSV: blue (low fitness) to red (high)
+    return "%.3f 0.7 0.95" % (0.66 * (1.0 - t))
+
+
+def to_dot(beliefs, edges, label):
+    fitness = [b["fitness"] for b in beliefs] or [0.0]
+    lo, hi = min(fitness), max(fitness)
+    out = ["graph beliefs {",
+           '  label="%s"; labelloc=t; overlap=false;' % label,
+           "  node [shape=circle, style=filled, fontsize=9];"]
+    drawn = set()
+    for b in beliefs:
+        drawn.add(b["id"])
+        width = 0.3 + 0.9 * max(0.0, min(1.0, b["confidence"]))
+        out.append('  "%s" [width=%.2f, fillcolor="%s", tooltip="conf %.3f fitness %.3f evidence %d"];'
+                   % (b["id"], width, fitness_colour(b["fitness"], lo, hi),
+                      b["confidence"], b["fitness"], b["evidence"]))
+    for a, b, text, style, pen in edges:
+        for node in (a, b):
+            if node not in drawn:  # merged away before the snapshot
+                drawn.add(node)
+                out.append('  "%s" [style=dashed, fillcolor=white];' % node)
+        out.append('  "%s" -- "%s" [label="%s", style=%s, penwidth=%.2f, fontsize=8];' % (a, b, text, style, pen))
+    out.append("}")
+    return "\n".join(out) + "\n"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("source", help="saved agent .json or telemetry region name")
+    parser.add_argument("-o", "--output", help="DOT file (default: stdout)")
+    parser.add_argument("--similarity", type=float, default=0.85,
+                        help="telemetry: link beliefs at least this similar")
+    parser.add_argument("--min-count", type=int, default=1, help="saved agent: minimum co-activation count")
+    args = parser.parse_args()
+
+    try:
+        if args.source.endswith(".json") or os.path.isfile(args.source):
+            beliefs, edges, label = from_saved_agent(args.source, args.min_count)
+        else:
+            beliefs, edges, label = from_telemetry(args.source, args.similarity)
+    except (OSError, RuntimeError, ValueError) as e:
+        print("export_graphviz: %s" % e, file=sys.stderr)
+        return 1
+
+    dot = to_dot(beliefs, edges, label)
+    if args.output:
+        with open(args.output, "w") as f:
+            f.write(dot)
+    else:
+        sys.stdout.write(dot)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,220 @@
+#!/usr/bin/env python3
+"""Live view of a running agent's belief graph.
+
+Attaches read-only to the shared-memory telemetry ring a dbea_main process
+publishes with ``--telemetry <name>`` (Config::telemetry_shm) and redraws the
+population, emotion and birth/death/merge/cold-tier events as snapshots arrive. The
+simulation is never paused; see include/dbea/Telemetry.h for the layout.
+
+    python tools/visualize_belief_graph.py /dbea_telemetry
+    python tools/visualize_belief_graph.py /dbea_telemetry --plot   # needs matplotlib
+"""
+import argparse
+import collections
+import mmap
+import os
+import struct
+import sys
+import time
+
+MAGIC = 0x4C544244  # "DBTL"
+VERSION = 1
+HEADER = struct.Struct("=8IQ")
+SLOT_HEADER = struct.Struct("=3Q4I6d")
+SLOT_HEADER_BYTES = 128
+EVENT = struct.Struct("=2I24s24s")
+EVENT_KINDS = {1: "birth", 2: "death", 3: "merge", 4: "demote", 5: "promote"}
+EMOTIONS = ("valence", "arousal", "dominance", "curiosity", "fear", "explore_bias")
+
+
+def shm_path(name):
+    """POSIX shm names map to files under /dev/shm on Linux."""
+    return os.path.join("/dev/shm", name.lstrip("/"))
+
+
+def _decode_id(raw):
+    return raw.split(b"\0", 1)[0].decode("utf-8", "replace")
+
+
+class TelemetryReader:
+    """Decodes snapshots from the ring; reattaches when a new run replaces it."""
+
+    def __init__(self, name):
+        self.path = shm_path(name)
+        self.buf = None
+        self.inode = None
+
+    def _attach(self):
+        try:
+            st = os.stat(self.path)
+        except FileNotFoundError:
+            self.close()
+            return False
+        if self.buf is not None and st.st_ino == self.inode:
+            return True
+        self.close()
+        if st.st_size < HEADER.size:
+            return False
+        with open(self.path, "rb") as f:
+            self.buf = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        self.inode = st.st_ino
+        (magic, version, self.slots, self.slot_bytes, self.max_beliefs,
+         self.max_features, self.max_events, _, _) = HEADER.unpack_from(self.buf, 0)
+        if magic != MAGIC:  # still being initialised by the publisher
+            self.close()
+            return False
+        if version != VERSION:
+            raise RuntimeError("unsupported telemetry version %d" % version)
+        self.belief = struct.Struct("=24s3diI%dd" % self.max_features)
+        return True
+
+    def close(self):
+        if self.buf is not None:
+            self.buf.close()
+        self.buf = None
+        self.inode = None
+
+    def published(self):
+        return struct.unpack_from("=Q", self.buf, 32)[0]
+
+    def latest(self, retries=100):
+        """Newest complete snapshot as a dict, or None if there is none yet."""
+        if not self._attach():
+            return None
+        for _ in range(retries):
+            published = self.published()
+            if published == 0:
+                return None
+            offset = 64 + ((published - 1) % self.slots) * self.slot_bytes
+            before = struct.unpack_from("=Q", self.buf, offset)[0]
+            if before & 1:
+                continue  # the publisher is writing this slot
+            data = self.buf[offset:offset + self.slot_bytes]
+            if struct.unpack_from("=Q", self.buf, offset)[0] == before:
+                return self._decode(data)
+        return None
+
+    def _decode(self, data):
+        (_, snapshot, step, n_beliefs, total, n_events, dropped, *emotion) = SLOT_HEADER.unpack_from(data, 0)
+        beliefs = []
+        for i in range(n_beliefs):
+            rec = self.belief.unpack_from(data, SLOT_HEADER_BYTES + i * self.belief.size)
+            raw_id, confidence, fitness, activation, evidence, width = rec[:6]
+            beliefs.append({
+                "id": _decode_id(raw_id),
+                "confidence": confidence,
+                "fitness": fitness,
+                "activation": activation,
+                "evidence": evidence,
+                "prototype": list(rec[6:6 + width]),
+            })
+        events = []
+        events_offset = SLOT_HEADER_BYTES + self.max_beliefs * self.belief.size
+        for i in range(n_events):
+            kind, _, raw_id, raw_other = EVENT.unpack_from(data, events_offset + i * EVENT.size)
+            events.append({"kind": EVENT_KINDS.get(kind, str(kind)),
+                           "id": _decode_id(raw_id), "other": _decode_id(raw_other)})
+        return {
+            "snapshot": snapshot,
+            "step": step,
+            "total_beliefs": total,
+            "emotion": dict(zip(EMOTIONS, emotion)),
+            "beliefs": beliefs,
+            "events": events,
+            "dropped_events": dropped,
+        }
+
+
+def format_event(ev):
+    if ev["kind"] == "merge":
+        return "merge  %s -> %s" % (ev["id"], ev["other"])
+    return "%-6s %s" % (ev["kind"], ev["id"])
+
+
+def render_text(snap, recent, missed, top):
+    lines = ["step %d | snapshot %d | beliefs %d (%d shown) | missed snapshots %d"
+             % (snap["step"], snap["snapshot"], snap["total_beliefs"], len(snap["beliefs"]), missed),
+             "  ".join("%s %+.3f" % (k, v) for k, v in snap["emotion"].items()),
+             "",
+             "%-24s %8s %8s %8s %6s  prototype" % ("id", "conf", "fitness", "act", "ev")]
+    ranked = sorted(snap["beliefs"], key=lambda b: b["fitness"], reverse=True)[:top]
+    for b in ranked:
+        proto = " ".join("%.2f" % f for f in b["prototype"][:4])
+        lines.append("%-24s %8.3f %8.3f %8.3f %6d  %s"
+                     % (b["id"], b["confidence"], b["fitness"], b["activation"], b["evidence"], proto))
+    lines += ["", "recent events:"] + ["  " + format_event(e) for e in recent]
+    sys.stdout.write("\x1b[H\x1b[2J" + "\n".join(lines) + "\n")
+    sys.stdout.flush()
+
+
+def make_plot():
+    import matplotlib.pyplot as plt
+    plt.ion()
+    fig, (ax_graph, ax_emotion) = plt.subplots(1, 2, figsize=(12, 5))
+    history = collections.deque(maxlen=500)
+
+    def draw(snap):
+        history.append((snap["step"], snap["emotion"]))
+        ax_graph.clear()
+        pts = [b for b in snap["beliefs"] if len(b["prototype"]) >= 2]
+        if pts:
+            sc = ax_graph.scatter([b["prototype"][0] for b in pts], [b["prototype"][1] for b in pts],
+                                  s=[20 + 200 * b["confidence"] for b in pts],
+                                  c=[b["fitness"] for b in pts], cmap="viridis")
+            if not hasattr(draw, "colorbar"):
+                draw.colorbar = fig.colorbar(sc, ax=ax_graph, label="fitness")
+        ax_graph.set_title("beliefs at step %d (%d)" % (snap["step"], snap["total_beliefs"]))
+        ax_graph.set_xlabel("prototype[0]")
+        ax_graph.set_ylabel("prototype[1]")
+        ax_emotion.clear()
+        steps = [s for s, _ in history]
+        for name in EMOTIONS:
+            ax_emotion.plot(steps, [e[name] for _, e in history], label=name)
+        ax_emotion.legend(loc="upper left", fontsize="small")
+        ax_emotion.set_xlabel("step")
+        fig.canvas.draw_idle()
+        plt.pause(0.001)
+
+    return draw
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("name", help="telemetry region name, e.g. /dbea_telemetry")
+    parser.add_argument("--interval", type=float, default=0.5, help="seconds between polls")
+    parser.add_argument("--top", type=int, default=20, help="beliefs listed, by fitness")
+    parser.add_argument("--plot", action="store_true", help="matplotlib view instead of text")
+    parser.add_argument("--once", action="store_true", help="print the latest snapshot and exit")
+    args = parser.parse_args()
+
+    reader = TelemetryReader(args.name)
+    draw = make_plot() if args.plot else None
+    recent = collections.deque(maxlen=15)
+    last = None
+    missed = 0
+    try:
+        while True:
+            snap = reader.latest()
+            if snap is not None and (last is None or snap["snapshot"] != last):
+                if last is not None and snap["snapshot"] > last + 1:
+                    missed += snap["snapshot"] - last - 1  # their events are lost too
+                last = snap["snapshot"]
+                recent.extend(snap["events"])
+                if draw:
+                    draw(snap)
+                else:
+                    render_text(snap, recent, missed, args.top)
+                if args.once:
+                    return 0
+            elif snap is None and args.once:
+                print("no snapshot published in %s" % reader.path, file=sys.stderr)
+                return 1
+            time.sleep(args.interval)
+    except KeyboardInterrupt:
+        return 0
+    finally:
+        reader.close()
+
+
+if __name__ == "__main__":
+    sys.exit(main())